@@ -29,7 +29,11 @@ inline std::unique_ptr<Fits::Compression> get_compression(fitsfile* fptr);
 inline std::unique_ptr<Fits::Compression> read_parameters(fitsfile* fptr);
 
 /**
- * @brief Read the current compression tiling.
+ * @brief Read the tiling of the current HDU.
+ * @return The tile shape, or an empty position if the HDU is not compressed
+ * @details
+ * Missing `ZTILEn` keywords are given their standard default values,
+ * i.e. `ZNAXIS1` for the first axis and 1 for the others.
  */
 inline Linx::Position<-1> read_tiling(fitsfile* fptr);
 
@@ -68,7 +72,104 @@ inline void compress(fitsfile* fptr, const Fits::HCompress& algo);
  */
 inline void compress(fitsfile* fptr, const Fits::Plio& algo);
 
+/**
+ * @brief Copy the compression parameters of a file to another file.
+ * @details
+ * All of the parameters which are requested to CFITSIO are copied, including the dithering seed.
+ * They are read with the CFITSIO getters where they exist.
+ * The dithering method and seed, lossy integer compression and huge HDU flags have no getter,
+ * and are read from the `FITSfile` structure.
+ */
+inline void copy_parameters(fitsfile* from, fitsfile* to);
+
+/**
+ * @brief Write a whole raster in the current compressed image HDU, compressing tiles in parallel.
+ * @param raster The contiguous raster to be written, whose shape is that of the HDU
+ * @param thread_count The number of threads, or 0 for the number of hardware threads
+ * @details
+ * CFITSIO compresses the tiles sequentially.
+ * Here, the raster is split into tile-aligned slabs along the last axis,
+ * which are compressed concurrently in in-memory files with the same parameters as the HDU,
+ * and whose tile tables are then appended to the HDU in order.
+ * Dithering seeds are offset such that the tiles are exactly those that CFITSIO would have written,
+ * such that the output is bit-identical to that of a sequential write.
+ *
+ * This is meant for freshly created HDUs.
+ * If the HDU is not compressed, if a single thread is available or if CFITSIO is not reentrant,
+ * the raster is simply written with `ImageIo::write_raster()`.
+ *
+ * The compressed tiles are kept in memory until all of them are written.
+ */
+template <typename TRaster>
+void write_parallel(fitsfile* fptr, const TRaster& raster, Linx::Index thread_count = 0);
+
+/**
+ * @brief Read the current compressed image HDU into a raster, decompressing tiles in parallel.
+ * @param raster The contiguous destination raster, whose shape is that of the HDU
+ * @param thread_count The number of threads, or 0 for the number of hardware threads
+ * @details
+ * CFITSIO decompresses the tiles sequentially.
+ * Here, the tile table is split into tile-aligned slabs along the last axis.
+ * The compressed tiles of each slab are copied sequentially into an in-memory file,
+ * which is then decompressed by a worker thread directly into the raster.
+ *
+ * If the HDU is not compressed, if a single thread is available or if CFITSIO is not reentrant,
+ * the raster is simply read with `ImageIo::read_raster_to()`.
+ */
+template <typename TRaster>
+void read_parallel_to(fitsfile* fptr, TRaster& raster, Linx::Index thread_count = 0);
+
+/**
+ * @brief Compress a raster in a new in-memory file and get the size of the compressed data unit.
+ * @param algo The compression algorithm
+ * @param shape The raster shape
+ * @param data The raster values
+ * @return The size of the tile table and its heap, in bytes
+ * @details
+ * Nothing is written to the disk, which makes this function suitable for benchmarking algorithms
+ * on samples of some data before creating the compressed HDU.
+ */
+template <typename TAlgo, typename T>
+std::size_t compressed_size(const TAlgo& algo, const Linx::Position<-1>& shape, const T* data);
+
 } // namespace ImageCompression
+
+/**
+ * @brief Binary table compression, according to the FITS tiled table compression convention.
+ * @details
+ * Rows are grouped into tiles, and each column of each tile is compressed independently.
+ * The algorithm of each column and the number of rows per tile are selected by CFITSIO.
+ * Unlike compressed images, compressed tables are not decompressed on the fly by CFITSIO.
+ */
+namespace TableCompression {
+
+/**
+ * @brief Know whether the current HDU is a compressed binary table.
+ */
+inline bool is_compressed(fitsfile* fptr);
+
+/**
+ * @brief Get the number of rows of the current compressed binary table once decompressed.
+ */
+inline Linx::Index row_count(fitsfile* fptr);
+
+/**
+ * @brief Compress the current binary table of a file and append it to another file.
+ */
+inline void compress(fitsfile* from, fitsfile* to);
+
+/**
+ * @brief Decompress the current compressed binary table of a file and append it to another file.
+ */
+inline void decompress(fitsfile* from, fitsfile* to);
+
+/**
+ * @brief Decompress the current compressed binary table of a file into a new in-memory file.
+ * @return The in-memory file, whose current HDU is the decompressed table, and which is closed by the deleter
+ */
+inline std::shared_ptr<fitsfile> decompress_to_memory(fitsfile* fptr);
+
+} // namespace TableCompression
 } // namespace Cfitsio
 
 /// @cond INTERNAL
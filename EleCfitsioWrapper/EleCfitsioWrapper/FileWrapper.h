@@ -62,6 +62,13 @@ std::string name(fitsfile* fptr);
  */
 bool is_writable(fitsfile* fptr);
 
+/**
+ * @brief Check whether CFITSIO was built thread-safe.
+ * @details
+ * If not, a file must not be accessed concurrently, even through different `fitsfile*`.
+ */
+bool is_reentrant();
+
 } // namespace FileAccess
 } // namespace Cfitsio
 
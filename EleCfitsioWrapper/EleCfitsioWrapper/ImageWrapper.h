@@ -74,6 +74,17 @@ Linx::Raster<T, M> read_region(fitsfile* fptr, const Linx::Box<N>& region);
 template <Linx::Index N, typename TOut>
 void read_region_to(fitsfile* fptr, const Linx::Box<N>& region, TOut& out);
 
+/**
+ * @brief Read a region of the current image HDU into a contiguous buffer with a single CFITSIO call.
+ * @param region The source region
+ * @param data The destination buffer, of size at least `region.size()`
+ * @details
+ * As opposed to `read_region_to()`, which reads line-by-line,
+ * compressed images are decompressed tile-by-tile, each intersecting tile being decompressed only once.
+ */
+template <typename T, Linx::Index N>
+void read_subset_to(fitsfile* fptr, const Linx::Box<N>& region, T* data);
+
 /**
  * @brief Write a whole raster in the current image HDU.
  */
@@ -86,6 +97,17 @@ void write_raster(fitsfile* fptr, const TRaster& raster);
 template <Linx::Index N, typename TIn>
 void write_region(fitsfile* fptr, const Linx::Box<N>& region, TIn& in);
 
+/**
+ * @brief Write a contiguous buffer into a region of the current image HDU with a single CFITSIO call.
+ * @param region The destination region
+ * @param data The source buffer, of size at least `region.size()`, which is not modified
+ * @details
+ * For compressed images, the region should be aligned with the tiling, such that each tile is compressed once:
+ * partially written tiles have to be decompressed and recompressed by CFITSIO when completed.
+ */
+template <typename T, Linx::Index N>
+void write_subset(fitsfile* fptr, const Linx::Box<N>& region, T* data);
+
 } // namespace ImageIo
 } // namespace Cfitsio
 
@@ -0,0 +1,173 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELECFITSIOWRAPPER_PROFILINGWRAPPER_H
+#define _ELECFITSIOWRAPPER_PROFILINGWRAPPER_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <array>
+#include <chrono>
+#include <fitsio.h>
+#include <string>
+
+namespace Cfitsio {
+
+/**
+ * @brief I/O counters of the wrapper functions.
+ *
+ * @details
+ * Once profiling is enabled for a file, the wrapper functions count their CFITSIO calls,
+ * the number of bytes read or written, and the time spent, per HDU and per call class.
+ * Calls are attributed to the current HDU at the end of the wrapper function,
+ * such that HDU moves are attributed to the destination HDU.
+ *
+ * When no file is profiled, the overhead is a single relaxed atomic load per wrapper function call.
+ * Counters are discarded when the file is closed with `FileAccess::close()`.
+ */
+namespace Profiling {
+
+/**
+ * @brief The classes of CFITSIO calls.
+ */
+enum class CallClass {
+  HduMove = 0, ///< Move to another HDU
+  HeaderRead, ///< Read header records
+  HeaderWrite, ///< Write or update header records
+  DataRead, ///< Read image pixels or column values
+  DataWrite ///< Write image pixels or column values
+};
+
+/**
+ * @brief The number of call classes.
+ */
+constexpr std::size_t call_class_count = 5;
+
+/**
+ * @brief Get the name of a call class, e.g. "DataRead".
+ */
+std::string call_class_name(CallClass call_class);
+
+/**
+ * @brief The counter of a call class.
+ */
+struct Counter {
+
+  /**
+   * @brief Add another counter.
+   */
+  Counter& operator+=(const Counter& rhs);
+
+  Linx::Index calls = 0; ///< The number of CFITSIO calls
+  Linx::Index bytes = 0; ///< The number of bytes, as seen by the user
+  double seconds = 0.; ///< The time spent
+};
+
+/**
+ * @brief The counters of all call classes, indexed by `CallClass`.
+ */
+struct Counters {
+
+  /**
+   * @brief Access the counter of a call class.
+   */
+  Counter& operator[](CallClass call_class);
+
+  /**
+   * @copydoc operator[]()
+   */
+  const Counter& operator[](CallClass call_class) const;
+
+  /**
+   * @brief Add other counters.
+   */
+  Counters& operator+=(const Counters& rhs);
+
+  /**
+   * @brief The counters.
+   */
+  std::array<Counter, call_class_count> counters;
+};
+
+/**
+ * @brief Enable profiling of a file.
+ */
+void enable(fitsfile* fptr);
+
+/**
+ * @brief Disable profiling of a file and discard its counters.
+ */
+void disable(fitsfile* fptr);
+
+/**
+ * @brief Check whether profiling of a file is enabled.
+ */
+bool is_enabled(fitsfile* fptr);
+
+/**
+ * @brief Get the counters of an HDU and reset them.
+ * @param fptr The file
+ * @param index The 1-based HDU index
+ */
+Counters take(fitsfile* fptr, Linx::Index index);
+
+/**
+ * @brief Measure the CFITSIO calls of a scope, e.g. a wrapper function.
+ * @details
+ * The timer starts at construction and stops at destruction.
+ * Each CFITSIO call should be declared with `count()`.
+ * If profiling is disabled for the file, nothing is done.
+ */
+class Scope {
+public:
+
+  /**
+   * @brief Start measuring.
+   */
+  Scope(fitsfile* fptr, CallClass call_class);
+
+  LINX_NON_COPYABLE(Scope)
+  LINX_NON_MOVABLE(Scope)
+
+  /**
+   * @brief Stop measuring and record the counts.
+   */
+  ~Scope();
+
+  /**
+   * @brief Count a CFITSIO call.
+   */
+  void count(Linx::Index bytes = 0)
+  {
+    ++m_counter.calls;
+    m_counter.bytes += bytes;
+  }
+
+private:
+
+  /**
+   * @brief The file, or `nullptr` if profiling is disabled.
+   */
+  fitsfile* m_fptr;
+
+  /**
+   * @brief The call class.
+   */
+  CallClass m_class;
+
+  /**
+   * @brief The start time.
+   */
+  std::chrono::steady_clock::time_point m_start;
+
+  /**
+   * @brief The counter.
+   */
+  Counter m_counter;
+};
+
+} // namespace Profiling
+} // namespace Cfitsio
+
+#endif
@@ -7,6 +7,7 @@
 #include "EleCfitsioWrapper/BintableWrapper.h"
 #include "EleCfitsioWrapper/ErrorWrapper.h"
 #include "EleCfitsioWrapper/HeaderWrapper.h" // has_heyword
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
 #include "EleCfitsioWrapper/TypeWrapper.h"
 #include "EleFitsData/FitsError.h"
 #include "EleFitsUtils/StringUtils.h"
@@ -334,8 +335,10 @@ void append_columns(fitsfile* fptr, const TColumns&... columns)
 template <typename T>
 void read_column_data(fitsfile* fptr, const Fits::Segment& rows, Linx::Index index, Linx::Index repeat_count, T* data)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataRead);
   int status = 0;
   const auto size = rows.size() * repeat_count;
+  scope.count(size * sizeof(T));
   fits_read_col(
       fptr,
       TypeCode<T>::for_bintable(), // datatype
@@ -358,8 +361,10 @@ void write_column_data(
     Linx::Index repeat_count,
     const T* data)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataWrite);
   int status = 0;
   const auto size = rows.size() * repeat_count;
+  scope.count(size * sizeof(T));
   std::vector<T> nonconst_data(data, data + size); // We need a non-const data for CFITSIO
   fits_write_col(
       fptr,
@@ -6,9 +6,19 @@
 
 #include "EleCfitsioWrapper/CompressionWrapper.h"
 #include "EleCfitsioWrapper/ErrorWrapper.h"
+#include "EleCfitsioWrapper/FileWrapper.h"
+#include "EleCfitsioWrapper/HduWrapper.h"
 #include "EleCfitsioWrapper/HeaderWrapper.h"
+#include "EleCfitsioWrapper/ImageWrapper.h"
+#include "EleFitsUtils/Parallel.h"
 #include "EleFitsUtils/StringUtils.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib> // abs
+#include <mutex>
+#include <vector>
+
 namespace Cfitsio {
 namespace ImageCompression {
 
@@ -172,6 +182,448 @@ std::unique_ptr<Fits::Compression> read_parameters(fitsfile* fptr)
   throw Fits::FitsError("Unknown compression type");
 }
 
+Linx::Position<-1> read_tiling(fitsfile* fptr)
+{
+  if (not HeaderIo::has_keyword(fptr, "ZNAXIS")) {
+    return Linx::Position<-1>(0);
+  }
+  const auto dimension = HeaderIo::parse_record<Linx::Index>(fptr, "ZNAXIS");
+  Linx::Position<-1> shape(dimension);
+  for (Linx::Index i = 0; i < dimension; ++i) {
+    const auto key = std::string("ZTILE") + std::to_string(i + 1);
+    if (HeaderIo::has_keyword(fptr, key)) {
+      shape[i] = HeaderIo::parse_record<Linx::Index>(fptr, key);
+    } else if (i == 0) {
+      shape[i] = HeaderIo::parse_record<Linx::Index>(fptr, "ZNAXIS1");
+    } else {
+      shape[i] = 1;
+    }
+  }
+  return shape;
+}
+
+void copy_parameters(fitsfile* from, fitsfile* to)
+{
+  int status = 0;
+
+  // Parameters with getters
+  int type = int(NULL);
+  fits_get_compression_type(from, &type, &status);
+  std::vector<long> tiling(MAX_COMPRESS_DIM, 1);
+  fits_get_tile_dim(from, MAX_COMPRESS_DIM, tiling.data(), &status);
+  float level = 0;
+  fits_get_quantize_level(from, &level, &status);
+  float scale = 0;
+  fits_get_hcomp_scale(from, &scale, &status);
+  int smooth = 0;
+  fits_get_hcomp_smooth(from, &smooth, &status);
+  CfitsioError::may_throw(status, from, "Cannot read compression parameters");
+
+  fits_set_compression_type(to, type, &status);
+  fits_set_tile_dim(to, MAX_COMPRESS_DIM, tiling.data(), &status);
+  fits_set_quantize_level(to, level, &status);
+  fits_set_hcomp_scale(to, scale, &status);
+  fits_set_hcomp_smooth(to, smooth, &status);
+
+  // Parameters without getters
+  const auto* params = from->Fptr;
+  fits_set_quantize_dither(to, params->request_quantize_method, &status);
+  fits_set_dither_seed(to, params->request_dither_seed, &status);
+  fits_set_lossy_int(to, params->request_lossy_int_compress, &status);
+  fits_set_huge_hdu(to, params->request_huge_hdu, &status);
+  CfitsioError::may_throw(status, to, "Cannot copy compression parameters");
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A file which is closed by the destructor.
+ */
+using FilePtr = std::unique_ptr<fitsfile, void (*)(fitsfile*)>;
+
+/**
+ * @brief Close a file, ignoring errors.
+ */
+inline void close_quietly(fitsfile* fptr)
+{
+  int status = 0;
+  fits_close_file(fptr, &status);
+}
+
+/**
+ * @brief Get the dithering seed of the next compressed HDU.
+ * @details
+ * Seeds computed by CFITSIO from the clock or from the checksum of the first tile
+ * cannot be reproduced from one slab to the other, and are replaced with a clock-based seed.
+ */
+inline int dither_seed(fitsfile* fptr)
+{
+  const auto seed = fptr->Fptr->request_dither_seed;
+  if (seed > 0) {
+    return seed;
+  }
+  const auto ticks = std::chrono::system_clock::now().time_since_epoch().count();
+  return static_cast<int>(ticks % 10000) + 1;
+}
+
+/**
+ * @brief The split of an image into tile-aligned slabs along the last axis.
+ */
+struct SlabPlan {
+
+  /**
+   * @brief Plan about 4 slabs per thread.
+   */
+  SlabPlan(const Linx::Position<-1>& image_shape, const Linx::Position<-1>& tile_shape, long threads) :
+      shape(image_shape), tiling(tile_shape), last(image_shape.size() - 1), plane_size(1), tiles_per_layer(1),
+      layers_per_slab(1), thickness(1), count(0)
+  {
+    for (std::size_t i = 0; i <= last; ++i) {
+      tiling[i] = std::min(tiling[i], shape[i]);
+      if (i < last) {
+        tiles_per_layer *= (shape[i] + tiling[i] - 1) / tiling[i];
+        plane_size *= shape[i];
+      }
+    }
+    const auto layer_count = (shape[last] + tiling[last] - 1) / tiling[last];
+    layers_per_slab = std::max<Linx::Index>(layer_count / (threads * 4), 1);
+    thickness = layers_per_slab * tiling[last];
+    count = (shape[last] + thickness - 1) / thickness;
+  }
+
+  /**
+   * @brief Get the shape of the i-th slab.
+   */
+  Linx::Position<-1> slab_shape(Linx::Index i) const
+  {
+    auto out = shape;
+    out[last] = std::min(thickness, shape[last] - i * thickness);
+    return out;
+  }
+
+  /**
+   * @brief Get the 0-based index of the first tile of the i-th slab.
+   */
+  Linx::Index first_tile(Linx::Index i) const
+  {
+    return i * layers_per_slab * tiles_per_layer;
+  }
+
+  /**
+   * @brief Get the number of tiles of the i-th slab.
+   */
+  Linx::Index tile_count(Linx::Index i) const
+  {
+    const auto s = slab_shape(i)[last];
+    return (s + tiling[last] - 1) / tiling[last] * tiles_per_layer;
+  }
+
+  /**
+   * @brief Get the index of the first pixel of the i-th slab.
+   */
+  Linx::Index offset(Linx::Index i) const
+  {
+    return i * thickness * plane_size;
+  }
+
+  /**
+   * @brief Get the dithering seed of the first tile of the i-th slab.
+   */
+  int seed(int image_seed, Linx::Index i) const
+  {
+    return static_cast<int>((image_seed - 1 + first_tile(i)) % 10000) + 1;
+  }
+
+  Linx::Position<-1> shape; ///< The image shape
+  Linx::Position<-1> tiling; ///< The tile shape, bounded by the image shape
+  std::size_t last; ///< The index of the last axis
+  Linx::Index plane_size; ///< The number of pixels in a hyperplane orthogonal to the last axis
+  Linx::Index tiles_per_layer; ///< The number of tiles in a one-tile-thick layer
+  Linx::Index layers_per_slab; ///< The number of layers of tiles per slab
+  Linx::Index thickness; ///< The number of pixels of a full slab along the last axis
+  Linx::Index count; ///< The number of slabs
+};
+
+/**
+ * @brief Create an in-memory file with an empty Primary.
+ */
+inline FilePtr create_memory_file(fitsfile* fptr)
+{
+  int status = 0;
+  fitsfile* slab = nullptr;
+  fits_create_file(&slab, "mem://", &status);
+  CfitsioError::may_throw(status, fptr, "Cannot create in-memory slab");
+  FilePtr out(slab, close_quietly);
+  HduAccess::init_primary(slab); // Compressed images cannot be Primary
+  return out;
+}
+
+/**
+ * @brief Compress a slab in a new in-memory file.
+ * @param fptr The file which holds the compression parameters
+ * @param tiling The tile shape
+ * @param seed The dithering seed of the first tile of the slab
+ */
+template <typename T>
+FilePtr compress_slab(
+    fitsfile* fptr,
+    const Linx::Position<-1>& tiling,
+    const Linx::Position<-1>& shape,
+    const T* data,
+    int seed)
+{
+  auto out = create_memory_file(fptr);
+  auto* slab = out.get();
+  int status = 0;
+  copy_parameters(fptr, slab);
+  auto nonconst_tiling = tiling; // const-correctness issue
+  fits_set_tile_dim(slab, nonconst_tiling.size(), nonconst_tiling.data(), &status);
+  fits_set_dither_seed(slab, seed, &status);
+  CfitsioError::may_throw(status, slab, "Cannot set slab compression parameters");
+  HduAccess::init_image<T>(slab, "", shape);
+  ImageIo::write_raster(slab, Linx::PtrRaster<const T, -1>(shape, data));
+  auto expected = tiling;
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = std::min(expected[i], shape[i]);
+  }
+  if (not(read_tiling(slab) == expected)) {
+    throw Fits::FitsError("Cannot compress slab: tiling was modified by CFITSIO");
+  }
+  return out;
+}
+
+/**
+ * @brief Get the CFITSIO datatype and size in bytes of the elements of a column, given its typecode.
+ */
+inline std::pair<int, std::size_t> column_element_type(int typecode)
+{
+  switch (std::abs(typecode)) {
+    case TBYTE:
+      return {TBYTE, 1};
+    case TSHORT:
+      return {TSHORT, 2};
+    case TLONG: // 32-bit in file, read as int
+      return {TINT, sizeof(int)};
+    case TFLOAT:
+      return {TFLOAT, 4};
+    case TLONGLONG:
+      return {TLONGLONG, 8};
+    case TDOUBLE:
+      return {TDOUBLE, 8};
+    default:
+      throw Fits::FitsError("Unsupported tile table column type: " + std::to_string(typecode));
+  }
+}
+
+/**
+ * @brief Copy rows of a tile table into another tile table.
+ * @param src_row The 1-based index of the first source row
+ * @param dst_row The 1-based index of the first destination row
+ * @param row_count The number of rows
+ * @details
+ * Columns are matched by name.
+ * Missing columns, like `GZIP_COMPRESSED_DATA` which CFITSIO creates on demand, are appended.
+ */
+inline void
+copy_tile_rows(fitsfile* src, fitsfile* dst, Linx::Index src_row, Linx::Index dst_row, Linx::Index row_count)
+{
+  int status = 0;
+  int column_count = 0;
+  fits_get_num_cols(src, &column_count, &status);
+  CfitsioError::may_throw(status, src, "Cannot read tile table size");
+
+  struct ColumnMapping {
+    int typecode;
+    LONGLONG repeat;
+    int index;
+  };
+  std::vector<ColumnMapping> columns(column_count);
+  for (int i = 1; i <= column_count; ++i) {
+    auto& c = columns[i - 1];
+    LONGLONG width = 0;
+    fits_get_coltypell(src, i, &c.typecode, &c.repeat, &width, &status);
+    CfitsioError::may_throw(status, src, "Cannot read tile table column type");
+    auto name = HeaderIo::parse_record<std::string>(src, "TTYPE" + std::to_string(i)).value;
+    fits_get_colnum(dst, CASEINSEN, &name[0], &c.index, &status);
+    if (status == COL_NOT_FOUND) {
+      status = 0;
+      auto tform = HeaderIo::parse_record<std::string>(src, "TFORM" + std::to_string(i)).value;
+      int dst_count = 0;
+      fits_get_num_cols(dst, &dst_count, &status);
+      c.index = dst_count + 1;
+      fits_insert_col(dst, c.index, &name[0], &tform[0], &status);
+    }
+    CfitsioError::may_throw(status, dst, "Cannot map tile table column: " + name);
+  }
+
+  std::vector<unsigned char> buffer;
+  for (Linx::Index row = 0; row < row_count; ++row) { // Row-wise like CFITSIO, for the heap to be ordered alike
+    for (int i = 1; i <= column_count; ++i) {
+      const auto& c = columns[i - 1];
+      const auto type = column_element_type(c.typecode);
+      LONGLONG count = c.repeat;
+      if (c.typecode < 0) {
+        LONGLONG offset = 0;
+        fits_read_descriptll(src, i, src_row + row, &count, &offset, &status);
+      }
+      if (count == 0) {
+        continue;
+      }
+      buffer.resize(count * type.second);
+      fits_read_col(src, type.first, i, src_row + row, 1, count, nullptr, buffer.data(), nullptr, &status);
+      fits_write_col(dst, type.first, c.index, dst_row + row, 1, count, buffer.data(), &status);
+      CfitsioError::may_throw(status, dst, "Cannot copy compressed tile");
+    }
+  }
+}
+
+/**
+ * @brief Copy the quantization keywords which CFITSIO writes when compressing the first tile.
+ */
+inline void copy_quantization_records(fitsfile* slab, fitsfile* fptr)
+{
+  for (const auto& k : {"ZQUANTIZ", "ZDITHER0", "ZBLANK"}) {
+    if (not HeaderIo::has_keyword(slab, k)) {
+      continue;
+    }
+    int status = 0;
+    char card[FLEN_CARD];
+    auto keyword = std::string(k);
+    fits_read_card(slab, &keyword[0], card, &status);
+    fits_update_card(fptr, &keyword[0], card, &status);
+    CfitsioError::may_throw(status, fptr, "Cannot copy quantization record: " + keyword);
+  }
+}
+
+/**
+ * @brief Copy the compressed tiles of a slab into a new in-memory file.
+ * @details
+ * The header is copied and updated such that the slab is a valid compressed image on its own.
+ */
+inline FilePtr extract_slab(fitsfile* fptr, const SlabPlan& plan, Linx::Index i)
+{
+  auto out = create_memory_file(fptr);
+  auto* slab = out.get();
+  int status = 0;
+  fits_copy_header(fptr, slab, &status);
+  CfitsioError::may_throw(status, slab, "Cannot copy slab header");
+  LONGLONG rows = plan.tile_count(i);
+  LONGLONG heap = 0;
+  LONGLONG thickness = plan.slab_shape(i)[plan.last];
+  const auto znaxis = "ZNAXIS" + std::to_string(plan.last + 1);
+  fits_update_key(slab, TLONGLONG, "NAXIS2", &rows, nullptr, &status);
+  fits_update_key(slab, TLONGLONG, "PCOUNT", &heap, nullptr, &status);
+  fits_update_key(slab, TLONGLONG, znaxis.c_str(), &thickness, nullptr, &status);
+  if (HeaderIo::has_keyword(slab, "ZDITHER0")) {
+    int seed = plan.seed(HeaderIo::parse_record<int>(slab, "ZDITHER0"), i);
+    fits_update_key(slab, TINT, "ZDITHER0", &seed, nullptr, &status);
+  }
+  for (const auto& k : {"THEAP", "CHECKSUM", "DATASUM", "ZHECKSUM", "ZDATASUM"}) {
+    if (HeaderIo::has_keyword(slab, k)) {
+      fits_delete_key(slab, k, &status);
+    }
+  }
+  fits_set_hdustruc(slab, &status);
+  CfitsioError::may_throw(status, slab, "Cannot update slab header");
+  copy_tile_rows(fptr, slab, plan.first_tile(i) + 1, 1, rows);
+  fits_movabs_hdu(slab, 1, nullptr, &status); // Re-read the header as that of a compressed image
+  fits_movabs_hdu(slab, 2, nullptr, &status);
+  CfitsioError::may_throw(status, slab, "Cannot reload slab");
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+template <typename TRaster>
+void write_parallel(fitsfile* fptr, const TRaster& raster, Linx::Index thread_count)
+{
+  const auto shape = ImageIo::read_shape<-1>(fptr);
+  const auto threads = FileAccess::is_reentrant() ? Fits::Parallel::thread_count(thread_count) : 1;
+  if (shape_size(shape) == 0 || threads == 1 || not ImageIo::is_compressed(fptr)) {
+    ImageIo::write_raster(fptr, raster);
+    return;
+  }
+  may_throw_readonly(fptr);
+  const Internal::SlabPlan plan(shape, read_tiling(fptr), threads);
+  const auto seed = Internal::dither_seed(fptr);
+
+  /* Compress */
+
+  std::vector<Internal::FilePtr> slabs;
+  slabs.reserve(plan.count);
+  for (Linx::Index i = 0; i < plan.count; ++i) {
+    slabs.emplace_back(nullptr, Internal::close_quietly);
+  }
+  Fits::Parallel::for_each_index(
+      plan.count,
+      [&](long i, long) {
+        slabs[i] = Internal::compress_slab(
+            fptr,
+            plan.tiling,
+            plan.slab_shape(i),
+            raster.data() + plan.offset(i),
+            plan.seed(seed, i));
+      },
+      threads);
+
+  /* Stitch */
+
+  for (Linx::Index i = 0; i < plan.count; ++i) {
+    Internal::copy_tile_rows(slabs[i].get(), fptr, 1, plan.first_tile(i) + 1, plan.tile_count(i));
+    if (i == 0) {
+      Internal::copy_quantization_records(slabs[i].get(), fptr);
+    }
+    slabs[i].reset();
+  }
+}
+
+template <typename TRaster>
+void read_parallel_to(fitsfile* fptr, TRaster& raster, Linx::Index thread_count)
+{
+  const auto shape = ImageIo::read_shape<-1>(fptr);
+  const auto threads = FileAccess::is_reentrant() ? Fits::Parallel::thread_count(thread_count) : 1;
+  if (shape_size(shape) == 0 || threads == 1 || not ImageIo::is_compressed(fptr)) {
+    ImageIo::read_raster_to(fptr, raster);
+    return;
+  }
+  const Internal::SlabPlan plan(shape, read_tiling(fptr), threads);
+  std::mutex mutex;
+  Fits::Parallel::for_each_index(
+      plan.count,
+      [&](long i, long) {
+        Internal::FilePtr slab(nullptr, Internal::close_quietly);
+        {
+          std::lock_guard<std::mutex> lock(mutex); // The source file is read sequentially
+          slab = Internal::extract_slab(fptr, plan, i);
+        }
+        const auto slab_shape = plan.slab_shape(i);
+        ImageIo::read_subset_to(
+            slab.get(),
+            Linx::Box<-1>::from_shape(Linx::Position<-1>::zero(slab_shape.size()), slab_shape),
+            raster.data() + plan.offset(i));
+      },
+      threads);
+}
+
+template <typename TAlgo, typename T>
+std::size_t compressed_size(const TAlgo& algo, const Linx::Position<-1>& shape, const T* data)
+{
+  auto file = Internal::create_memory_file(nullptr);
+  auto* fptr = file.get();
+  compress(fptr, algo);
+  HduAccess::init_image<T>(fptr, "", shape);
+  ImageIo::write_raster(fptr, Linx::PtrRaster<const T, -1>(shape, data));
+  int status = 0;
+  fits_flush_file(fptr, &status); // Close the HDU to update PCOUNT
+  CfitsioError::may_throw(status, fptr, "Cannot flush compressed sample");
+  const auto row_width = HeaderIo::parse_record<long>(fptr, "NAXIS1").value;
+  const auto row_count = HeaderIo::parse_record<long>(fptr, "NAXIS2").value;
+  const auto heap_size = HeaderIo::parse_record<long>(fptr, "PCOUNT").value;
+  return static_cast<std::size_t>(row_width * row_count + heap_size); // Without block padding
+}
+
 void enable_huge_compression(fitsfile* fptr, bool huge)
 {
   int status = 0;
@@ -294,6 +746,46 @@ void compress(fitsfile* fptr, const Fits::Plio& algo)
 }
 
 } // namespace ImageCompression
+
+namespace TableCompression {
+
+bool is_compressed(fitsfile* fptr)
+{
+  if (not HeaderIo::has_keyword(fptr, "ZTABLE")) {
+    return false;
+  }
+  return HeaderIo::parse_record<bool>(fptr, "ZTABLE").value;
+}
+
+Linx::Index row_count(fitsfile* fptr)
+{
+  return HeaderIo::parse_record<Linx::Index>(fptr, "ZNAXIS2").value;
+}
+
+void compress(fitsfile* from, fitsfile* to)
+{
+  may_throw_readonly(to);
+  int status = 0;
+  fits_compress_table(from, to, &status);
+  CfitsioError::may_throw(status, to, "Cannot compress binary table");
+}
+
+void decompress(fitsfile* from, fitsfile* to)
+{
+  may_throw_readonly(to);
+  int status = 0;
+  fits_uncompress_table(from, to, &status);
+  CfitsioError::may_throw(status, to, "Cannot decompress binary table");
+}
+
+std::shared_ptr<fitsfile> decompress_to_memory(fitsfile* fptr)
+{
+  auto file = ImageCompression::Internal::create_memory_file(fptr);
+  decompress(fptr, file.get()); // Appended as the current HDU
+  return std::shared_ptr<fitsfile>(file.release(), ImageCompression::Internal::close_quietly);
+}
+
+} // namespace TableCompression
 } // namespace Cfitsio
 
 #endif
@@ -6,6 +6,7 @@
 
 #include "EleCfitsioWrapper/ErrorWrapper.h"
 #include "EleCfitsioWrapper/HeaderWrapper.h"
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
 #include "EleCfitsioWrapper/TypeWrapper.h"
 
 #include <utility> // index_sequence, make_index_sequence
@@ -117,6 +118,8 @@ void update_records_impl(fitsfile* fptr, const std::tuple<Fits::Record<Ts>...>&
 template <typename T>
 Fits::Record<T> parse_record(fitsfile* fptr, const std::string& keyword)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderRead);
+  scope.count(FLEN_CARD - 1);
   int status = 0;
   /* Read value and comment */
   T value;
@@ -166,6 +169,8 @@ Fits::RecordVec<T> parse_record_vec(fitsfile* fptr, const std::vector<std::strin
 template <typename T>
 void write_record(fitsfile* fptr, const Fits::Record<T>& record)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderWrite);
+  scope.count(FLEN_CARD - 1);
   int status = 0;
   T nonconst_value = record.value;
   fits_write_key(
@@ -202,6 +207,8 @@ void write_records(fitsfile* fptr, const std::vector<Fits::Record<T>>& records)
 template <typename T>
 void update_record(fitsfile* fptr, const Fits::Record<T>& record)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderWrite);
+  scope.count(FLEN_CARD - 1);
   int status = 0;
   std::string comment = record.raw_comment();
   T value = record.value;
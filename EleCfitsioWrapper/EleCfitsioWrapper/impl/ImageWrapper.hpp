@@ -6,10 +6,13 @@
 
 #include "EleCfitsioWrapper/ErrorWrapper.h"
 #include "EleCfitsioWrapper/ImageWrapper.h"
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
 #include "EleCfitsioWrapper/TypeWrapper.h"
 #include "Linx/Data/Tiling.h" // rows
 
+#include <algorithm> // copy_n
 #include <iostream> // FIXME rm
+#include <vector>
 
 namespace Cfitsio {
 namespace ImageIo {
@@ -80,15 +83,60 @@ Linx::Raster<T, M> read_region(fitsfile* fptr, const Linx::Box<N>& region)
   return raster;
 }
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Read a region of a compressed image with a single call.
+ * @details
+ * CFITSIO decompresses each intersecting tile once, instead of once per row.
+ * If the destination is contiguous, it is filled directly; otherwise a buffer is copied row-wise.
+ */
+template <Linx::Index N, typename TOut>
+void read_compressed_region_to(fitsfile* fptr, const Linx::Box<N>& region, TOut& out)
+{
+  using T = std::decay_t<typename TOut::Value>;
+  const auto shape = region.shape();
+  const auto size = shape_size(shape);
+  auto back = shape;
+  for (auto& b : back) {
+    --b;
+  }
+  auto* first = &out[Linx::Position<N>::zero(shape.size())];
+  const auto* last = &out[back];
+  if (last - first + 1 == size) {
+    read_subset_to(fptr, region, first);
+    return;
+  }
+  std::vector<T> buffer(size);
+  read_subset_to(fptr, region, buffer.data());
+  auto row_fronts = project(region);
+  const auto length = region.length(0);
+  auto it = buffer.begin();
+  for (const auto& p : row_fronts) {
+    std::copy_n(it, length, &out[p - row_fronts.front()]);
+    it += length;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 template <Linx::Index N, typename TOut>
 void read_region_to(fitsfile* fptr, const Linx::Box<N>& region, TOut& out)
 {
+  if (is_compressed(fptr)) {
+    Internal::read_compressed_region_to(fptr, region, out);
+    return;
+  }
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataRead);
   int status = 0;
   auto step = region.step();
   auto row_fronts = project(region);
   ++row_fronts; // 1-based
 
   for (auto p : row_fronts) {
+    scope.count(region.length(0) * sizeof(typename TOut::Value));
     fits_read_pix(
         fptr,
         TypeCode<typename TOut::Value>::for_image(),
@@ -101,15 +149,62 @@ void read_region_to(fitsfile* fptr, const Linx::Box<N>& region, TOut& out)
   }
 }
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the 1-based first and last pixels of a region.
+ */
+template <Linx::Index N>
+std::pair<std::vector<long>, std::vector<long>> subset_bounds(const Linx::Box<N>& region)
+{
+  const auto& front = region.front();
+  const auto shape = region.shape();
+  const auto dimension = front.size();
+  std::vector<long> fpixel(dimension);
+  std::vector<long> lpixel(dimension);
+  for (Linx::Index i = 0; i < dimension; ++i) {
+    fpixel[i] = front[i] + 1;
+    lpixel[i] = front[i] + shape[i];
+  }
+  return {fpixel, lpixel};
+}
+
+} // namespace Internal
+/// @endcond
+
+template <typename T, Linx::Index N>
+void read_subset_to(fitsfile* fptr, const Linx::Box<N>& region, T* data)
+{
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataRead);
+  auto bounds = Internal::subset_bounds(region);
+  std::vector<long> inc(bounds.first.size(), 1);
+  int status = 0;
+  scope.count(shape_size(region.shape()) * sizeof(T));
+  fits_read_subset(
+      fptr,
+      TypeCode<T>::for_image(),
+      bounds.first.data(),
+      bounds.second.data(),
+      inc.data(),
+      nullptr,
+      data,
+      nullptr,
+      &status);
+  CfitsioError::may_throw(status, fptr, "Cannot read image region.");
+}
+
 template <typename TRaster>
 void write_raster(fitsfile* fptr, const TRaster& raster)
 {
   may_throw_readonly(fptr);
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataWrite);
   int status = 0;
   const auto begin = raster.data();
   const auto end = begin + raster.size();
   using Value = std::decay_t<typename TRaster::Value>;
   std::vector<Value> nonconst_data(begin, end); // For const-correctness issue
+  scope.count(raster.size() * sizeof(Value));
   fits_write_img(fptr, TypeCode<Value>::for_image(), 1, raster.size(), nonconst_data.data(), &status);
   CfitsioError::may_throw(status, fptr, "Cannot write image.");
 }
@@ -117,6 +212,7 @@ void write_raster(fitsfile* fptr, const TRaster& raster)
 template <Linx::Index N, typename TIn>
 void write_region(fitsfile* fptr, const Linx::Box<N>& region, TIn& in)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataWrite);
   int status = 0;
   auto step = region.step();
   auto row_fronts = project(region);
@@ -126,10 +222,23 @@ void write_region(fitsfile* fptr, const Linx::Box<N>& region, TIn& in)
   std::vector<std::decay_t<typename TIn::Value>> nonconst_data(size);
   for (auto p : row_fronts) {
     std::copy_n(&in[p - row_fronts.front()], size, nonconst_data.data());
+    scope.count(size * sizeof(typename TIn::Value));
     fits_write_pix(fptr, TypeCode<typename TIn::Value>::for_image(), p.data(), size, nonconst_data.data(), &status);
   }
 }
 
+template <typename T, Linx::Index N>
+void write_subset(fitsfile* fptr, const Linx::Box<N>& region, T* data)
+{
+  may_throw_readonly(fptr);
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataWrite);
+  auto bounds = Internal::subset_bounds(region);
+  int status = 0;
+  scope.count(shape_size(region.shape()) * sizeof(T));
+  fits_write_subset(fptr, TypeCode<T>::for_image(), bounds.first.data(), bounds.second.data(), data, &status);
+  CfitsioError::may_throw(status, fptr, "Cannot write image region.");
+}
+
 } // namespace ImageIo
 } // namespace Cfitsio
 
@@ -102,6 +102,8 @@ void read_column_data(
     Linx::Index repeat_count,
     std::string* data)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataRead);
+  scope.count(rows.size() * repeat_count);
   int status = 0;
   std::vector<char*> vec(rows.size());
   std::generate(vec.begin(), vec.end(), [&]() {
@@ -131,9 +133,11 @@ void write_column_data(
     fitsfile* fptr,
     const Fits::Segment& rows,
     Linx::Index index,
-    Linx::Index,
+    Linx::Index repeat_count,
     const std::string* data)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::DataWrite);
+  scope.count(rows.size() * repeat_count);
   int status = 0;
   Fits::String::CStrArray array(data, data + rows.size());
   fits_write_col(
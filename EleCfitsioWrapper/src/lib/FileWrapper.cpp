@@ -6,6 +6,7 @@
 
 #include "EleCfitsioWrapper/ErrorWrapper.h"
 #include "EleCfitsioWrapper/HduWrapper.h"
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
 
 namespace Cfitsio {
 namespace FileAccess {
@@ -42,6 +43,7 @@ void close(fitsfile*& fptr)
   if (not fptr) {
     return;
   }
+  Profiling::disable(fptr);
   int status = 0;
   fits_close_file(fptr, &status);
   CfitsioError::may_throw(status, fptr, "Cannot close file");
@@ -54,6 +56,7 @@ void close_delete(fitsfile*& fptr)
     return;
   }
   may_throw_readonly(fptr);
+  Profiling::disable(fptr);
   int status = 0;
   fits_delete_file(fptr, &status);
   fptr = nullptr;
@@ -77,5 +80,10 @@ bool is_writable(fitsfile* fptr)
   return filemode == READWRITE;
 }
 
+bool is_reentrant()
+{
+  return fits_is_reentrant();
+}
+
 } // namespace FileAccess
 } // namespace Cfitsio
@@ -7,6 +7,7 @@
 #include "EleCfitsioWrapper/ErrorWrapper.h"
 #include "EleCfitsioWrapper/HeaderWrapper.h"
 #include "EleCfitsioWrapper/ImageWrapper.h"
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
 #include "EleCfitsioWrapper/TypeWrapper.h"
 #include "EleFitsData/Raster.h"
 
@@ -103,6 +104,8 @@ bool goto_index(fitsfile* fptr, Linx::Index index)
   if (index == current_index(fptr)) {
     return false;
   }
+  Profiling::Scope scope(fptr, Profiling::CallClass::HduMove);
+  scope.count();
   int type = 0;
   int status = 0;
   fits_movabs_hdu(fptr, static_cast<int>(index), &type, &status); // HDU indices are int
@@ -124,6 +127,8 @@ bool goto_name(fitsfile* fptr, const std::string& name, long version, Fits::HduC
   } else if (category != Fits::HduCategory::Any) {
     throw Fits::FitsError("Invalid HduCategory; Only Any, Image and Bintable are supported.");
   }
+  Profiling::Scope scope(fptr, Profiling::CallClass::HduMove);
+  scope.count();
   fits_movnam_hdu(fptr, hdutype, Fits::String::to_char_ptr(name).get(), version, &status);
   CfitsioError::may_throw(status, fptr, "Cannot move to HDU: " + name);
   return true;
@@ -134,6 +139,8 @@ bool goto_next(fitsfile* fptr, Linx::Index step)
   if (step == 0) {
     return false;
   }
+  Profiling::Scope scope(fptr, Profiling::CallClass::HduMove);
+  scope.count();
   int status = 0;
   int type = 0;
   fits_movrel_hdu(fptr, static_cast<int>(step), &type, &status); // HDU indices are int
@@ -5,6 +5,7 @@
 #include "EleCfitsioWrapper/HeaderWrapper.h"
 
 #include "EleCfitsioWrapper/ErrorWrapper.h"
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
 #include "EleFitsData/FitsError.h"
 
 #include <limits>
@@ -14,6 +15,7 @@ namespace HeaderIo {
 
 std::string read_header(fitsfile* fptr, bool inc_non_valued)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderRead);
   int status = 0;
   char* header = nullptr;
   int record_count = 0;
@@ -26,6 +28,7 @@ std::string read_header(fitsfile* fptr, bool inc_non_valued)
       &record_count,
       &status);
   std::string header_htring {header};
+  scope.count(header_htring.size());
   fits_free_memory(header, &status);
   CfitsioError::may_throw(status, fptr, "Cannot read the complete header");
   return header_htring;
@@ -80,6 +83,8 @@ bool has_keyword(fitsfile* fptr, const std::string& keyword)
 template <>
 Fits::Record<bool> parse_record<bool>(fitsfile* fptr, const std::string& keyword)
 { // TODO rm duplication
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderRead);
+  scope.count(FLEN_CARD - 1);
   int status = 0;
   /* Read value and comment */
   int nonconst_int_value; // TLOGICAL is for int in CFITSIO
@@ -108,6 +113,7 @@ template <>
 Fits::Record<std::string> parse_record<std::string>(fitsfile* fptr, const std::string& keyword)
 {
   // TODO rm duplication
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderRead);
   int status = 0;
   int length = 0;
   fits_get_key_strlen(fptr, keyword.c_str(), &length, &status);
@@ -122,6 +128,7 @@ Fits::Record<std::string> parse_record<std::string>(fitsfile* fptr, const std::s
   // FIXME Could be longer! No known way of reading the comment size (mail sent)
   // Option: don't read comment if length > 68
   comment[0] = '\0';
+  scope.count(FLEN_CARD - 1);
   fits_read_key_longstr(fptr, keyword.c_str(), &value, comment, &status);
   fits_read_key_unit(fptr, keyword.c_str(), unit, &status);
   std::string str_value(value);
@@ -163,6 +170,8 @@ Fits::Record<Fits::VariantValue> parse_record<Fits::VariantValue>(fitsfile* fptr
 template <>
 void write_record<bool>(fitsfile* fptr, const Fits::Record<bool>& record)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderWrite);
+  scope.count(FLEN_CARD - 1);
   int status = 0;
   int nonconst_int_value = record.value; // TLOGICAL is for int in CFITSIO
   fits_write_key(
@@ -178,6 +187,8 @@ void write_record<bool>(fitsfile* fptr, const Fits::Record<bool>& record)
 template <>
 void write_record<std::string>(fitsfile* fptr, const Fits::Record<std::string>& record)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderWrite);
+  scope.count(FLEN_CARD - 1);
   int status = 0;
   if (record.has_long_string_value()) { // https://heasarc.gsfc.nasa.gov/docs/software/fitsio/c/c_user/node118.html
     fits_write_key_longwarn(fptr, &status);
@@ -215,6 +226,8 @@ void write_record<Fits::VariantValue>(fitsfile* fptr, const Fits::Record<Fits::V
 template <>
 void update_record<bool>(fitsfile* fptr, const Fits::Record<bool>& record)
 {
+  Profiling::Scope scope(fptr, Profiling::CallClass::HeaderWrite);
+  scope.count(FLEN_CARD - 1);
   int status = 0;
   std::string comment = record.raw_comment();
   int nonconst_int_value = record.value; // TLOGICAL is for int in CFITSIO
@@ -238,6 +251,8 @@ void update_record<std::string>(fitsfile* fptr, const Fits::Record<std::string>&
     write_record(fptr, record);
     // Keyword ordering is changed after deletion, but there is no better (simple) option
   } else {
+    Profiling::Scope scope(fptr, Profiling::CallClass::HeaderWrite);
+    scope.count(FLEN_CARD - 1);
     int status = 0;
     std::string comment = record.raw_comment();
     fits_update_key(
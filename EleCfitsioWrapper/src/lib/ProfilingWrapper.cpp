@@ -0,0 +1,149 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace Cfitsio {
+namespace Profiling {
+
+namespace {
+
+/**
+ * @brief The counters of the profiled files, by file and 1-based HDU index.
+ */
+struct Registry {
+  std::atomic<Linx::Index> file_count {0};
+  std::mutex mutex;
+  std::map<fitsfile*, std::map<Linx::Index, Counters>> files;
+};
+
+Registry& registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+} // namespace
+
+std::string call_class_name(CallClass call_class)
+{
+  switch (call_class) {
+    case CallClass::HduMove:
+      return "HduMove";
+    case CallClass::HeaderRead:
+      return "HeaderRead";
+    case CallClass::HeaderWrite:
+      return "HeaderWrite";
+    case CallClass::DataRead:
+      return "DataRead";
+    case CallClass::DataWrite:
+      return "DataWrite";
+  }
+  return "Unknown";
+}
+
+Counter& Counter::operator+=(const Counter& rhs)
+{
+  calls += rhs.calls;
+  bytes += rhs.bytes;
+  seconds += rhs.seconds;
+  return *this;
+}
+
+Counter& Counters::operator[](CallClass call_class)
+{
+  return counters[static_cast<std::size_t>(call_class)];
+}
+
+const Counter& Counters::operator[](CallClass call_class) const
+{
+  return counters[static_cast<std::size_t>(call_class)];
+}
+
+Counters& Counters::operator+=(const Counters& rhs)
+{
+  for (std::size_t i = 0; i < call_class_count; ++i) {
+    counters[i] += rhs.counters[i];
+  }
+  return *this;
+}
+
+void enable(fitsfile* fptr)
+{
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  if (r.files.emplace(fptr, std::map<Linx::Index, Counters>()).second) {
+    ++r.file_count;
+  }
+}
+
+void disable(fitsfile* fptr)
+{
+  auto& r = registry();
+  if (r.file_count.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(r.mutex);
+  if (r.files.erase(fptr)) {
+    --r.file_count;
+  }
+}
+
+bool is_enabled(fitsfile* fptr)
+{
+  auto& r = registry();
+  if (r.file_count.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(r.mutex);
+  return r.files.count(fptr);
+}
+
+Counters take(fitsfile* fptr, Linx::Index index)
+{
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  auto file = r.files.find(fptr);
+  if (file == r.files.end()) {
+    return {};
+  }
+  auto hdu = file->second.find(index);
+  if (hdu == file->second.end()) {
+    return {};
+  }
+  auto out = hdu->second;
+  file->second.erase(hdu);
+  return out;
+}
+
+Scope::Scope(fitsfile* fptr, CallClass call_class) :
+    m_fptr(is_enabled(fptr) ? fptr : nullptr), m_class(call_class), m_start(), m_counter()
+{
+  if (m_fptr) {
+    m_start = std::chrono::steady_clock::now();
+  }
+}
+
+Scope::~Scope()
+{
+  if (not m_fptr) {
+    return;
+  }
+  m_counter.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+  int index = 0;
+  fits_get_hdu_num(m_fptr, &index);
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  auto file = r.files.find(m_fptr);
+  if (file != r.files.end()) {
+    file->second[index][m_class] += m_counter;
+  }
+}
+
+} // namespace Profiling
+} // namespace Cfitsio
@@ -4,9 +4,14 @@
 
 #include "EleCfitsioWrapper/CfitsioFixture.h"
 #include "EleCfitsioWrapper/CompressionWrapper.h"
+#include "EleCfitsioWrapper/HduWrapper.h"
+#include "EleCfitsioWrapper/HeaderWrapper.h"
+#include "EleCfitsioWrapper/ImageWrapper.h"
+#include "EleFitsData/TestRaster.h"
 
 #include <boost/test/unit_test.hpp>
 #include <string>
+#include <vector>
 
 using namespace Cfitsio;
 
@@ -138,6 +143,99 @@ BOOST_AUTO_TEST_CASE(iscompressing_test)
   BOOST_CHECK_NO_THROW(dynamic_cast<Fits::NoCompression&>(*ImageCompression::get_compression(file.fptr)));
 }
 
+std::vector<unsigned char> read_compressed_tile(fitsfile* fptr, LONGLONG row)
+{
+  int status = 0;
+  int column = 0;
+  LONGLONG size = 0;
+  LONGLONG offset = 0;
+  fits_get_colnum(fptr, CASEINSEN, const_cast<char*>("COMPRESSED_DATA"), &column, &status);
+  fits_read_descriptll(fptr, column, row, &size, &offset, &status);
+  std::vector<unsigned char> tile(size);
+  fits_read_col(fptr, TBYTE, column, row, 1, size, nullptr, tile.data(), nullptr, &status);
+  BOOST_TEST(status == 0);
+  return tile;
+}
+
+/**
+ * @brief Check that compressing tiles in parallel yields the same tiles as CFITSIO.
+ * @param seed The dithering seed, or 0 to keep the default one
+ */
+template <typename T, typename TAlgo>
+void check_parallel_compression_is_bit_identical(
+    const TAlgo& algo,
+    const Fits::Test::RandomRaster<T, 3>& raster,
+    int seed)
+{
+  const auto& shape = raster.shape();
+  Fits::Test::MinimalFile sequential;
+  Fits::Test::MinimalFile parallel;
+  for (auto* fptr : {sequential.fptr, parallel.fptr}) {
+    int status = 0;
+    ImageCompression::compress(fptr, algo);
+    if (seed > 0) {
+      fits_set_dither_seed(fptr, seed, &status);
+    }
+    BOOST_TEST(status == 0);
+    HduAccess::init_image<T>(fptr, "", shape);
+  }
+  ImageIo::write_raster(sequential.fptr, raster);
+  ImageCompression::write_parallel(parallel.fptr, raster, 3);
+
+  LONGLONG sequential_rows = 0;
+  LONGLONG parallel_rows = 0;
+  int status = 0;
+  fits_get_num_rowsll(sequential.fptr, &sequential_rows, &status);
+  fits_get_num_rowsll(parallel.fptr, &parallel_rows, &status);
+  BOOST_TEST(parallel_rows == sequential_rows);
+  for (LONGLONG row = 1; row <= sequential_rows; ++row) {
+    BOOST_TEST(read_compressed_tile(parallel.fptr, row) == read_compressed_tile(sequential.fptr, row));
+  }
+  if (seed > 0) {
+    BOOST_TEST(HeaderIo::parse_record<int>(parallel.fptr, "ZDITHER0").value == seed);
+  }
+
+  const auto expected = ImageIo::read_raster<T, 3>(sequential.fptr);
+  const auto output = ImageIo::read_raster<T, 3>(parallel.fptr);
+  BOOST_TEST(output.container() == expected.container());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_compression_is_bit_identical_test)
+{
+  const Fits::Test::RandomRaster<float, 3> raster({40, 30, 11}, 0, 1000);
+  const Fits::Rice algo(Linx::Position<-1> {10, 15, 2}, Fits::Quantization(4));
+  check_parallel_compression_is_bit_identical(algo, raster, 9999); // Wrap around 10000 when offset
+}
+
+BOOST_AUTO_TEST_CASE(parallel_lossless_compression_is_bit_identical_test)
+{
+  const Fits::Test::RandomRaster<std::int32_t, 3> raster({40, 30, 11}, 0, 1000); // Plio-compatible
+  const Linx::Position<-1> tiling {10, 15, 2};
+  check_parallel_compression_is_bit_identical(Fits::Gzip(tiling), raster, 0);
+  check_parallel_compression_is_bit_identical(Fits::ShuffledGzip(tiling), raster, 0);
+  check_parallel_compression_is_bit_identical(Fits::Rice(tiling), raster, 0);
+  check_parallel_compression_is_bit_identical(Fits::HCompress(Linx::Position<-1> {10, 15}), raster, 0);
+  check_parallel_compression_is_bit_identical(Fits::Plio(tiling), raster, 0);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_decompression_is_bit_identical_test)
+{
+  const Linx::Position<3> shape {40, 30, 11};
+  const Fits::Test::RandomRaster<float, 3> raster(shape, 0, 1000);
+  Fits::Test::MinimalFile file;
+  int status = 0;
+  ImageCompression::compress(file.fptr, Fits::Rice(Linx::Position<-1> {10, 15, 2}, Fits::Quantization(4)));
+  fits_set_dither_seed(file.fptr, 9999, &status);
+  BOOST_TEST(status == 0);
+  HduAccess::init_image<float>(file.fptr, "", shape);
+  ImageIo::write_raster(file.fptr, raster);
+
+  const auto expected = ImageIo::read_raster<float, 3>(file.fptr);
+  Linx::Raster<float, 3> output(shape);
+  ImageCompression::read_parallel_to(file.fptr, output, 3);
+  BOOST_TEST(output.container() == expected.container());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -89,6 +89,37 @@ BOOST_FIXTURE_TEST_CASE(region_is_read_back_test, Fits::Test::MinimalFile)
   }
 }
 
+BOOST_FIXTURE_TEST_CASE(compressed_region_is_read_back_test, Fits::Test::MinimalFile)
+{
+  Linx::Raster<std::int32_t, 3> input({12, 8, 5});
+  input.generate(
+      [](const auto& p) {
+        return p[0] * 100 + p[1] * 10 + p[2];
+      },
+      input.domain());
+  int status = 0;
+  long tiling[] = {4, 4, 1};
+  fits_set_compression_type(fptr, RICE_1, &status);
+  fits_set_tile_dim(fptr, 3, tiling, &status);
+  BOOST_TEST(status == 0);
+  HduAccess::assign_image(fptr, "EXT", input);
+  BOOST_TEST(ImageIo::is_compressed(fptr));
+  const auto region = Linx::Box<3>::from_shape({3, 2, 1}, {6, 5, 3}); // Straddles tiles
+
+  const auto view = ImageIo::read_region<std::int32_t, 3>(fptr, region); // Contiguous
+  BOOST_TEST(view.shape() == region.shape());
+  for (const auto& p : view.domain()) {
+    BOOST_TEST(view[p] == input[p + region.front()]);
+  }
+
+  Linx::Raster<std::int32_t, 3> output(input.shape());
+  auto dst = output(region); // Not contiguous
+  ImageIo::read_region_to(fptr, region, dst);
+  for (const auto& p : region) {
+    BOOST_TEST(output[p] == input[p]);
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,64 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleCfitsioWrapper/CfitsioFixture.h"
+#include "EleCfitsioWrapper/HduWrapper.h"
+#include "EleCfitsioWrapper/HeaderWrapper.h"
+#include "EleCfitsioWrapper/ImageWrapper.h"
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
+#include "EleFitsData/TestRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Cfitsio;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(ProfilingWrapper_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(disabled_file_is_not_counted_test)
+{
+  Fits::Test::RandomRaster<float, 2> raster({16, 9});
+  Fits::Test::MinimalFile file;
+  BOOST_TEST(not Profiling::is_enabled(file.fptr));
+  HduAccess::assign_image(file.fptr, "IMAGE", raster);
+  const auto counters = Profiling::take(file.fptr, 2);
+  BOOST_TEST(counters[Profiling::CallClass::DataWrite].calls == 0);
+}
+
+BOOST_AUTO_TEST_CASE(image_ios_are_counted_per_hdu_test)
+{
+  using Profiling::CallClass;
+  Fits::Test::RandomRaster<float, 2> raster({16, 9});
+  const auto bytes = raster.size() * sizeof(float);
+  Fits::Test::MinimalFile file;
+  Profiling::enable(file.fptr);
+  BOOST_TEST(Profiling::is_enabled(file.fptr));
+
+  HduAccess::assign_image(file.fptr, "IMAGE", raster);
+  HeaderIo::write_record(file.fptr, Fits::Record<int>("FOO", 1));
+  HduAccess::goto_primary(file.fptr);
+  HduAccess::goto_index(file.fptr, 2);
+  ImageIo::read_raster<float, 2>(file.fptr);
+
+  const auto counters = Profiling::take(file.fptr, 2);
+  BOOST_TEST(counters[CallClass::DataWrite].calls >= 1);
+  BOOST_TEST(counters[CallClass::DataWrite].bytes == bytes);
+  BOOST_TEST(counters[CallClass::DataRead].bytes == bytes);
+  BOOST_TEST(counters[CallClass::HeaderWrite].calls >= 1);
+  BOOST_TEST(counters[CallClass::HduMove].calls >= 1);
+  BOOST_TEST(counters[CallClass::DataRead].seconds >= 0.);
+
+  const auto reset = Profiling::take(file.fptr, 2);
+  BOOST_TEST(reset[CallClass::DataRead].calls == 0);
+
+  Profiling::disable(file.fptr);
+  BOOST_TEST(not Profiling::is_enabled(file.fptr));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,9 +5,17 @@
 #ifndef _ELEFITS_ACTION_H
 #define _ELEFITS_ACTION_H
 
+#include "EleCfitsioWrapper/ProfilingWrapper.h"
+#include "EleFits/CompressionStrategy.h"
+#include "EleFits/DataAccess.h"
 #include "EleFits/Hdu.h"
 
 #include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace Fits {
 
@@ -41,6 +49,20 @@ public:
   LINX_DEFAULT_MOVABLE(Action)
   LINX_VIRTUAL_DTOR(Action)
 
+  /// @group_properties
+
+  /**
+   * @brief Check whether the action observes data accesses.
+   * @details
+   * Data accesses are described and notified only if at least one action of the strategy observes them,
+   * such that the data accesses of files with no observer have no overhead.
+   * Actions which override the data access methods (e.g. `reading()`) or `parsed()` must return `true`.
+   */
+  virtual bool observes_data() const
+  {
+    return false;
+  }
+
   /// @group_operations
 
   /**
@@ -70,6 +92,49 @@ public:
    */
   virtual void closing(const Hdu&) {}
 
+  /**
+   * @brief Method called just after a data-driven compression action measured the candidate algorithms.
+   * 
+   * At that time, the HDU does not exist yet.
+   * @see CompressSampled
+   */
+  virtual void selected(const CompressionSelection&) {}
+
+  /**
+   * @brief Method called just after parsing header records, e.g. with `Header::parse()` or `Header::parse_all()`.
+   * 
+   * Like data accesses, parsed records are only notified if the action observes data (see `observes_data()`).
+   */
+  virtual void parsed(const Hdu&, const std::vector<std::string>&) {}
+
+  /**
+   * @brief Method called just before reading an image region or a column segment.
+   * 
+   * Whole images and columns are notified as a single access,
+   * while multi-column reads are notified per column and per chunk of buffered rows.
+   * Tile cache hits are notified too, such that the accesses are those of the user.
+   * Accesses of unobserved HDUs, e.g. of a `SifFile`, are not notified.
+   */
+  virtual void reading(const Hdu&, const DataAccess&) {}
+
+  /**
+   * @brief Method called just after reading an image region or a column segment.
+   * @see reading()
+   */
+  virtual void read(const Hdu&, const DataAccess&) {}
+
+  /**
+   * @brief Method called just before writing an image region or a column segment.
+   * @see reading()
+   */
+  virtual void writing(const Hdu&, const DataAccess&) {}
+
+  /**
+   * @brief Method called just after writing an image region or a column segment.
+   * @see reading()
+   */
+  virtual void written(const Hdu&, const DataAccess&) {}
+
   /// @}
 };
 
@@ -210,6 +275,247 @@ private:
   std::time_t m_time;
 };
 
+/**
+ * @ingroup strategy
+ * @brief The I/O counters of an HDU, as collected by `ProfileIo`.
+ */
+struct HduProfile {
+  std::string file; ///< The file name
+  Linx::Index index; ///< The 0-based HDU index
+  std::string name; ///< The HDU name
+  Cfitsio::Profiling::Counters counters; ///< The counters, per call class
+};
+
+/**
+ * @ingroup strategy
+ * @brief An action which counts the I/Os of each HDU: CFITSIO calls, bytes and time per call class.
+ * 
+ * Profiling of the file starts when an HDU is opened, accessed or created,
+ * and the counters of each HDU are collected just before closing the file
+ * (see `Cfitsio::Profiling` for the details on what is measured).
+ * Copies share the profile, such that the results can be read from the instance passed to the strategy,
+ * and that a single instance can be used to profile several files.
+ * If an output file name is provided, the profile is saved once, when the last copy is destroyed,
+ * e.g. when the file is closed if the action was passed as a temporary,
+ * or at the end of the scope of the instance below:
+ * 
+ * \code
+ * ProfileIo profile("profile.json");
+ * {
+ *   MefFile f(filename, FileMode::Read, profile);
+ *   ...
+ * }
+ * std::cout << profile.total()[Cfitsio::Profiling::CallClass::DataRead].bytes << std::endl;
+ * \endcode
+ */
+class ProfileIo : public Action {
+public:
+
+  LINX_VIRTUAL_DTOR(ProfileIo)
+  LINX_DEFAULT_COPYABLE(ProfileIo)
+  LINX_DEFAULT_MOVABLE(ProfileIo)
+
+  /**
+   * @brief Constructor.
+   * @param filename The output file name, if any, where the profile is saved by the last copy (see `save()`)
+   */
+  explicit ProfileIo(std::string filename = "");
+
+  /**
+   * @brief Start profiling the file.
+   */
+  void opened(const Hdu& hdu) override;
+
+  /**
+   * @copydoc opened()
+   */
+  void accessed(const Hdu& hdu) override;
+
+  /**
+   * @copydoc opened()
+   */
+  void created(const Hdu& hdu) override;
+
+  /**
+   * @brief Collect the HDU counters.
+   */
+  void closing(const Hdu& hdu) override;
+
+  /**
+   * @brief Get the profiles of the collected HDUs.
+   */
+  const std::vector<HduProfile>& hdus() const;
+
+  /**
+   * @brief Get the counters aggregated per file.
+   */
+  std::map<std::string, Cfitsio::Profiling::Counters> files() const;
+
+  /**
+   * @brief Get the counters aggregated over all HDUs.
+   */
+  Cfitsio::Profiling::Counters total() const;
+
+  /**
+   * @brief Save the profile as JSON if the file name ends with ".json", or as CSV otherwise.
+   * @details
+   * The CSV file contains one row per HDU followed by one row per file, whose HDU index is empty,
+   * and three columns per call class: number of calls, bytes and seconds.
+   */
+  void save(const std::string& filename) const;
+
+private:
+
+  /**
+   * @brief Start profiling the file of an HDU.
+   */
+  void enable(const Hdu& hdu) const;
+
+  /**
+   * @brief The profiles, shared by the copies, and saved by the deleter if an output file name was provided.
+   */
+  std::shared_ptr<std::vector<HduProfile>> m_hdus;
+};
+
+/**
+ * @ingroup strategy
+ * @brief An event of an access trace, as recorded by `TraceAccesses`.
+ * 
+ * Events are stored as text lines of whitespace-separated fields,
+ * which start with the event type and the 0-based HDU index:
+ * 
+ * \verbatim
+ A 1
+ H 1 NAXIS1 NAXIS2
+ R 1 int16 I 0,0 16,9 288
+ W 2 int32 T 0 2 5 16
+ \endverbatim
+ * 
+ * where header parsing events (`H`) list the parsed keywords, and data access events (`R` and `W`) list
+ * the value type name (see `DataAccess::type_name()`), `I` followed by the front and shape of an image region,
+ * or `T` followed by the column index and the first and last rows of a column segment,
+ * and finally the number of bytes.
+ */
+struct TraceEvent {
+
+  /**
+   * @brief The event types.
+   */
+  enum class Type : char {
+    Access = 'A', ///< First access to, or creation of, the HDU
+    Parse = 'H', ///< Header records parsing
+    Read = 'R', ///< Data read
+    Write = 'W' ///< Data write
+  };
+
+  /**
+   * @brief Parse an event from a trace line.
+   * @throw FitsError if the line is malformed
+   */
+  static TraceEvent from_string(const std::string& line);
+
+  /**
+   * @brief Write the event as a trace line, without line terminator.
+   */
+  std::string to_string() const;
+
+  Type type = Type::Access; ///< The event type
+  Linx::Index hdu = 0; ///< The 0-based HDU index
+  std::vector<std::string> keywords = {}; ///< The parsed keywords, for header parsing events
+  DataAccess data = {}; ///< The accessed data, for read and write events
+};
+
+/**
+ * @ingroup strategy
+ * @brief An action which records the HDU accesses, header parsing and data reads and writes to a trace file.
+ * 
+ * The trace can be loaded with `load()` and replayed against any file with program `EleFitsReplayTrace`,
+ * such that library changes or strategies can be benchmarked against actual access patterns:
+ * 
+ * \code
+ * {
+ *   MefFile f(filename, FileMode::Read, TraceAccesses("trace.txt"));
+ *   ... // Production code
+ * }
+ * const auto events = TraceAccesses::load("trace.txt");
+ * \endcode
+ * 
+ * Copies share the output stream, which is flushed each time the file is being closed.
+ * Only one file should be traced at a time.
+ * 
+ * @see TraceEvent for the trace format
+ */
+class TraceAccesses : public Action {
+public:
+
+  LINX_VIRTUAL_DTOR(TraceAccesses)
+  LINX_DEFAULT_COPYABLE(TraceAccesses)
+  LINX_DEFAULT_MOVABLE(TraceAccesses)
+
+  /**
+   * @brief Constructor.
+   * @param filename The trace file name, which is overwritten
+   */
+  explicit TraceAccesses(const std::string& filename);
+
+  /**
+   * @brief Observe data accesses and header parsing.
+   */
+  bool observes_data() const override
+  {
+    return true;
+  }
+
+  /**
+   * @brief Record an access event.
+   */
+  void accessed(const Hdu& hdu) override;
+
+  /**
+   * @copydoc accessed()
+   */
+  void created(const Hdu& hdu) override;
+
+  /**
+   * @brief Flush the trace.
+   */
+  void closing(const Hdu& hdu) override;
+
+  /**
+   * @brief Record a header parsing event.
+   */
+  void parsed(const Hdu& hdu, const std::vector<std::string>& keywords) override;
+
+  /**
+   * @brief Record a read event.
+   */
+  void read(const Hdu& hdu, const DataAccess& access) override;
+
+  /**
+   * @brief Record a write event.
+   */
+  void written(const Hdu& hdu, const DataAccess& access) override;
+
+  /**
+   * @brief Load a trace file.
+   * @details
+   * Empty lines and lines which start with '#' are skipped.
+   */
+  static std::vector<TraceEvent> load(const std::string& filename);
+
+private:
+
+  /**
+   * @brief Write an event to the trace.
+   */
+  void record(const TraceEvent& event) const;
+
+  /**
+   * @brief The trace stream, shared by the copies.
+   */
+  std::shared_ptr<std::ofstream> m_trace;
+};
+
 } // namespace Fits
 
 #endif
@@ -6,6 +6,7 @@
 #define _ELEFITS_BINTABLECOLUMNS_H
 
 #include "EleFits/ColumnKey.h"
+#include "EleFits/DataAccess.h"
 #include "EleFits/FileMemSegments.h"
 #include "EleFitsData/Column.h"
 #include "EleFitsData/DataUtils.h" // TypedKey
@@ -15,6 +16,8 @@
 
 namespace Fits {
 
+class Hdu; // necessary for the parent HDU pointer
+
 /**
  * @ingroup bintable_handlers
  * @brief Column-wise reader-writer for the binary table data unit.
@@ -81,8 +84,13 @@ private:
 
   /**
    * @brief Constructor.
+   * @param hdu The parent HDU, which notifies the data accesses, if any
    */
-  BintableColumns(fitsfile*& fptr, std::function<void(void)> touch, std::function<void(void)> edit);
+  BintableColumns(
+      fitsfile*& fptr,
+      std::function<void(void)> touch,
+      std::function<void(void)> edit,
+      const Hdu* hdu = nullptr);
 
 public:
 
@@ -504,6 +512,25 @@ public:
 
 private:
 
+  /**
+   * @brief Check whether data accesses should be notified.
+   */
+  bool observed() const;
+
+  /**
+   * @brief Notify a data access.
+   */
+  void notify(DataStage stage, const DataAccess& access) const;
+
+  /**
+   * @brief Run a data access, and notify it before and after if needed.
+   * @param writing Whether the access is a write
+   * @param access The function which describes the access, only called if the access is notified
+   * @param run The function which runs the access
+   */
+  template <typename TAccess, typename TRun>
+  void observe(bool writing, TAccess&& access, TRun&& run) const;
+
   /**
    * @brief The fitsfile.
    */
@@ -518,6 +545,11 @@ private:
    * @brief The function to declare that the header was edited.
    */
   std::function<void(void)> m_edit;
+
+  /**
+   * @brief The parent HDU, if any.
+   */
+  const Hdu* m_hdu;
 };
 
 /**
@@ -9,6 +9,8 @@
 #include "EleFits/BintableColumns.h"
 #include "EleFits/Hdu.h"
 
+#include <memory>
+#include <optional>
 #include <string>
 
 namespace Fits {
@@ -16,6 +18,13 @@ namespace Fits {
 /**
  * @ingroup bintable_handlers
  * @brief Binary table HDU reader-writer.
+ * 
+ * Compressed binary tables (see `CompressBintables`) are read-only.
+ * The first time their columns are read, they are decompressed in memory,
+ * such that subsequent reads are as fast as for uncompressed tables.
+ * The whole table is decompressed, whichever columns and rows are read,
+ * and the decompressed copy, of `ZNAXIS1 * ZNAXIS2` bytes, is kept until the file is closed.
+ * The header unit is left as is, and describes the compressed columns.
  */
 class BintableHdu : public Hdu {
 public:
@@ -48,6 +57,11 @@ public:
    */
   HduCategory category() const override;
 
+  /**
+   * @brief Check whether the HDU is a compressed binary table.
+   */
+  bool is_compressed() const;
+
   /// @group_elements
 
   /**
@@ -84,6 +98,26 @@ public:
 
 private:
 
+  /**
+   * @brief Get the file pointer to the data unit, and decompress it if needed.
+   */
+  fitsfile* data_fptr() const;
+
+  /**
+   * @brief Whether the table is compressed, once known.
+   */
+  mutable std::optional<bool> m_compressed;
+
+  /**
+   * @brief The decompressed table in memory, if any.
+   */
+  mutable std::shared_ptr<fitsfile> m_decompressed;
+
+  /**
+   * @brief The file pointer used by the column-wise handler.
+   */
+  mutable fitsfile* m_data_fptr;
+
   /**
    * @brief The column-wise data unit handler.
    */
@@ -7,8 +7,14 @@
 
 #include "EleCfitsioWrapper/CompressionWrapper.h"
 #include "EleFits/ImageHdu.h"
+#include "EleFits/TilingTable.h"
 #include "EleFitsData/Compression.h"
 
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace Fits {
 
 /// @cond
@@ -24,6 +30,55 @@ Linx::Position<N> unravel_index(Linx::Index index, Linx::Position<N> shape) // F
 }
 /// @endcond
 
+/**
+ * @ingroup compression
+ * @brief The measurements of a compression algorithm on some data samples.
+ * @see CompressSampled
+ */
+struct CompressionTrial {
+  /**
+   * @brief The compression ratio, i.e. the raw size divided by the compressed size.
+   */
+  double ratio() const
+  {
+    return compressed_bytes == 0 ? 0. : static_cast<double>(raw_bytes) / compressed_bytes;
+  }
+
+  /**
+   * @brief The compression throughput, in raw bytes per second.
+   */
+  double throughput() const
+  {
+    return seconds <= 0. ? 0. : raw_bytes / seconds;
+  }
+
+  std::string algorithm; ///< The algorithm name, e.g. `"Rice"`
+  std::size_t raw_bytes; ///< The size of the samples before compression
+  std::size_t compressed_bytes; ///< The size of the samples after compression
+  double seconds; ///< The encoding time of the samples
+};
+
+/**
+ * @ingroup compression
+ * @brief The report of a compression algorithm selection.
+ * @see CompressSampled
+ * @see Action::selected()
+ */
+struct CompressionSelection {
+  /**
+   * @brief Get the selected trial, or `nullptr` if no algorithm was suitable.
+   */
+  const CompressionTrial* choice() const
+  {
+    return selected < trials.size() ? &trials[selected] : nullptr;
+  }
+
+  Linx::Index index; ///< The index of the HDU to be created
+  std::string name; ///< The name of the HDU to be created
+  std::vector<CompressionTrial> trials; ///< The trials of the candidate algorithms
+  std::size_t selected; ///< The index of the selected trial
+};
+
 /**
  * @ingroup compression
  * @brief The interface for implementing compression actions.
@@ -58,6 +113,17 @@ public:
   ELEFITS_FOREACH_RASTER_TYPE(ELEFITS_DECLARE_VISIT)
 #undef ELEFITS_DECLARE_VISIT
 
+  /**
+   * @brief Get the report of the last selection, if the action is data-driven.
+   * @details
+   * The strategy forwards the report to its actions (see `Action::selected()`) after each successful call.
+   * @return The report, or `nullptr` if the last call did not measure anything
+   */
+  virtual const CompressionSelection* selection() const
+  {
+    return nullptr;
+  }
+
   /// @}
 };
 
@@ -322,15 +388,19 @@ private:
 
   /**
    * @brief Adapt the quantization to the pixel type and strategy type.
+   * @details
+   * If the data is known, the level is made absolute w.r.t. the noise of the whole data,
+   * such that CFITSIO does not estimate the noise tile-wise.
    */
   template <typename T>
-  Quantization quantization() const;
+  Quantization quantization(const ImageHdu::Initializer<T>& init) const;
 
   /**
-   * @brief Adapt the H-compress scaling to the raster shape.
+   * @brief Adapt the H-compress scaling to the pixel type and strategy type.
+   * @copydetails quantization()
    */
   template <typename T>
-  Scaling hcompress_scaling() const;
+  Scaling hcompress_scaling(const ImageHdu::Initializer<T>& init) const;
 
   /**
    * @brief The compression type.
@@ -338,6 +408,164 @@ private:
   CompressionType m_type;
 };
 
+/**
+ * @ingroup compression
+ * @brief A data-driven adaptive compression strategy.
+ * 
+ * Instead of relying on static rules, this strategy compresses a few sample tiles of the data
+ * with each of the algorithms which `CompressAuto` deems compatible
+ * (`Plio`, `HCompress`, `Rice` and `ShuffledGzip`),
+ * measures the compression ratio and encoding time,
+ * and selects the algorithm of lowest cost according to some user-provided cost function.
+ * The samples are compressed in memory, such that the file is not modified.
+ * 
+ * The report of the selection is forwarded by the strategy to its actions (see `Action::selected()`),
+ * e.g. for logging:
+ * 
+ * \code
+ * struct LogSelection : public Action {
+ *   void selected(const CompressionSelection& selection) override {
+ *     if (const auto* choice = selection.choice()) {
+ *       logger.info() << selection.name << ": " << choice->algorithm << " x" << choice->ratio();
+ *     }
+ *   }
+ * };
+ * 
+ * MefFile f(filename, FileMode::Create, CompressSampled(CompressionType::Lossless, 8), LogSelection());
+ * \endcode
+ * 
+ * When the data is not available at HDU creation (e.g. with `MefFile::append_image_header()`,
+ * or when `MefFile::append()` streams a large image), this strategy falls back to the rules of `CompressAuto`,
+ * and no selection is reported.
+ */
+class CompressSampled : public CompressionActionMixin<CompressSampled> {
+public:
+
+  /**
+   * @brief The cost function, to be minimized.
+   */
+  using Cost = std::function<double(const CompressionTrial&)>;
+
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param type The compression type
+   * @param sample_count The maximum number of sample tiles
+   * @param cost The cost function
+   */
+  explicit CompressSampled(
+      CompressionType type = CompressionType::Lossless,
+      Linx::Index sample_count = 4,
+      Cost cost = tradeoff()) :
+      m_auto(type), m_sample_count(sample_count), m_cost(std::move(cost)), m_selection()
+  {}
+
+  /**
+   * @brief Create a cost function which balances compression ratio and throughput.
+   * @param seconds_per_megabyte The weight of the encoding time in seconds per megabyte,
+   * 0 to select the best compression ratio whatever the time
+   * @details
+   * The cost is the compressed size relative to the raw size,
+   * plus the weighted encoding time per megabyte of raw data.
+   */
+  static Cost tradeoff(double seconds_per_megabyte = 0.)
+  {
+    return [=](const CompressionTrial& trial) {
+      const auto megabytes = trial.raw_bytes / 1.e6;
+      return static_cast<double>(trial.compressed_bytes) / trial.raw_bytes +
+          seconds_per_megabyte * trial.seconds / megabytes;
+    };
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compress with the best algorithm, if any.
+   */
+  template <typename T>
+  bool apply(fitsfile* fptr, const ImageHdu::Initializer<T>& init);
+
+  /**
+   * @copydoc CompressionAction::selection()
+   */
+  const CompressionSelection* selection() const override
+  {
+    return m_selection ? &m_selection.value() : nullptr;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Measure a candidate algorithm and append it to the selection.
+   * @param action The candidate action, or `nullptr` if incompatible
+   * @param candidates The functions which apply the candidates, in the order of the trials
+   */
+  template <typename TAlgo, typename T>
+  void sample(
+      std::unique_ptr<Compress<TAlgo>> action,
+      const ImageHdu::Initializer<T>& init,
+      std::vector<std::function<void(fitsfile*)>>& candidates);
+
+  /**
+   * @brief The candidate generator.
+   */
+  CompressAuto m_auto;
+
+  /**
+   * @brief The maximum number of sample tiles.
+   */
+  Linx::Index m_sample_count;
+
+  /**
+   * @brief The cost function.
+   */
+  Cost m_cost;
+
+  /**
+   * @brief The report of the last selection.
+   */
+  std::optional<CompressionSelection> m_selection;
+};
+
+/**
+ * @ingroup compression
+ * @brief A compression action for binary tables.
+ * 
+ * Binary tables are compressed according to the FITS tiled table compression convention:
+ * rows are grouped into tiles, and each column of each tile is compressed independently
+ * (with shuffled GZIP or Rice, as selected by CFITSIO),
+ * such that columns can be read without decompressing the other ones.
+ * 
+ * Tables are compressed only if their data is known at creation,
+ * i.e. by `MefFile::append_bintable()` and `MefFile::append()`,
+ * and if their data unit is more than one block long.
+ * The table is first written in memory, and then compressed into the file.
+ * 
+ * Compressed binary tables are read-only.
+ * Their columns are transparently decompressed in memory the first time they are read (see `BintableHdu`).
+ * 
+ * \code
+ * MefFile f(filename, FileMode::Create, CompressAuto(), CompressBintables());
+ * f.append_bintable("CATALOG", {}, ra, dec, flux);
+ * \endcode
+ */
+class CompressBintables {
+public:
+
+  /// @group_operations
+
+  /**
+   * @brief Compress the current binary table of a file and append it to another file, if possible.
+   * @return `true` if the table was compressed, `false` if it is too small to be compressed
+   */
+  bool apply(fitsfile* from, fitsfile* to) const;
+
+  /// @}
+};
+
 } // namespace Fits
 
 /// @cond INTERNAL
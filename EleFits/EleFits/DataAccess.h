@@ -0,0 +1,126 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_DATAACCESS_H
+#define _ELEFITS_DATAACCESS_H
+
+#include "EleFitsData/Segment.h"
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Vector.h"
+
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace Fits {
+
+/**
+ * @ingroup strategy
+ * @brief The stage of a data access, as notified to the actions.
+ */
+enum class DataStage {
+  Reading = 0, ///< Just before reading
+  Read, ///< Just after reading
+  Writing, ///< Just before writing
+  Written ///< Just after writing
+};
+
+/**
+ * @ingroup strategy
+ * @brief A data unit access, as notified to the actions.
+ *
+ * For image HDUs, the accessed region is given by `front` and `shape`.
+ * For binary table HDUs, the accessed cells are given by `column` and `rows`.
+ * In both cases, the value type and the number of bytes are those of the values in memory,
+ * i.e. before compression or scaling,
+ * and with one byte per character for string columns.
+ *
+ * @see Action::reading()
+ */
+struct DataAccess {
+
+  /**
+   * @brief Create an image region access.
+   * @tparam T The value type in memory
+   */
+  template <typename T, Linx::Index N>
+  static DataAccess image(const Linx::Position<N>& front, const Linx::Position<N>& shape)
+  {
+    DataAccess out;
+    out.type = &typeid(std::decay_t<T>);
+    out.front = Linx::Position<-1>(std::vector<Linx::Index>(front.begin(), front.end()));
+    out.shape = Linx::Position<-1>(std::vector<Linx::Index>(shape.begin(), shape.end()));
+    out.bytes = value_size<T>();
+    for (auto length : shape) {
+      out.bytes *= length;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Create a binary table column segment access.
+   * @tparam T The value type in memory
+   */
+  template <typename T>
+  static DataAccess bintable(Linx::Index column, Segment rows, Linx::Index repeat_count)
+  {
+    DataAccess out;
+    out.type = &typeid(std::decay_t<T>);
+    out.column = column;
+    out.rows = rows;
+    out.bytes = rows.size() * repeat_count * value_size<T>();
+    return out;
+  }
+
+  /**
+   * @brief Get the size of a value, in bytes, with one byte per character for strings.
+   */
+  template <typename T>
+  static constexpr Linx::Index value_size()
+  {
+    return std::is_same<std::decay_t<T>, std::string>::value ? 1 : sizeof(T);
+  }
+
+  /**
+   * @brief Get the name of the value type, e.g. "int16", as in `ELEFITS_FOREACH_COLUMN_TYPE`.
+   * @return The name, or "void" for an unknown type
+   */
+  std::string type_name() const;
+
+  /**
+   * @brief Set the value type from its name.
+   * @throw FitsError if the name is not that of a supported type
+   * @see type_name()
+   */
+  void set_type(const std::string& name);
+
+  /**
+   * @brief Check whether the access is an image region access.
+   */
+  bool is_image() const
+  {
+    return column < 0;
+  }
+
+  /**
+   * @brief Get the image region.
+   */
+  Linx::Box<-1> region() const
+  {
+    return Linx::Box<-1>::from_shape(front, shape);
+  }
+
+  const std::type_info* type = &typeid(void); ///< The value type in memory
+  Linx::Position<-1> front; ///< The front position of the image region
+  Linx::Position<-1> shape; ///< The shape of the image region
+  Linx::Index column = -1; ///< The 0-based column index, or -1 for images
+  Segment rows {0, -1}; ///< The 0-based row segment of the column
+  Linx::Index bytes = 0; ///< The number of bytes
+};
+
+} // namespace Fits
+
+#endif
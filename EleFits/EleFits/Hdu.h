@@ -5,6 +5,7 @@
 #ifndef _ELEFITS_HDU_H
 #define _ELEFITS_HDU_H
 
+#include "EleFits/DataAccess.h"
 #include "EleFits/Header.h"
 #include "EleFitsData/DataUtils.h"
 #include "EleFitsData/HduCategory.h"
@@ -18,6 +19,10 @@
 namespace Fits {
 
 class MefFile; // necessary for friend class declaration in Hdu
+class ProfileIo; // idem
+class ImageRaster; // idem
+class BintableColumns; // idem
+class Strategy; // idem
 
 /**
  * @ingroup header_handlers
@@ -32,6 +37,12 @@ class Hdu {
   // A non-parent MefFile can be wanting to access the fitsfile of the parent MefFile of the hdu
   // FIXME: approach might be changed in the future
   friend class Fits::MefFile;
+  // The profiling action reads the counters of the fitsfile
+  friend class Fits::ProfileIo;
+  // The header and data handlers notify the strategy of records and data accesses
+  friend class Fits::Header;
+  friend class Fits::ImageRaster;
+  friend class Fits::BintableColumns;
 
 public:
 
@@ -53,6 +64,16 @@ public:
   private:
 
     Token() {}
+
+    /**
+     * @brief Create a token for an HDU which notifies a strategy of its data accesses.
+     */
+    explicit Token(Strategy* strategy) : m_strategy(strategy) {}
+
+    /**
+     * @brief The strategy to be notified, if any.
+     */
+    Strategy* m_strategy = nullptr;
   };
 
   /**
@@ -224,6 +245,21 @@ protected:
    */
   void edit() const;
 
+  /**
+   * @brief Check whether data accesses should be notified to the strategy.
+   */
+  bool observed() const;
+
+  /**
+   * @brief Notify the strategy of a data access.
+   */
+  void notify(DataStage stage, const DataAccess& access) const;
+
+  /**
+   * @brief Notify the strategy of parsed records.
+   */
+  void notify(const std::vector<std::string>& keywords) const;
+
   /**
    * @brief The parent file handler.
    * @warning
@@ -258,6 +294,11 @@ protected:
    */
   mutable HduCategory m_status;
 
+  /**
+   * @brief The strategy which is notified of data accesses, if any.
+   */
+  Strategy* m_strategy;
+
   /**
    * @brief Dummy file handler dedicated to dummy constructor.
    */
@@ -18,6 +18,8 @@
 
 namespace Fits {
 
+class Hdu; // necessary for the parent HDU pointer
+
 /**
  * @ingroup header_handlers
  * @brief Record writing modes.
@@ -80,8 +82,13 @@ private:
 
   /**
    * @brief Constructor.
+   * @param hdu The parent HDU, which notifies the parsed records, if any
    */
-  Header(fitsfile*& fptr, std::function<void(void)> touch, std::function<void(void)> edit);
+  Header(
+      fitsfile*& fptr,
+      std::function<void(void)> touch,
+      std::function<void(void)> edit,
+      const Hdu* hdu = nullptr);
 
 public:
 
@@ -482,6 +489,24 @@ public:
 
 private:
 
+  /**
+   * @brief Check whether parsed records should be notified.
+   */
+  bool observed() const;
+
+  /**
+   * @brief Notify parsed records.
+   * @details
+   * Each parsing method notifies its keywords once, including those which fell back to a default value.
+   */
+  void notify(const std::vector<std::string>& keywords) const;
+
+  /**
+   * @brief Parse a record if it exists, or get a fallback, without notifying.
+   */
+  template <typename T>
+  Record<T> parse_or_unobserved(const Record<T>& fallback) const;
+
   /**
    * @brief The fitsfile.
    */
@@ -496,6 +521,11 @@ private:
    * @brief The function to declare that the header was edited.
    */
   std::function<void(void)> m_edit;
+
+  /**
+   * @brief The parent HDU, if any.
+   */
+  const Hdu* m_hdu;
 };
 
 /**
@@ -9,8 +9,11 @@
 #include "EleFits/Hdu.h"
 #include "EleFits/ImageRaster.h"
 #include "EleFitsData/Compression.h"
+#include "EleFitsData/ImageStatistics.h"
 #include "EleFitsData/Raster.h"
 
+#include <optional>
+
 namespace Fits {
 
 /**
@@ -73,6 +76,31 @@ public:
      * @brief The data, if any.
      */
     const T* data;
+
+    /**
+     * @brief Get the statistics of the data, computed at the first call.
+     * @return The statistics, or `nullptr` if there is no data and no cached statistics
+     * @details
+     * The statistics are shared by all of the compression actions of a strategy,
+     * such that the data is scanned at most once whatever the number of actions.
+     */
+    const ImageStatistics* statistics() const
+    {
+      if (not statistics_cache) {
+        if (not data) {
+          return nullptr;
+        }
+        statistics_cache = ImageStatistics::from_data(data, shape_size(shape));
+      }
+      return &statistics_cache.value();
+    }
+
+    /**
+     * @brief The cached statistics, to be accessed with `statistics()`.
+     * @details
+     * When the data is not in memory, e.g. when streaming a copy, the statistics can be provided directly.
+     */
+    mutable std::optional<ImageStatistics> statistics_cache = std::nullopt;
   };
 
   /// @group_construction
@@ -97,6 +125,9 @@ public:
 
   /**
    * @brief Copy the contents of another image HDU.
+   * @details
+   * The data is streamed by tile-aligned slabs, such that large images are never fully loaded in memory.
+   * @see ImageRaster::stream_from()
    */
   const ImageHdu& operator=(const ImageHdu& rhs) const;
 
@@ -5,13 +5,19 @@
 #ifndef _ELEFITS_IMAGERASTER_H
 #define _ELEFITS_IMAGERASTER_H
 
+#include "EleFits/DataAccess.h"
+#include "EleFits/TileCache.h"
+#include "EleFitsData/ImageStatistics.h"
 #include "EleFitsData/Raster.h"
 
 #include <fitsio.h>
 #include <functional>
+#include <memory>
 
 namespace Fits {
 
+class Hdu; // necessary for the parent HDU pointer
+
 /**
  * @ingroup image_handlers
  * @brief Reader-writer for the image data unit.
@@ -31,8 +37,13 @@ private:
 
   /**
    * @brief Constructor.
+   * @param hdu The parent HDU, which notifies the data accesses, if any
    */
-  ImageRaster(fitsfile*& fptr, std::function<void(void)> touch, std::function<void(void)> edit);
+  ImageRaster(
+      fitsfile*& fptr,
+      std::function<void(void)> touch,
+      std::function<void(void)> edit,
+      const Hdu* hdu = nullptr);
 
 public:
 
@@ -97,6 +108,25 @@ public:
   template <typename TOut>
   void read_to(TOut& out) const;
 
+  /**
+   * @brief Read the whole data unit as a new raster, decompressing tiles in parallel.
+   * @param thread_count The number of threads, or 0 for the number of hardware threads
+   * 
+   * The output is identical to that of `read()`, but tiles are decompressed concurrently,
+   * which is mostly beneficial to large images.
+   * 
+   * @see Cfitsio::ImageCompression::read_parallel_to()
+   */
+  template <typename T, Linx::Index N = 2>
+  Linx::Raster<T, N> read_parallel(Linx::Index thread_count = 0) const;
+
+  /**
+   * @brief Read the whole data unit into an existing contiguous raster, decompressing tiles in parallel.
+   * @copydetails read_parallel()
+   */
+  template <typename TOut>
+  void read_parallel_to(TOut& out, Linx::Index thread_count = 0) const;
+
   /// @}
   /**
    * @name Read a region of the data unit
@@ -137,6 +167,32 @@ public:
   template <Linx::Index N, typename TOut>
   void read_region_to(Linx::Position<N> front, TOut& out) const;
 
+  /**
+   * @brief Enable the cache of decompressed tiles for region reads.
+   * @param byte_budget The maximum size of the cached tiles, in bytes
+   * @return The new cache
+   * 
+   * When enabled, region reads of compressed images decompress only the tiles which are not already cached.
+   * This is beneficial when reading many overlapping regions, e.g. postage stamps from a mosaic.
+   * The cache is cleared whenever the data unit is written.
+   * 
+   * The returned cache can be shared with other handlers of the same HDU,
+   * e.g. in other threads, with `cache_tiles(std::shared_ptr<TileCache>)`.
+   * 
+   * @see TileCache
+   */
+  std::shared_ptr<TileCache> cache_tiles(std::size_t byte_budget) const;
+
+  /**
+   * @brief Use an existing cache of decompressed tiles, or disable caching with `nullptr`.
+   */
+  void cache_tiles(std::shared_ptr<TileCache> cache) const;
+
+  /**
+   * @brief Get the cache of decompressed tiles, or `nullptr` if disabled.
+   */
+  const std::shared_ptr<TileCache>& tile_cache() const;
+
   /// @}
   /**
    * @name Write the whole data unit
@@ -150,6 +206,20 @@ public:
   template <typename TIn>
   void write(const TIn& in) const;
 
+  /**
+   * @brief Write the whole data unit, compressing tiles in parallel.
+   * @param in The raster to be written, which must be contiguous
+   * @param thread_count The number of threads, or 0 for the number of hardware threads
+   * 
+   * The output is identical to that of `write()`, but tiles are compressed concurrently,
+   * which is mostly beneficial to large images.
+   * This is meant for freshly created HDUs, e.g. with `MefFile::append_null_image()`.
+   * 
+   * @see Cfitsio::ImageCompression::write_parallel()
+   */
+  template <typename TIn>
+  void write_parallel(const TIn& in, Linx::Index thread_count = 0) const;
+
   /// @}
   /**
    * @name Write a region of the data unit
@@ -178,9 +248,79 @@ public:
   void update(const TIn& in) const;
 
   /// @}
+  /**
+   * @name Copy the data unit
+   */
+  /// @{
+
+  /**
+   * @brief The default buffer size of `stream_from()`, in bytes.
+   */
+  static constexpr std::size_t default_buffer_size = 1 << 24;
+
+  /**
+   * @brief Copy the data of another image, slab by slab.
+   * @tparam T The pixel type of the buffer
+   * @param src The source data unit, which may belong to another file
+   * @param buffer_size The maximum buffer size, in bytes
+   * 
+   * The data is copied by slabs along the last axis, such that the whole image is never held in memory.
+   * If the destination is compressed, slab thickness is a multiple of the tile size along the last axis,
+   * such that each tile is compressed exactly once;
+   * if the source is compressed, each tile is decompressed only once per slab.
+   * If a single slab does not fit the buffer, the buffer is enlarged accordingly.
+   * 
+   * The destination shape is assumed to already match that of the source, e.g. with `update_type_shape()`.
+   */
+  template <typename T>
+  void stream_from(const ImageRaster& src, std::size_t buffer_size = default_buffer_size) const;
+
+  /**
+   * @brief Compute the statistics of the data, slab by slab.
+   * @tparam T The pixel type of the buffer
+   * @param buffer_size The maximum buffer size, in bytes
+   * @details
+   * Like `stream_from()`, the data is read by slabs along the last axis,
+   * such that the whole image is never held in memory.
+   * @see ImageStatistics::Accumulator
+   */
+  template <typename T>
+  ImageStatistics read_statistics(std::size_t buffer_size = default_buffer_size) const;
+
+  /// @}
 
 private:
 
+  /**
+   * @brief Read a region of a compressed image through the tile cache.
+   */
+  template <Linx::Index N, typename TOut>
+  void read_cached_region_to(const Linx::Box<N>& region, TOut& out) const;
+
+  /**
+   * @brief Clear the tile cache, if any, before the data unit is modified.
+   */
+  void invalidate_tiles() const;
+
+  /**
+   * @brief Check whether data accesses should be notified.
+   */
+  bool observed() const;
+
+  /**
+   * @brief Notify a data access.
+   */
+  void notify(DataStage stage, const DataAccess& access) const;
+
+  /**
+   * @brief Run a data access, and notify it before and after if needed.
+   * @param writing Whether the access is a write
+   * @param access The function which describes the access, only called if the access is notified
+   * @param run The function which runs the access
+   */
+  template <typename TAccess, typename TRun>
+  void observe(bool writing, TAccess&& access, TRun&& run) const;
+
   /**
    * @brief The fitsfile.
    */
@@ -195,6 +335,16 @@ private:
    * @brief The function to declare that the header was edited.
    */
   std::function<void(void)> m_edit;
+
+  /**
+   * @brief The parent HDU, if any.
+   */
+  const Hdu* m_hdu;
+
+  /**
+   * @brief The tile cache, if any.
+   */
+  mutable std::shared_ptr<TileCache> m_cache;
 };
 
 } // namespace Fits
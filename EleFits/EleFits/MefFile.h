@@ -71,6 +71,12 @@ class HduSelector;
  * The strategy can be defined at construction, or with methods `strategy()`.
  * By default, the strategy consists of a `CiteEleFits` action, which can be disabled with `strategy().clear()`.
  * 
+ * Files opened with `FileMode::Read` are opened lazily:
+ * only the Primary header unit is read at construction,
+ * and the other HDUs are discovered when they are accessed, or when `hdu_count()` is first called.
+ * In this case, action `Action::opened()` is triggered at the first access to each HDU,
+ * and `Action::closing()` is triggered only for the HDUs which were accessed.
+ * 
  * @note
  * Single Image FITS files can be handled by this class, but `SifFile` is better suited:
  * it is safer and provides shortcuts.
@@ -117,6 +123,9 @@ public:
    * it is initialized by the constructor and then updated at each modification through `MefFile` methods.
    * This way, incomplete HDUs are also taken into account where CFITSIO would exclude them.
    * This means, for example, that the initial number of HDUs in a new file is 1 instead of 0 with CFITSIO.
+   * 
+   * For files opened with `FileMode::Read`, HDUs are counted at the first call only,
+   * because counting implies reading every header unit (see \ref optim-lazy-opening).
    */
   Linx::Index hdu_count() const;
 
@@ -253,6 +262,19 @@ public:
   template <typename T = Hdu>
   const T& append(const T& hdu);
 
+  /**
+  * @brief Append a copy of a given HDU as is, i.e. without applying the compression strategy.
+  * 
+  * Compressed image HDUs are copied without being decompressed, such that they remain compressed
+  * with the same parameters, whatever the compression strategy of the destination file.
+  * Other actions of the strategy are applied.
+  * 
+  * @warning
+  * The source and destination `MefFile`s must be different.
+  */
+  template <typename T = Hdu>
+  const T& append_verbatim(const T& hdu);
+
   /**
    * @brief Append a new image extension with empty data unit (`NAXIS = 0`).
    */
@@ -338,10 +360,12 @@ protected:
 
   /**
    * @brief Vector of `Hdu`s (castable to `ImageHdu` or `BintableHdu`).
+   * @details
+   * The vector is mutable, because it is completed lazily by `hdu_count()` for read-only files.
    * @warning
    * m_hdus is 0-based while Cfitsio HDUs are 1-based.
    */
-  std::vector<std::unique_ptr<Hdu>> m_hdus;
+  mutable std::vector<std::unique_ptr<Hdu>> m_hdus;
 
 private:
 
@@ -355,6 +379,38 @@ private:
    */
   void close_impl();
 
+  /**
+   * @brief Append a copy of an image HDU without loading the whole data unit in memory.
+   * @details
+   * If the strategy compresses, the statistics of the data are first computed by streaming the image,
+   * such that data-driven decisions (e.g. the Plio maximum value check or the quantization level)
+   * are the same as for in-memory images.
+   * The data itself is not available, such that `CompressSampled` falls back to `CompressAuto`.
+   * @see ImageRaster::stream_from()
+   */
+  template <typename T>
+  const ImageHdu& stream_image(const ImageHdu& image);
+
+  /**
+   * @brief Append a copy of a binary table, compressed or decompressed according to the strategy.
+   */
+  void copy_bintable(const Hdu& hdu);
+
+  /**
+   * @brief Append a binary table which was written in memory, compressed according to the strategy.
+   */
+  const BintableHdu& append_staged_bintable(const BintableHdu& staged);
+
+  /**
+   * @brief Whether HDUs are discovered on demand (for read-only files).
+   */
+  bool m_lazy;
+
+  /**
+   * @brief Whether `m_hdus` covers all of the HDUs.
+   */
+  mutable bool m_counted;
+
   /**
    * @brief The strategy.
    */
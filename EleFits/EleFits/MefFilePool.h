@@ -0,0 +1,186 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_MEFFILEPOOL_H
+#define _ELEFITS_MEFFILEPOOL_H
+
+#include "EleFits/MefFile.h"
+#include "Linx/Base/TypeUtils.h"
+
+#include <memory>
+
+namespace Fits {
+
+/// @cond INTERNAL
+namespace Internal {
+struct MefFilePoolState;
+}
+/// @endcond
+
+/**
+ * @ingroup file_handlers
+ * @brief Read-only multi-extension FITS file handler which can be shared among threads.
+ *
+ * A `MefFile` cannot be used concurrently, because CFITSIO's file handler stores a current HDU
+ * and I/O buffers.
+ * This class hands out one `MefFile` -- and therefore one CFITSIO handler -- per thread:
+ * the handler of the calling thread is opened at its first access and reused afterwards,
+ * such that `access()` and `find()` can be called concurrently from any number of threads.
+ *
+ * CFITSIO merges the handlers of a file which is opened several times in a process:
+ * they share a single `FITSfile` structure, with its position and buffers.
+ * To get independent handlers, each of them is opened through its own file descriptor,
+ * as `/proc/self/fd/<fd>`, which CFITSIO cannot recognize as the same file.
+ * Where this is not possible, e.g. without `/proc`, the pool is restricted to a single thread
+ * (see `is_concurrent()`).
+ *
+ * The returned references belong to the calling thread: they must not be passed to another thread.
+ * They remain valid until the pool is closed or destroyed, or until the thread calls `release()` or exits.
+ *
+ * @par_example
+ * \code
+ * MefFilePool pool(filename);
+ * std::vector<double> means(pool.hdu_count());
+ * #pragma omp parallel for
+ * for (Linx::Index i = 1; i < pool.hdu_count(); ++i) {
+ *   const auto raster = pool.access<ImageRaster>(i).read<float>();
+ *   means[i] = mean(raster);
+ * }
+ * \endcode
+ *
+ * @warning
+ * Concurrent accesses require that CFITSIO was built thread-safe (`--enable-reentrant`).
+ * Otherwise, opening a second handler throws a `FitsError`.
+ * The file name of the handlers, as returned by `MefFile::filename()`, may be their `/proc` alias.
+ *
+ * @see MefFile
+ */
+class MefFilePool {
+public:
+
+  /// @group_construction
+
+  /**
+   * @brief Open the handler of the calling thread.
+   */
+  explicit MefFilePool(const std::string& filename);
+
+  LINX_NON_COPYABLE(MefFilePool)
+  LINX_NON_MOVABLE(MefFilePool)
+
+  /**
+   * @brief Close all handlers.
+   */
+  ~MefFilePool() = default;
+
+  /// @group_properties
+
+  /**
+   * @brief Get the file name.
+   */
+  const std::string& filename() const;
+
+  /**
+   * @brief Get the number of HDUs.
+   * @see MefFile::hdu_count()
+   */
+  Linx::Index hdu_count();
+
+  /**
+   * @brief Get the number of open handlers.
+   */
+  Linx::Index handler_count() const;
+
+  /**
+   * @brief Check whether handlers can be used concurrently.
+   * @details
+   * This requires a reentrant CFITSIO and a way to open independent handlers.
+   */
+  static bool is_concurrent();
+
+  /// @group_elements
+
+  /**
+   * @brief Get the handler of the calling thread, and open it if needed.
+   */
+  MefFile& local();
+
+  /**
+   * @brief Access the HDU at given 0-based index through the handler of the calling thread.
+   * @see MefFile::access()
+   */
+  template <class T = Hdu>
+  const T& access(Linx::Index index);
+
+  /**
+   * @brief Access the first HDU with given name, type and version through the handler of the calling thread.
+   * @see MefFile::find()
+   */
+  template <class T = Hdu>
+  const T& find(const std::string& name, long version = 0);
+
+  /// @group_operations
+
+  /**
+   * @brief Apply a function to each HDU which matches a filter, in parallel.
+   * @tparam THdu The type of HDU or header or data unit handler passed to the function
+   * @param filter The HDU filter
+   * @param func The function, with signature `void(const THdu&)`
+   * @param thread_count The number of threads, or 0 for the number of hardware threads
+   * @details
+   * HDUs are distributed among the threads with work stealing (see `Parallel::for_each_index()`),
+   * such that a few large HDUs do not stall the other threads.
+   * Each thread accesses the HDUs through its own handler, including for filtering.
+   * The calling thread is one of the workers.
+   * The handlers of the other workers are closed when they exit.
+   * If `is_concurrent()` is false, the HDUs are processed by the calling thread only.
+   *
+   * If the function throws, no new HDU is processed, and the first exception is rethrown once all threads are done.
+   *
+   * @par_example
+   * \code
+   * std::vector<double> means(pool.hdu_count());
+   * pool.parallel_for_each<ImageHdu>(HduCategory::Image - HduCategory::Metadata, [&](const auto& hdu) {
+   *   means[hdu.index()] = mean(hdu.raster().template read<float, -1>());
+   * });
+   * \endcode
+   */
+  template <typename THdu = Hdu, typename TFunc>
+  void parallel_for_each(const HduFilter& filter, TFunc&& func, Linx::Index thread_count = 0);
+
+  /// @group_modifiers
+
+  /**
+   * @brief Close the handler of the calling thread, if any.
+   * @details
+   * This is done automatically when a thread exits.
+   */
+  void release();
+
+  /**
+   * @brief Close all handlers.
+   * @warning
+   * No thread should be accessing the file anymore.
+   */
+  void close();
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The file name and handlers, shared with the threads which release their handler at exit.
+   */
+  std::shared_ptr<Internal::MefFilePoolState> m_state;
+};
+
+} // namespace Fits
+
+/// @cond INTERNAL
+#define _ELEFITS_MEFFILEPOOL_IMPL
+#include "EleFits/impl/MefFilePool.hpp"
+#undef _ELEFITS_MEFFILEPOOL_IMPL
+/// @endcond
+
+#endif
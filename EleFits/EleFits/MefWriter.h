@@ -0,0 +1,249 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_MEFWRITER_H
+#define _ELEFITS_MEFWRITER_H
+
+#include "EleFits/MefFile.h"
+#include "Linx/Base/TypeUtils.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Fits {
+
+/**
+ * @ingroup file_handlers
+ * @brief Write-behind multi-extension FITS file writer.
+ *
+ * This handler owns a `MefFile` which is exclusively accessed from a dedicated I/O thread.
+ * Methods `append_image()` and `append_bintable()` take ownership of the data (ideally by move),
+ * non-owning data (e.g. `PtrRaster` or `PtrColumn`) being deep-copied,
+ * enqueue them and return immediately, while the I/O thread serializes the extensions into the file
+ * in the order of the calls.
+ * This way, producing the data of an extension overlaps with writing the previous ones.
+ *
+ * The queue is bounded by a byte budget:
+ * when the total size of the pending data would exceed the budget, appending blocks
+ * until enough extensions have been written (backpressure).
+ * An extension which is larger than the budget is accepted as soon as the queue is empty.
+ *
+ * Errors raised by the I/O thread cannot be thrown at the time they occur.
+ * Instead, the first error is stored, subsequent pending extensions are dropped,
+ * and the error is rethrown by the next calls to `append_image()`, `append_bintable()`, `flush()` or `close()`.
+ * The file is closed anyway by `close()` and the destructor.
+ *
+ * @par_example
+ * \code
+ * MefWriter f(filename, FileMode::Create, 256 << 20);
+ * for (const auto& name : names) {
+ *   auto raster = process(name); // Overlaps with the writing of the previous raster
+ *   f.append_image(name, {}, std::move(raster));
+ * }
+ * f.close(); // Waits for the I/O thread and rethrows any pending error
+ * \endcode
+ *
+ * @warning
+ * The underlying `MefFile` must not be used directly while extensions are pending.
+ * It can be accessed safely through the reference returned by `flush()`,
+ * until the next call to an append method.
+ *
+ * @see MefFile
+ */
+class MefWriter {
+public:
+
+  /// @group_construction
+
+  /**
+   * @brief Create a writer and start the I/O thread.
+   * @param filename The file name
+   * @param mode The opening mode (which must not be `FileMode::Read`)
+   * @param byte_budget The maximum number of pending bytes
+   * @param actions The strategy or list of actions
+   */
+  template <typename... TActions>
+  explicit MefWriter(const std::string& filename, FileMode mode, std::size_t byte_budget, TActions&&... actions);
+
+  LINX_NON_COPYABLE(MefWriter)
+  LINX_NON_MOVABLE(MefWriter)
+
+  /**
+   * @brief Wait for pending extensions, stop the I/O thread and close the file.
+   * @details
+   * As opposed to `close()`, pending errors are silently discarded, because destructors cannot throw.
+   */
+  ~MefWriter();
+
+  /// @group_properties
+
+  /**
+   * @brief Get the byte budget.
+   */
+  std::size_t byte_budget() const;
+
+  /**
+   * @brief Get the number of bytes which are currently pending.
+   */
+  std::size_t pending_bytes() const;
+
+  /**
+   * @brief Get the number of HDUs, including the pending ones.
+   */
+  Linx::Index hdu_count() const;
+
+  /// @group_modifiers
+
+  /**
+   * @brief Enqueue a new image extension.
+   * @param name The extension name (or an empty string to not write any)
+   * @param records The sequence of records to be written in addition to structural records
+   * @param raster The data, which is moved if given as an owning rvalue, and deep-copied otherwise
+   * @return The index of the future HDU
+   * @see MefFile::append_image()
+   */
+  template <typename TRaster>
+  Linx::Index append_image(const std::string& name, const RecordSeq& records, TRaster&& raster);
+
+  /**
+   * @brief Enqueue a new binary table extension.
+   * @param name The extension name (or an empty string to not write any)
+   * @param records The sequence of records to be written in addition to structural records
+   * @param columns The columns, which are moved if given as owning rvalues, and deep-copied otherwise
+   * @return The index of the future HDU
+   * @see MefFile::append_bintable()
+   */
+  template <typename... TColumns>
+  Linx::Index append_bintable(const std::string& name, const RecordSeq& records, TColumns&&... columns);
+
+  /**
+   * @brief Wait for all pending extensions to be written.
+   * @return The underlying `MefFile`, which can be used until the next call to an append method.
+   * @details
+   * Rethrows the error raised by the I/O thread, if any.
+   */
+  MefFile& flush();
+
+  /**
+   * @brief Wait for pending extensions, stop the I/O thread and close the file.
+   * @details
+   * Rethrows the error raised by the I/O thread, if any.
+   */
+  void close();
+
+  /// @}
+
+private:
+
+  /**
+   * @brief An enqueued write operation.
+   */
+  struct Task {
+    std::function<void(MefFile&)> write; ///< The operation
+    std::size_t bytes; ///< The size of the held data
+  };
+
+  /**
+   * @brief Enqueue a task, possibly blocking until the budget allows it.
+   */
+  Linx::Index enqueue(std::function<void(MefFile&)> write, std::size_t bytes);
+
+  /**
+   * @brief Body of the I/O thread.
+   */
+  void run();
+
+  /**
+   * @brief Wait for the queue to be empty.
+   * @warning
+   * Requires the lock to be owned.
+   */
+  void wait_empty(std::unique_lock<std::mutex>& lock);
+
+  /**
+   * @brief Rethrow the error raised by the I/O thread, if any.
+   * @warning
+   * Requires the lock to be owned.
+   */
+  void may_rethrow();
+
+  /**
+   * @brief Stop and join the I/O thread, and close the file.
+   */
+  void stop();
+
+  /**
+   * @brief The file, only accessed by the I/O thread while the queue is not empty.
+   */
+  MefFile m_file;
+
+  /**
+   * @brief The byte budget.
+   */
+  std::size_t m_budget;
+
+  /**
+   * @brief The pending tasks.
+   */
+  std::deque<Task> m_queue;
+
+  /**
+   * @brief The number of pending bytes, including the task being processed.
+   */
+  std::size_t m_pending_bytes;
+
+  /**
+   * @brief The number of HDUs, including pending ones.
+   */
+  Linx::Index m_hdu_count;
+
+  /**
+   * @brief Whether the I/O thread is processing a task.
+   */
+  bool m_busy;
+
+  /**
+   * @brief Whether the I/O thread should stop once the queue is empty.
+   */
+  bool m_stopping;
+
+  /**
+   * @brief The first error raised by the I/O thread.
+   */
+  std::exception_ptr m_error;
+
+  /**
+   * @brief The mutex which protects the members above, except `m_file`.
+   */
+  mutable std::mutex m_mutex;
+
+  /**
+   * @brief The condition variable to notify the I/O thread that a task is available.
+   */
+  std::condition_variable m_not_empty;
+
+  /**
+   * @brief The condition variable to notify producers that some budget was released.
+   */
+  std::condition_variable m_released;
+
+  /**
+   * @brief The I/O thread.
+   */
+  std::thread m_thread;
+};
+
+} // namespace Fits
+
+/// @cond INTERNAL
+#define _ELEFITS_MEFWRITER_IMPL
+#include "EleFits/impl/MefWriter.hpp"
+#undef _ELEFITS_MEFWRITER_IMPL
+/// @endcond
+
+#endif
@@ -0,0 +1,292 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_SHARDEDMEFWRITER_H
+#define _ELEFITS_SHARDEDMEFWRITER_H
+
+#include "EleFits/MefWriter.h"
+#include "Linx/Base/TypeUtils.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Fits {
+
+/**
+ * @ingroup file_handlers
+ * @brief Write-behind writer which distributes extensions among many files, written by a bounded pool of threads.
+ *
+ * A single FITS file is written sequentially by a single CFITSIO handler, whatever the number of threads.
+ * To scale writing, extensions are routed to files by a user-provided key,
+ * which is mapped to a file name by a user-provided function.
+ * The files are created at their first extension, such that the set of outputs needs not be known in advance,
+ * and are written by a fixed number of worker threads, whatever the number of files.
+ * All CFITSIO calls, including file creation, are made by the workers,
+ * such that they are serialized when a single worker is used (e.g. if CFITSIO is not reentrant).
+ * Since the files are new, the location of an extension is known as soon as it is enqueued.
+ *
+ * Each file is written by at most one worker at a time,
+ * such that extensions with the same file name end up in the file in the order of the calls.
+ * Files are served in a round-robin fashion, one extension at a time.
+ *
+ * Like with `MefWriter`, appending takes ownership of the data,
+ * and the pending data of all files are bounded by a common byte budget (backpressure).
+ * The first error raised by a worker is stored, subsequent pending extensions are dropped,
+ * and the error is rethrown by the next calls to the append methods, `flush()` or `close()`.
+ *
+ * @par_example
+ * \code
+ * auto mapping = [](const std::string& key) {
+ *   return "tile_" + key + ".fits";
+ * };
+ * ShardedMefWriter f(mapping, FileMode::Create, 4, 256 << 20);
+ * for (const auto& tile : tiles) {
+ *   f.append_image(tile.id, tile.name, {}, std::move(tile.raster));
+ * }
+ * f.close();
+ * \endcode
+ *
+ * @warning
+ * All the files are kept open until `close()`, such that their number is limited by CFITSIO
+ * (see `NMAXFILES` in `fitsio.h`).
+ *
+ * @see MefWriter
+ */
+class ShardedMefWriter {
+public:
+
+  /**
+   * @brief The function which maps a key to a file name.
+   */
+  using Mapping = std::function<std::string(const std::string&)>;
+
+  /**
+   * @brief The location of an extension, as a file name and HDU index.
+   */
+  using Location = std::pair<std::string, Linx::Index>;
+
+  /// @group_construction
+
+  /**
+   * @brief Create a writer and start the worker threads.
+   * @param mapping The function which maps a key to a file name
+   * @param mode The opening mode of the files, which must create new files
+   * (i.e. `FileMode::Create`, `FileMode::Overwrite` or `FileMode::Temporary`)
+   * @param worker_count The number of worker threads, or 0 for the number of hardware threads
+   * (a single worker is used if CFITSIO is not reentrant)
+   * @param byte_budget The maximum number of pending bytes, for all files
+   * @param actions The strategy or list of actions, which is copied to each file
+   */
+  template <typename... TActions>
+  explicit ShardedMefWriter(
+      Mapping mapping,
+      FileMode mode,
+      Linx::Index worker_count,
+      std::size_t byte_budget,
+      const TActions&... actions);
+
+  LINX_NON_COPYABLE(ShardedMefWriter)
+  LINX_NON_MOVABLE(ShardedMefWriter)
+
+  /**
+   * @brief Wait for pending extensions, stop the worker threads and close the files.
+   * @details
+   * As opposed to `close()`, pending errors are silently discarded, because destructors cannot throw.
+   */
+  ~ShardedMefWriter();
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of worker threads.
+   */
+  Linx::Index worker_count() const;
+
+  /**
+   * @brief Get the number of files routed so far, including those which are not created yet.
+   */
+  Linx::Index file_count() const;
+
+  /**
+   * @brief Get the byte budget.
+   */
+  std::size_t byte_budget() const;
+
+  /**
+   * @brief Get the number of bytes which are currently pending.
+   */
+  std::size_t pending_bytes() const;
+
+  /**
+   * @brief Get the file name associated with some key.
+   */
+  std::string filename(const std::string& key) const;
+
+  /// @group_modifiers
+
+  /**
+   * @brief Enqueue a new image extension in the file associated with some key.
+   * @return The location of the future HDU
+   * @see MefWriter::append_image()
+   */
+  template <typename TRaster>
+  Location append_image(const std::string& key, const std::string& name, const RecordSeq& records, TRaster&& raster);
+
+  /**
+   * @brief Enqueue a new binary table extension in the file associated with some key.
+   * @return The location of the future HDU
+   * @see MefWriter::append_bintable()
+   */
+  template <typename... TColumns>
+  Location
+  append_bintable(const std::string& key, const std::string& name, const RecordSeq& records, TColumns&&... columns);
+
+  /**
+   * @brief Wait for all pending extensions to be written.
+   * @details
+   * Rethrows the first error raised by the workers, if any.
+   */
+  void flush();
+
+  /**
+   * @brief Wait for pending extensions, stop the worker threads and close the files.
+   * @details
+   * All files are closed, even if some of them failed,
+   * and the first error is rethrown afterwards.
+   */
+  void close();
+
+  /// @}
+
+private:
+
+  /**
+   * @brief An enqueued write operation.
+   */
+  struct Task {
+    std::function<void(MefFile&)> write; ///< The operation
+    std::size_t bytes; ///< The size of the held data
+  };
+
+  /**
+   * @brief An output file and its pending tasks.
+   */
+  struct Shard {
+    std::string filename; ///< The file name
+    std::unique_ptr<MefFile> file; ///< The file, created by the worker which runs the first task
+    std::deque<Task> queue; ///< The pending tasks
+    Linx::Index hdu_count; ///< The number of HDUs, including pending ones
+    bool scheduled; ///< Whether the shard is in the ready queue or being written
+  };
+
+  /**
+   * @brief Start the worker threads.
+   */
+  void start(Linx::Index worker_count);
+
+  /**
+   * @brief Enqueue a task, possibly blocking until the budget allows it.
+   */
+  Location enqueue(const std::string& key, std::function<void(MefFile&)> write, std::size_t bytes);
+
+  /**
+   * @brief Body of the worker threads.
+   */
+  void run();
+
+  /**
+   * @brief Rethrow the first error raised by the workers, if any.
+   * @warning
+   * Requires the lock to be owned.
+   */
+  void may_rethrow();
+
+  /**
+   * @brief Stop and join the worker threads, and close the files.
+   */
+  void stop();
+
+  /**
+   * @brief The key-to-file-name mapping.
+   */
+  Mapping m_mapping;
+
+  /**
+   * @brief The file opening function, which captures the mode and actions.
+   */
+  std::function<std::unique_ptr<MefFile>(const std::string&)> m_open;
+
+  /**
+   * @brief The byte budget.
+   */
+  std::size_t m_budget;
+
+  /**
+   * @brief The shards, by file name.
+   */
+  std::unordered_map<std::string, std::unique_ptr<Shard>> m_shards;
+
+  /**
+   * @brief The shards which have pending tasks and are not being written.
+   */
+  std::deque<Shard*> m_ready;
+
+  /**
+   * @brief The number of pending bytes, including the tasks being processed.
+   */
+  std::size_t m_pending_bytes;
+
+  /**
+   * @brief The number of pending tasks, including the tasks being processed.
+   */
+  Linx::Index m_pending_count;
+
+  /**
+   * @brief Whether the workers should stop once the queues are empty.
+   */
+  bool m_stopping;
+
+  /**
+   * @brief The first error raised by the workers or when closing the files.
+   */
+  std::exception_ptr m_error;
+
+  /**
+   * @brief The mutex which protects the members above, except the files.
+   */
+  mutable std::mutex m_mutex;
+
+  /**
+   * @brief The condition variable to notify the workers that a shard is ready.
+   */
+  std::condition_variable m_ready_cv;
+
+  /**
+   * @brief The condition variable to notify producers that some budget was released.
+   */
+  std::condition_variable m_released;
+
+  /**
+   * @brief The worker threads.
+   */
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace Fits
+
+/// @cond INTERNAL
+#define _ELEFITS_SHARDEDMEFWRITER_IMPL
+#include "EleFits/impl/ShardedMefWriter.hpp"
+#undef _ELEFITS_SHARDEDMEFWRITER_IMPL
+/// @endcond
+
+#endif
@@ -9,6 +9,7 @@
 #include "EleFits/CompressionStrategy.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace Fits {
@@ -24,6 +25,7 @@ namespace Fits {
  * In this case, compression actions are not performed one after the other:
  * instead, they are tried one after the other, and the iteration stops as soon as a suitable compression action is found.
  * If none is suitable, then compression is disabled. 
+ * Binary table compression is enabled separately, by appending a `CompressBintables` action.
  */
 class Strategy {
   friend class MefFile;
@@ -49,12 +51,19 @@ public:
       for (auto&& e : action.m_actions) {
         m_actions.push_back(std::move(e));
       }
+      m_observes_data = m_observes_data || action.m_observes_data;
+      if (action.m_bintable_compression) {
+        m_bintable_compression = std::move(action.m_bintable_compression);
+      }
+    } else if constexpr (std::is_same_v<CompressBintables, Decay>) {
+      m_bintable_compression = std::forward<TAction>(action);
     } else if constexpr (std::is_base_of_v<Compression, Decay>) {
       m_compression.push_back(std::make_unique<Compress<Decay>>(std::forward<TAction>(action)));
     } else if constexpr (std::is_base_of_v<CompressionAction, Decay>) {
       m_compression.push_back(std::make_unique<Decay>(std::forward<TAction>(action)));
     } else {
       m_actions.push_back(std::make_unique<Decay>(std::forward<TAction>(action)));
+      m_observes_data = m_observes_data || m_actions.back()->observes_data();
     }
   }
 
@@ -78,7 +87,9 @@ public:
   Strategy& clear()
   {
     m_compression.clear();
+    m_bintable_compression.reset();
     m_actions.clear();
+    m_observes_data = false;
     return *this;
   }
 
@@ -134,6 +145,60 @@ public:
     }
   }
 
+  /**
+   * @copydoc Action::selected
+   */
+  void selected(const CompressionSelection& selection)
+  {
+    for (auto& a : m_actions) {
+      a->selected(selection);
+    }
+  }
+
+  /**
+   * @copydoc Action::parsed
+   */
+  void parsed(const Hdu& hdu, const std::vector<std::string>& keywords)
+  {
+    for (auto& a : m_actions) {
+      a->parsed(hdu, keywords);
+    }
+  }
+
+  /**
+   * @brief Check whether data accesses should be notified, i.e. whether some action observes them.
+   * @details
+   * The result is cached when actions are appended, because it is checked at each data access.
+   * @see Action::observes_data()
+   */
+  bool observes_data() const
+  {
+    return m_observes_data;
+  }
+
+  /**
+   * @brief Call `Action::reading()`, `Action::read()`, `Action::writing()` or `Action::written()`.
+   */
+  void notify(const Hdu& hdu, DataStage stage, const DataAccess& access)
+  {
+    for (auto& a : m_actions) {
+      switch (stage) {
+        case DataStage::Reading:
+          a->reading(hdu, access);
+          break;
+        case DataStage::Read:
+          a->read(hdu, access);
+          break;
+        case DataStage::Writing:
+          a->writing(hdu, access);
+          break;
+        case DataStage::Written:
+          a->written(hdu, access);
+          break;
+      }
+    }
+  }
+
   /// @}
 
 private:
@@ -145,7 +210,11 @@ private:
   bool compress(fitsfile* fptr, const ImageHdu::Initializer<T>& init)
   {
     for (const auto& c : m_compression) {
-      if ((*c)(fptr, init)) {
+      const auto compressed = (*c)(fptr, init);
+      if (const auto* selection = c->selection()) {
+        selected(*selection);
+      }
+      if (compressed) {
         return true;
       }
     }
@@ -153,15 +222,42 @@ private:
     return false;
   }
 
+  /**
+   * @brief Know whether binary tables are compressed.
+   */
+  bool compresses_bintables() const
+  {
+    return m_bintable_compression.has_value();
+  }
+
+  /**
+   * @brief Compress the current binary table of a file into another file according to the strategy.
+   * @return `true` if the table was compressed
+   */
+  bool compress_bintable(fitsfile* from, fitsfile* to) const
+  {
+    return m_bintable_compression && m_bintable_compression->apply(from, to);
+  }
+
   /**
    * @brief The compression strategy.
    */
   std::vector<std::unique_ptr<CompressionAction>> m_compression;
 
+  /**
+   * @brief The binary table compression action, if any.
+   */
+  std::optional<CompressBintables> m_bintable_compression;
+
   /**
    * @brief The actions.
    */
   std::vector<std::unique_ptr<Action>> m_actions;
+
+  /**
+   * @brief Whether some action observes data accesses.
+   */
+  bool m_observes_data = false;
 };
 
 } // namespace Fits
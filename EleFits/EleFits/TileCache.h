@@ -0,0 +1,179 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_TILECACHE_H
+#define _ELEFITS_TILECACHE_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <vector>
+
+namespace Fits {
+
+/**
+ * @ingroup image_handlers
+ * @brief Least-recently-used cache of decompressed tiles, with a byte budget.
+ *
+ * When enabled on an `ImageRaster` (see `ImageRaster::cache_tiles()`),
+ * region reads of compressed images go through the cache:
+ * the tiles which intersect the region are decompressed only if they are not already cached,
+ * such that overlapping regions share the decompression cost.
+ * When the byte budget is exceeded, the least recently used tiles are evicted.
+ *
+ * Tiles are identified by their index in the tile table and by their pixel type,
+ * such that the same tile read as `float` and as `double` is cached twice.
+ *
+ * The cache is thread-safe: it can be shared by several handlers of the same HDU,
+ * e.g. those of a `MefFilePool`.
+ * The tiles are decompressed outside of the lock,
+ * such that a tile missed by two threads at the same time may be decompressed twice.
+ *
+ * @see ImageRaster::cache_tiles()
+ */
+class TileCache {
+public:
+
+  /// @group_construction
+
+  /**
+   * @brief Create an empty cache.
+   * @param byte_budget The maximum size of the cached tiles, in bytes
+   */
+  explicit TileCache(std::size_t byte_budget);
+
+  LINX_NON_COPYABLE(TileCache)
+  LINX_NON_MOVABLE(TileCache)
+
+  /**
+   * @brief Destructor.
+   */
+  ~TileCache() = default;
+
+  /// @group_properties
+
+  /**
+   * @brief Get the byte budget.
+   */
+  std::size_t byte_budget() const;
+
+  /**
+   * @brief Get the size of the cached tiles, in bytes.
+   */
+  std::size_t size_in_bytes() const;
+
+  /**
+   * @brief Get the number of cached tiles.
+   */
+  Linx::Index tile_count() const;
+
+  /**
+   * @brief Get the number of requests which were served by the cache.
+   */
+  Linx::Index hit_count() const;
+
+  /**
+   * @brief Get the number of requests which required a decompression.
+   */
+  Linx::Index miss_count() const;
+
+  /// @group_operations
+
+  /**
+   * @brief Get a tile, and load it if needed.
+   * @param index The tile index
+   * @param load The loading function, of signature `std::vector<T>()`
+   * @details
+   * If the tile is larger than the budget, it is returned but not cached.
+   */
+  template <typename T, typename TFunc>
+  std::shared_ptr<const std::vector<T>> get(Linx::Index index, TFunc&& load);
+
+  /// @group_modifiers
+
+  /**
+   * @brief Remove all of the tiles, e.g. because the data unit was modified.
+   * @details
+   * The hit and miss counters are not reset.
+   */
+  void clear();
+
+  /// @}
+
+private:
+
+  /**
+   * @brief A tile key: index and pixel type.
+   */
+  using Key = std::pair<Linx::Index, std::type_index>;
+
+  /**
+   * @brief A cached tile.
+   */
+  struct Entry {
+    Key key; ///< The key
+    std::shared_ptr<const void> data; ///< The type-erased `std::vector<T>`
+    std::size_t bytes; ///< The size in bytes
+  };
+
+  /**
+   * @brief Find a tile, mark it as most recently used, and count the hit or miss.
+   * @return The tile data, or `nullptr` if the tile is not cached
+   */
+  std::shared_ptr<const void> find(const Key& key);
+
+  /**
+   * @brief Insert a tile and evict the least recently used tiles as needed.
+   */
+  void insert(const Key& key, std::shared_ptr<const void> data, std::size_t bytes);
+
+  /**
+   * @brief The byte budget.
+   */
+  std::size_t m_budget;
+
+  /**
+   * @brief The size of the cached tiles.
+   */
+  std::size_t m_bytes;
+
+  /**
+   * @brief The hit count.
+   */
+  Linx::Index m_hits;
+
+  /**
+   * @brief The miss count.
+   */
+  Linx::Index m_misses;
+
+  /**
+   * @brief The tiles, from the most to the least recently used.
+   */
+  std::list<Entry> m_entries;
+
+  /**
+   * @brief The tiles, by key.
+   */
+  std::map<Key, std::list<Entry>::iterator> m_index;
+
+  /**
+   * @brief The mutex.
+   */
+  mutable std::mutex m_mutex;
+};
+
+} // namespace Fits
+
+/// @cond INTERNAL
+#define _ELEFITS_TILECACHE_IMPL
+#include "EleFits/impl/TileCache.hpp"
+#undef _ELEFITS_TILECACHE_IMPL
+/// @endcond
+
+#endif
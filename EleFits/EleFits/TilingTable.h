@@ -0,0 +1,119 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_TILINGTABLE_H
+#define _ELEFITS_TILINGTABLE_H
+
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Vector.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace Fits {
+
+/**
+ * @ingroup compression
+ * @brief A table of tuned tilings, indexed by compression algorithm, BITPIX and image dimension.
+ *
+ * When a table is installed with `TilingTable::install()`,
+ * adaptive tilings (see `Tile::adaptive()`) are first looked up in it,
+ * and the built-in heuristics are only used for the missing entries.
+ *
+ * Tilings are stored as in `Compression::tiling()`, e.g. `Tile::rowwise(16)`,
+ * such that they apply to any image shape: -1 means a full axis,
+ * and lengths greater than the image ones are clamped by CFITSIO.
+ * A BITPIX of 0 means any BITPIX, and is used when there is no exact match.
+ * Entries only apply to images of their dimension (i.e. number of axes),
+ * since a tiling tuned for 2D images is generally not relevant to, e.g., data cubes:
+ * other images fall back to the built-in heuristics.
+ *
+ * Tables are stored as CSV files with one row per entry, e.g.:
+ *
+ * \verbatim
+ Algorithm,Bitpix,Dimension,Tiling
+ HCompress,16,2,-1 16
+ Rice,0,2,256 256
+ Rice,0,3,256 256 1
+ \endverbatim
+ *
+ * where the algorithm is one of `Gzip`, `ShuffledGzip`, `Rice`, `HCompress` and `Plio`.
+ * Such tables are output by the tiling optimizer, `EleFitsOptimizeTiling`.
+ */
+class TilingTable {
+public:
+
+  /// @group_construction
+
+  /**
+   * @brief Create an empty table.
+   */
+  TilingTable() = default;
+
+  /**
+   * @brief Load a table from a CSV file.
+   * @details
+   * Empty lines, lines which start with '#' and the header line are skipped,
+   * as well as any column after the fourth one.
+   */
+  static TilingTable load(const std::string& filename);
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of entries.
+   */
+  Linx::Index size() const;
+
+  /// @group_elements
+
+  /**
+   * @brief Get the tiling of an algorithm for some BITPIX and image dimension.
+   * @return The tiling, the tiling for any BITPIX as a fallback, or `nullptr` if there is none.
+   */
+  const Linx::Position<-1>* find(const std::string& algorithm, Linx::Index bitpix, Linx::Index dimension) const;
+
+  /// @group_modifiers
+
+  /**
+   * @brief Set the tiling of an algorithm for some BITPIX (0 for any BITPIX) and image dimension.
+   */
+  void set(const std::string& algorithm, Linx::Index bitpix, Linx::Index dimension, Linx::Position<-1> tiling);
+
+  /// @group_operations
+
+  /**
+   * @brief Save the table as a CSV file.
+   */
+  void save(const std::string& filename) const;
+
+  /**
+   * @brief Install a table to be used by the adaptive tilings.
+   * @details
+   * Pass `nullptr` to get back to the built-in heuristics.
+   * This function is thread-safe,
+   * yet compression actions which are being applied may still use the previous table.
+   */
+  static void install(std::shared_ptr<const TilingTable> table);
+
+  /**
+   * @brief Get the installed table, if any.
+   */
+  static std::shared_ptr<const TilingTable> installed();
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The tilings, by algorithm, BITPIX and dimension.
+   */
+  std::map<std::tuple<std::string, Linx::Index, Linx::Index>, Linx::Position<-1>> m_tilings;
+};
+
+} // namespace Fits
+
+#endif
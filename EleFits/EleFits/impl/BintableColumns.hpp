@@ -79,12 +79,20 @@ void BintableColumns::read_segment_to(FileMemSegments rows, ColumnKey key, TColu
   m_touch();
   rows.resolve(read_row_count() - 1, column.row_count() - 1);
   auto slice = column.slice(rows.memory()); // TODO do we need a temporary variable?
-  Cfitsio::BintableIo::read_column_data(
-      m_fptr,
-      Segment {rows.file().front + 1, rows.file().back + 1}, // TODO operator+
-      key.index(*this) + 1, // 1-based
-      column.info().repeat_count(),
-      &column(rows.memory().front, 0));
+  const auto index = key.index(*this);
+  observe(
+      false,
+      [&]() {
+        return DataAccess::bintable<typename TColumn::Value>(index, rows.file(), column.info().repeat_count());
+      },
+      [&]() {
+        Cfitsio::BintableIo::read_column_data(
+            m_fptr,
+            Segment {rows.file().front + 1, rows.file().back + 1}, // TODO operator+
+            index + 1, // 1-based
+            column.info().repeat_count(),
+            &column(rows.memory().front, 0));
+      });
 }
 
 // read_n
@@ -248,12 +256,19 @@ void BintableColumns::write_segment(FileMemSegments rows, const TColumn& column)
   m_edit();
   rows.resolve(read_row_count() - 1, column.row_count() - 1);
   const auto index = read_index(column.info().name); // FIXME avoid?
-  Cfitsio::BintableIo::write_column_data(
-      m_fptr,
-      rows.file() + 1,
-      index + 1,
-      column.info().repeat_count(),
-      &column(rows.memory().front, 0));
+  observe(
+      true,
+      [&]() {
+        return DataAccess::bintable<typename TColumn::Value>(index, rows.file(), column.info().repeat_count());
+      },
+      [&]() {
+        Cfitsio::BintableIo::write_column_data(
+            m_fptr,
+            rows.file() + 1,
+            index + 1,
+            column.info().repeat_count(),
+            &column(rows.memory().front, 0));
+      });
 }
 
 // write_n
@@ -332,6 +347,19 @@ void BintableColumns::write_n_segments(FileMemSegments rows, const TColumns&...
   write_n_segments(std::move(rows), std::forward_as_tuple(columns...));
 }
 
+template <typename TAccess, typename TRun>
+void BintableColumns::observe(bool writing, TAccess&& access, TRun&& run) const
+{
+  if (not observed()) {
+    run();
+    return;
+  }
+  const DataAccess description = access();
+  notify(writing ? DataStage::Writing : DataStage::Reading, description);
+  run();
+  notify(writing ? DataStage::Written : DataStage::Read, description);
+}
+
 template <typename TSeq>
 Linx::Index columns_row_count(TSeq&& columns)
 {
@@ -4,9 +4,14 @@
 
 #if defined(_ELEFITS_COMPRESSIONSTRATEGY_IMPL) || defined(CHECK_QUALITY)
 
+#include "EleCfitsioWrapper/HeaderWrapper.h"
 #include "EleFits/CompressionStrategy.h"
 #include "EleFitsData/DataUtils.h"
 
+#include <algorithm> // copy_n, min_element
+#include <chrono>
+#include <vector>
+
 namespace Fits {
 
 /// @cond
@@ -42,6 +47,15 @@ bool can_compress(const Plio&, const ImageHdu::Initializer<T>& init)
     return false;
   }
 
+  // Negative values
+  if constexpr (std::is_signed_v<T>) {
+    if (const auto* stats = init.statistics()) {
+      if (stats->min < 0) {
+        return false;
+      }
+    }
+  }
+
   // Maybe
   if constexpr (bp > 16) {
     // Max from records
@@ -51,21 +65,143 @@ bool can_compress(const Plio&, const ImageHdu::Initializer<T>& init)
     }
 
     // No max
-    if (not init.data) {
+    const auto* stats = init.statistics();
+    if (not stats) {
       return false;
     }
 
     // Max from data
-    const auto max = *std::max_element(init.data, init.data + shape_size(init.shape));
-    return max < (T(1) << 24);
+    return stats->max < (T(1) << 24);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Convert a scaling relative to the noise level into an absolute scaling, if the noise is known.
+ */
+template <typename T>
+Scaling absolute_scaling(const Scaling& scaling, const ImageHdu::Initializer<T>& init)
+{
+  if (not scaling || scaling.type() == Scaling::Type::Absolute) {
+    return scaling;
+  }
+  const auto* stats = init.statistics();
+  if (not stats || stats->noise <= 0) {
+    return scaling; // Let CFITSIO estimate the noise tile-wise
+  }
+  if (scaling.type() == Scaling::Type::Factor) {
+    return stats->noise * scaling.value();
+  }
+  return stats->noise / scaling.value();
+}
+
+inline std::string algorithm_name(const NoCompression&)
+{
+  return "NoCompression";
+}
+
+inline std::string algorithm_name(const Gzip&)
+{
+  return "Gzip";
+}
+
+inline std::string algorithm_name(const ShuffledGzip&)
+{
+  return "ShuffledGzip";
+}
+
+inline std::string algorithm_name(const Rice&)
+{
+  return "Rice";
+}
+
+inline std::string algorithm_name(const HCompress&)
+{
+  return "HCompress";
+}
+
+inline std::string algorithm_name(const Plio&)
+{
+  return "Plio";
+}
+
+/**
+ * @brief Resolve the tile shape of some tiling for some image shape.
+ */
+inline Linx::Position<-1> tile_shape(const Linx::Position<-1>& tiling, const Linx::Position<-1>& shape)
+{
+  if (tiling == Tile::whole()) {
+    return shape;
   }
+  auto out = shape;
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    if (i >= tiling.size()) {
+      out[i] = 1;
+    } else if (tiling[i] > 0 && tiling[i] < shape[i]) {
+      out[i] = tiling[i];
+    }
+  }
+  return out;
+}
 
+/**
+ * @brief Check whether some tiling is accepted by CFITSIO for HCompress-ing an image of given shape.
+ * @details
+ * Tiles must be 2D, with at least 4 pixels along each axis, including the last, possibly truncated, tiles.
+ */
+inline bool is_hcompress_tiling(const Linx::Position<-1>& tiling, const Linx::Position<-1>& shape)
+{
+  const auto tile = tile_shape(tiling, shape);
+  for (std::size_t i = 0; i < tile.size(); ++i) {
+    const auto modulo = shape[i] % tile[i];
+    if (not((i < 2) ? (tile[i] >= 4 && (modulo == 0 || modulo >= 4)) : (tile[i] == 1))) {
+      return false;
+    }
+  }
   return true;
 }
 
+/**
+ * @brief Get the tiling of an algorithm from the installed tiling table, if any.
+ */
+template <typename TAlgo, typename T>
+std::optional<Linx::Position<-1>> tabulated_tiling(const TAlgo& algo, const ImageHdu::Initializer<T>& init)
+{
+  const auto table = TilingTable::installed();
+  if (not table) {
+    return std::nullopt;
+  }
+  if (const auto* tiling = table->find(algorithm_name(algo), bitpix<T>(), init.shape.size())) {
+    return *tiling;
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Copy a region of some image data into a contiguous buffer.
+ */
+template <typename T>
+std::vector<T> copy_region(const ImageHdu::Initializer<T>& init, const Linx::Box<-1>& region)
+{
+  const Linx::PtrRaster<const T, -1> image(init.shape, init.data);
+  std::vector<T> out(shape_size(region.shape()));
+  const auto length = region.length(0);
+  auto it = out.begin();
+  for (const auto& p : project(region)) {
+    it = std::copy_n(&image[p], length, it);
+  }
+  return out;
+}
+
 template <typename TAlgo, typename T>
 TAlgo& adapt_tiling(TAlgo& algo, const ImageHdu::Initializer<T>& init)
 {
+  // Tuned tiling
+  if (auto tiling = tabulated_tiling(algo, init)) {
+    return algo.tiling(std::move(*tiling));
+  }
+
   static constexpr Linx::Index min_size = 1024 * 1024 / sizeof(T);
 
   // Small image
@@ -89,6 +225,13 @@ TAlgo& adapt_tiling(TAlgo& algo, const ImageHdu::Initializer<T>& init)
 template <typename T>
 HCompress& adapt_tiling(HCompress& algo, const ImageHdu::Initializer<T>& init)
 {
+  // Tuned tiling, if compatible with the image shape
+  if (auto tiling = tabulated_tiling(algo, init)) {
+    if (is_hcompress_tiling(*tiling, init.shape)) {
+      return algo.tiling(std::move(*tiling));
+    }
+  }
+
   // Small image
   if (init.shape[1] <= 30) {
     // FIXME what about large rows?
@@ -106,6 +249,7 @@ HCompress& adapt_tiling(HCompress& algo, const ImageHdu::Initializer<T>& init)
   // Fallback
   return algo.tiling(Tile::rowwise(17)); // FIXME safe?
 }
+
 /// @endcond
 
 template <typename TAlgo>
@@ -168,18 +312,115 @@ bool CompressAuto::apply(fitsfile* fptr, const ImageHdu::Initializer<T>& init)
 }
 
 template <typename T>
-std::unique_ptr<Compress<ShuffledGzip>> CompressAuto::gzip(const ImageHdu::Initializer<T>&)
+bool CompressSampled::apply(fitsfile* fptr, const ImageHdu::Initializer<T>& init)
+{
+  m_selection.reset();
+
+  // Nothing to sample
+  if (not init.data) {
+    return m_auto.apply(fptr, init);
+  }
+
+  // Measure the compatible algorithms
+  m_selection = CompressionSelection {init.index, init.name, {}, 0};
+  std::vector<std::function<void(fitsfile*)>> candidates;
+  sample(m_auto.plio(init), init, candidates);
+  sample(m_auto.hcompress(init), init, candidates);
+  sample(m_auto.rice(init), init, candidates);
+  sample(m_auto.gzip(init), init, candidates);
+
+  // Select the cheapest one
+  const auto& trials = m_selection->trials;
+  if (trials.empty()) {
+    return false;
+  }
+  std::vector<double> costs;
+  costs.reserve(trials.size());
+  for (const auto& t : trials) {
+    costs.push_back(m_cost(t));
+  }
+  m_selection->selected = std::distance(costs.begin(), std::min_element(costs.begin(), costs.end()));
+  candidates[m_selection->selected](fptr);
+  return true;
+}
+
+template <typename TAlgo, typename T>
+void CompressSampled::sample(
+    std::unique_ptr<Compress<TAlgo>> action,
+    const ImageHdu::Initializer<T>& init,
+    std::vector<std::function<void(fitsfile*)>>& candidates)
+{
+  if (not action) {
+    return;
+  }
+  std::shared_ptr<TAlgo> algo = action->compression(init);
+  if (not algo) {
+    return;
+  }
+
+  // Samples are full tiles, evenly spaced in the grid of tiles
+  const auto tile = tile_shape(algo->tiling(), init.shape);
+  const auto dimension = tile.size();
+  Linx::Position<-1> grid(dimension);
+  Linx::Index tile_count = 1;
+  for (std::size_t i = 0; i < dimension; ++i) {
+    grid[i] = std::max<Linx::Index>(init.shape[i] / tile[i], 1);
+    tile_count *= grid[i];
+  }
+  const auto tile_size = shape_size(tile);
+  const auto count = std::max<Linx::Index>(std::min<Linx::Index>(m_sample_count, tile_count), 1);
+
+  // Compress each sample as a single tile
+  auto sample_algo = *algo;
+  sample_algo.tiling(tile);
+  CompressionTrial trial {algorithm_name(*algo), 0, 0, 0.};
+  auto front = Linx::Position<-1>::zero(dimension);
+  for (Linx::Index k = 0; k < count; ++k) {
+    auto index = count == 1 ? 0 : (tile_count - 1) * k / (count - 1);
+    for (std::size_t i = 0; i < dimension; ++i) {
+      front[i] = index % grid[i] * tile[i];
+      index /= grid[i];
+    }
+    const auto sample = copy_region(init, Linx::Box<-1>::from_shape(front, tile));
+    const auto begin = std::chrono::steady_clock::now();
+    trial.compressed_bytes += Cfitsio::ImageCompression::compressed_size(sample_algo, tile, sample.data());
+    trial.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    trial.raw_bytes += tile_size * sizeof(T);
+  }
+
+  m_selection->trials.push_back(std::move(trial));
+  candidates.push_back([algo](fitsfile* fptr) {
+    Cfitsio::ImageCompression::compress(fptr, *algo);
+  });
+}
+
+inline bool CompressBintables::apply(fitsfile* from, fitsfile* to) const
+{
+  // No compression of data units less than one block long
+  static constexpr Linx::Index block_size = 2880;
+  const auto row_width = Cfitsio::HeaderIo::parse_record<Linx::Index>(from, "NAXIS1").value;
+  const auto row_count = Cfitsio::HeaderIo::parse_record<Linx::Index>(from, "NAXIS2").value;
+  if (row_width * row_count <= block_size) {
+    return false;
+  }
+
+  Cfitsio::TableCompression::compress(from, to);
+  return true;
+}
+
+template <typename T>
+std::unique_ptr<Compress<ShuffledGzip>> CompressAuto::gzip(const ImageHdu::Initializer<T>& init)
 {
-  return std::make_unique<Compress<ShuffledGzip>>(Tile::adaptive(), quantization<T>());
+  return std::make_unique<Compress<ShuffledGzip>>(Tile::adaptive(), quantization(init));
 }
 
 template <typename T>
-std::unique_ptr<Compress<Rice>> CompressAuto::rice(const ImageHdu::Initializer<T>&)
+std::unique_ptr<Compress<Rice>> CompressAuto::rice(const ImageHdu::Initializer<T>& init)
 {
   if (std::is_floating_point_v<T> && m_type == CompressionType::Lossless) {
     return nullptr;
   }
-  return std::make_unique<Compress<Rice>>(Tile::adaptive(), quantization<T>());
+  return std::make_unique<Compress<Rice>>(Tile::adaptive(), quantization(init));
 }
 
 template <typename T>
@@ -194,11 +435,11 @@ std::unique_ptr<Compress<HCompress>> CompressAuto::hcompress(const ImageHdu::Ini
     return nullptr;
   }
 
-  auto q = quantization<T>();
+  auto q = quantization(init);
   if (q.dithering() == Quantization::Dithering::NonZeroPixel) {
     q.dithering(Quantization::Dithering::EveryPixel);
   }
-  return std::make_unique<Compress<HCompress>>(Tile::adaptive(), q, hcompress_scaling<T>());
+  return std::make_unique<Compress<HCompress>>(Tile::adaptive(), q, hcompress_scaling(init));
 }
 
 template <typename T>
@@ -217,36 +458,36 @@ std::unique_ptr<Compress<Plio>> CompressAuto::plio(const ImageHdu::Initializer<T
 }
 
 template <typename T>
-Quantization CompressAuto::quantization() const
+Quantization CompressAuto::quantization(const ImageHdu::Initializer<T>& init) const
 {
   if constexpr (std::is_integral_v<T>) {
     if (m_type != CompressionType::Lossy) {
       return Quantization(0);
     }
-    Quantization q(Tile::rms / 4);
+    Quantization q(absolute_scaling(Tile::rms / 4, init));
     q.dithering(Quantization::Dithering::NonZeroPixel); // Keep nulls for integers
     return q;
   } else {
     if (m_type == CompressionType::Lossless) {
       return Quantization(0);
     }
-    return Quantization(Tile::rms / 16); // More conservative, imcopy default
+    return Quantization(absolute_scaling(Tile::rms / 16, init)); // More conservative, imcopy default
   }
 }
 
 template <typename T>
-Scaling CompressAuto::hcompress_scaling() const
+Scaling CompressAuto::hcompress_scaling(const ImageHdu::Initializer<T>& init) const
 {
   if constexpr (std::is_integral_v<T>) {
     if (m_type != CompressionType::Lossy) {
       return 0;
     }
-    return Tile::rms * 2.5;
+    return absolute_scaling(Tile::rms * 2.5, init);
   } else {
     if (m_type == CompressionType::Lossless) {
       return 0;
     }
-    return Tile::rms * 2.5;
+    return absolute_scaling(Tile::rms * 2.5, init);
   }
 }
 
@@ -14,16 +14,21 @@ template <typename T>
 Record<T> Header::parse(const std::string& keyword) const
 {
   m_touch();
-  return Cfitsio::HeaderIo::parse_record<T>(m_fptr, keyword);
+  auto record = Cfitsio::HeaderIo::parse_record<T>(m_fptr, keyword);
+  if (observed()) {
+    notify({keyword});
+  }
+  return record;
 }
 
 template <typename T>
 Record<T> Header::parse_or(const Record<T>& fallback) const
 {
-  if (has(fallback.keyword)) {
-    return parse<T>(fallback.keyword);
+  auto record = parse_or_unobserved(fallback);
+  if (observed()) {
+    notify({fallback.keyword});
   }
-  return fallback;
+  return record;
 }
 
 template <typename T>
@@ -44,6 +49,9 @@ RecordVec<T> Header::parse_n(const std::vector<std::string>& keywords) const
   std::transform(keywords.begin(), keywords.end(), res.vector.begin(), [&](const std::string& k) {
     return Cfitsio::HeaderIo::parse_record<T>(m_fptr, k);
   });
+  if (observed()) {
+    notify(keywords);
+  }
   return res;
 }
 
@@ -57,9 +65,15 @@ template <typename TSeq>
 TSeq Header::parse_n_or(TSeq&& fallbacks) const
 {
   auto func = [&](const auto& f) {
-    return parse_or(f);
+    return parse_or_unobserved(f);
   };
-  return Linx::seq_transform<TSeq>(fallbacks, func);
+  auto res = Linx::seq_transform<TSeq>(fallbacks, func);
+  if (observed()) {
+    notify(Linx::seq_transform<std::vector<std::string>>(fallbacks, [](const auto& f) {
+      return f.keyword;
+    }));
+  }
+  return res;
 }
 
 template <typename... Ts>
@@ -72,21 +86,44 @@ template <typename TReturn, typename... Ts>
 TReturn Header::parse_struct(const TypedKey<Ts, std::string>&... keywords) const
 {
   m_touch();
-  return {Cfitsio::HeaderIo::parse_record<Ts>(m_fptr, keywords.key)...};
+  TReturn res {Cfitsio::HeaderIo::parse_record<Ts>(m_fptr, keywords.key)...};
+  if (observed()) {
+    notify({keywords.key...});
+  }
+  return res;
 }
 
 template <typename TReturn, typename... Ts>
 TReturn Header::parse_struct_or(const Record<Ts>&... fallbacks) const
 {
-  return {parse_or<Ts>(fallbacks)...}; // TODO avoid calling touch for each keyword
+  TReturn res {parse_or_unobserved<Ts>(fallbacks)...}; // TODO avoid calling touch for each keyword
+  if (observed()) {
+    notify({fallbacks.keyword...});
+  }
+  return res;
 }
 
 template <typename TReturn, typename TSeq>
 TReturn Header::parse_struct_or(TSeq&& fallbacks) const
 {
-  return Linx::seq_transform<TReturn>(fallbacks, [&](auto f) {
-    return parse_or(f);
+  auto res = Linx::seq_transform<TReturn>(fallbacks, [&](auto f) {
+    return parse_or_unobserved(f);
   }); // FIXME test
+  if (observed()) {
+    notify(Linx::seq_transform<std::vector<std::string>>(fallbacks, [](const auto& f) {
+      return f.keyword;
+    }));
+  }
+  return res;
+}
+
+template <typename T>
+Record<T> Header::parse_or_unobserved(const Record<T>& fallback) const
+{
+  if (has(fallback.keyword)) {
+    return Cfitsio::HeaderIo::parse_record<T>(m_fptr, fallback.keyword);
+  }
+  return fallback;
 }
 
 /// @cond INTERNAL
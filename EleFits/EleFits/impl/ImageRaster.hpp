@@ -4,10 +4,14 @@
 
 #if defined(_ELEFITS_IMAGERASTER_IMPL) || defined(CHECK_QUALITY)
 
+#include "EleCfitsioWrapper/CompressionWrapper.h"
 #include "EleCfitsioWrapper/ImageWrapper.h"
 #include "EleFits/ImageRaster.h"
 #include "Linx/Data/Box.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace Fits {
 
 template <Linx::Index N>
@@ -21,6 +25,7 @@ template <Linx::Index N>
 void ImageRaster::update_shape(Linx::Position<N> shape) const
 {
   m_edit();
+  invalidate_tiles();
   Cfitsio::ImageIo::update_shape<N>(m_fptr, LINX_MOVE(shape));
 }
 
@@ -28,6 +33,7 @@ template <typename T, Linx::Index N>
 void ImageRaster::update_type_shape(Linx::Position<N> shape) const
 {
   m_edit();
+  invalidate_tiles();
   Cfitsio::ImageIo::update_type_shape<T, N>(m_fptr, LINX_MOVE(shape));
 }
 
@@ -43,7 +49,38 @@ template <typename TOut>
 void ImageRaster::read_to(TOut& out) const
 {
   m_touch();
-  Cfitsio::ImageIo::read_raster_to(m_fptr, out);
+  observe(
+      false,
+      [&]() {
+        const auto shape = out.domain().shape();
+        return DataAccess::image<typename TOut::Value>(Linx::Position<TOut::Dimension>::zero(shape.size()), shape);
+      },
+      [&]() {
+        Cfitsio::ImageIo::read_raster_to(m_fptr, out);
+      });
+}
+
+template <typename T, Linx::Index N>
+Linx::Raster<T, N> ImageRaster::read_parallel(Linx::Index thread_count) const
+{
+  Linx::Raster<T, N> out(read_shape<N>());
+  read_parallel_to(out, thread_count);
+  return out;
+}
+
+template <typename TOut>
+void ImageRaster::read_parallel_to(TOut& out, Linx::Index thread_count) const
+{
+  m_touch();
+  observe(
+      false,
+      [&]() {
+        const auto shape = out.domain().shape();
+        return DataAccess::image<typename TOut::Value>(Linx::Position<TOut::Dimension>::zero(shape.size()), shape);
+      },
+      [&]() {
+        Cfitsio::ImageCompression::read_parallel_to(m_fptr, out, thread_count);
+      });
 }
 
 template <typename T, Linx::Index M, Linx::Index N>
@@ -58,10 +95,80 @@ template <Linx::Index N, typename TOut>
 void ImageRaster::read_region_to(Linx::Position<N> front, TOut& out) const
 {
   m_touch();
-  Cfitsio::ImageIo::read_region_to(
-      m_fptr,
-      Linx::Box<N>::from_shape(LINX_MOVE(front), out.domain().shape()),
-      out); // FIXME give only front
+  const auto region = Linx::Box<N>::from_shape(LINX_MOVE(front), out.domain().shape()); // FIXME give only front
+  observe(
+      false,
+      [&]() {
+        return DataAccess::image<typename TOut::Value>(region.front(), region.shape());
+      },
+      [&]() {
+        if (m_cache && Cfitsio::ImageIo::is_compressed(m_fptr)) {
+          read_cached_region_to(region, out);
+        } else {
+          Cfitsio::ImageIo::read_region_to(m_fptr, region, out);
+        }
+      });
+}
+
+template <Linx::Index N, typename TOut>
+void ImageRaster::read_cached_region_to(const Linx::Box<N>& region, TOut& out) const
+{
+  using T = std::decay_t<typename TOut::Value>;
+  const auto shape = Cfitsio::ImageIo::read_shape<N>(m_fptr);
+  const auto file_tiling = Cfitsio::ImageCompression::read_tiling(m_fptr);
+  const auto dimension = shape.size();
+  const auto& front = region.front();
+  const auto region_shape = region.shape();
+
+  /* Intersecting tiles */
+
+  auto tiling = shape;
+  auto grid = shape; // Number of tiles along each axis
+  auto first_tile = front;
+  auto tile_count = front;
+  for (std::size_t i = 0; i < dimension; ++i) {
+    tiling[i] = std::min(file_tiling[i], shape[i]);
+    grid[i] = (shape[i] + tiling[i] - 1) / tiling[i];
+    first_tile[i] = front[i] / tiling[i];
+    tile_count[i] = (front[i] + region_shape[i] - 1) / tiling[i] - first_tile[i] + 1;
+  }
+
+  for (const auto& t : Linx::Box<N>::from_shape(first_tile, tile_count)) {
+
+    /* Get tile */
+
+    Linx::Index index = 0; // Row in the tile table
+    auto tile_front = t;
+    auto tile_shape = t;
+    for (auto i = dimension; i-- > 0;) {
+      index = index * grid[i] + t[i];
+      tile_front[i] = t[i] * tiling[i];
+      tile_shape[i] = std::min(tiling[i], shape[i] - tile_front[i]);
+    }
+    const auto tile = m_cache->get<T>(index, [&]() {
+      std::vector<T> data(shape_size(tile_shape));
+      Cfitsio::ImageIo::read_subset_to(m_fptr, Linx::Box<N>::from_shape(tile_front, tile_shape), data.data());
+      return data;
+    });
+
+    /* Copy intersection row-wise */
+
+    auto rows_front = tile_front;
+    auto rows_shape = tile_shape;
+    for (std::size_t i = 0; i < dimension; ++i) {
+      rows_front[i] = std::max(front[i], tile_front[i]);
+      rows_shape[i] = std::min(front[i] + region_shape[i], tile_front[i] + tile_shape[i]) - rows_front[i];
+    }
+    const auto length = rows_shape[0];
+    rows_shape[0] = 1;
+    for (const auto& p : Linx::Box<N>::from_shape(rows_front, rows_shape)) {
+      Linx::Index offset = 0;
+      for (auto i = dimension; i-- > 0;) {
+        offset = offset * tile_shape[i] + p[i] - tile_front[i];
+      }
+      std::copy_n(tile->data() + offset, length, &out[p - front]);
+    }
+  }
 }
 
 template <typename TIn>
@@ -71,11 +178,36 @@ void ImageRaster::write(const TIn& in) const
   // FIXME Cfitsio::ImageIo::write_raster() for performance?
 }
 
+template <typename TIn>
+void ImageRaster::write_parallel(const TIn& in, Linx::Index thread_count) const
+{
+  m_edit();
+  invalidate_tiles();
+  observe(
+      true,
+      [&]() {
+        const auto shape = in.domain().shape();
+        return DataAccess::image<typename TIn::Value>(Linx::Position<TIn::Dimension>::zero(shape.size()), shape);
+      },
+      [&]() {
+        Cfitsio::ImageCompression::write_parallel(m_fptr, in, thread_count);
+      });
+}
+
 template <Linx::Index N, typename TIn>
 void ImageRaster::write_region(Linx::Position<N> front, const TIn& in) const
 {
   m_edit();
-  Cfitsio::ImageIo::write_region(m_fptr, Linx::Box<N>::from_shape(LINX_MOVE(front), in.domain().shape()), in);
+  invalidate_tiles();
+  const auto region = Linx::Box<N>::from_shape(LINX_MOVE(front), in.domain().shape());
+  observe(
+      true,
+      [&]() {
+        return DataAccess::image<typename TIn::Value>(region.front(), region.shape());
+      },
+      [&]() {
+        Cfitsio::ImageIo::write_region(m_fptr, region, in);
+      });
 }
 
 template <typename TIn>
@@ -86,6 +218,113 @@ void ImageRaster::update(const TIn& in) const
   write(in);
 }
 
+template <typename T>
+void ImageRaster::stream_from(const ImageRaster& src, std::size_t buffer_size) const
+{
+  src.m_touch();
+  const auto shape = Cfitsio::ImageIo::read_shape<-1>(src.m_fptr);
+  const auto src_tiling = Cfitsio::ImageCompression::read_tiling(src.m_fptr);
+  m_edit();
+  invalidate_tiles();
+  const auto dst_tiling = Cfitsio::ImageCompression::read_tiling(m_fptr);
+  const auto dimension = shape.size();
+  if (dimension == 0) {
+    return;
+  }
+
+  /* Slab thickness */
+
+  const auto last = dimension - 1;
+  const auto& tiling = dst_tiling.size() == dimension ? dst_tiling : src_tiling; // Favor compression
+  const Linx::Index step = tiling.size() == dimension ? std::max<Linx::Index>(tiling[last], 1) : 1;
+  Linx::Index plane_size = 1;
+  for (std::size_t i = 0; i < last; ++i) {
+    plane_size *= shape[i];
+  }
+  if (plane_size * shape[last] == 0) {
+    return;
+  }
+  const Linx::Index step_bytes = std::max<Linx::Index>(plane_size * step * sizeof(T), 1);
+  const Linx::Index thickness = std::min(step * std::max<Linx::Index>(buffer_size / step_bytes, 1), shape[last]);
+  std::vector<T> buffer(plane_size * thickness);
+
+  /* Copy */
+
+  auto front = Linx::Position<-1>::zero(dimension);
+  auto slab_shape = shape;
+  for (Linx::Index z = 0; z < shape[last]; z += thickness) {
+    front[last] = z;
+    slab_shape[last] = std::min(thickness, shape[last] - z);
+    const auto region = Linx::Box<-1>::from_shape(front, slab_shape);
+    const auto access = [&]() {
+      return DataAccess::image<T>(front, slab_shape);
+    };
+    src.m_touch(); // Both HDUs may share the same fitsfile
+    src.observe(false, access, [&]() {
+      Cfitsio::ImageIo::read_subset_to(src.m_fptr, region, buffer.data());
+    });
+    m_edit();
+    observe(true, access, [&]() {
+      Cfitsio::ImageIo::write_subset(m_fptr, region, buffer.data());
+    });
+  }
+}
+
+template <typename T>
+ImageStatistics ImageRaster::read_statistics(std::size_t buffer_size) const
+{
+  m_touch();
+  const auto shape = Cfitsio::ImageIo::read_shape<-1>(m_fptr);
+  const auto dimension = shape.size();
+  const auto size = shape_size(shape);
+  ImageStatistics::Accumulator accumulator(size);
+  if (size == 0) {
+    return accumulator.statistics();
+  }
+
+  /* Slab thickness */
+
+  const auto last = dimension - 1;
+  const Linx::Index plane_size = size / shape[last];
+  const Linx::Index plane_bytes = plane_size * sizeof(T);
+  const Linx::Index thickness = std::min(std::max<Linx::Index>(buffer_size / plane_bytes, 1), shape[last]);
+  std::vector<T> buffer(plane_size * thickness);
+
+  /* Accumulate */
+
+  auto front = Linx::Position<-1>::zero(dimension);
+  auto slab_shape = shape;
+  for (Linx::Index z = 0; z < shape[last]; z += thickness) {
+    front[last] = z;
+    slab_shape[last] = std::min(thickness, shape[last] - z);
+    const auto region = Linx::Box<-1>::from_shape(front, slab_shape);
+    m_touch();
+    observe(
+        false,
+        [&]() {
+          return DataAccess::image<T>(front, slab_shape);
+        },
+        [&]() {
+          Cfitsio::ImageIo::read_subset_to(m_fptr, region, buffer.data());
+        });
+    accumulator.push(buffer.data(), plane_size * slab_shape[last]);
+  }
+  return accumulator.statistics();
+}
+
+template <typename TAccess, typename TRun>
+void ImageRaster::observe(bool writing, TAccess&& access, TRun&& run) const
+{
+  if (not observed()) {
+    run();
+    return;
+  }
+  const DataAccess description = access();
+  notify(writing ? DataStage::Writing : DataStage::Reading, description);
+  run();
+  notify(writing ? DataStage::Written : DataStage::Read, description);
+}
+
 } // namespace Fits
 
 #endif
@@ -14,16 +14,18 @@ namespace Fits {
 template <typename... TActions>
 MefFile::MefFile(const std::string& filename, FileMode permission, TActions&&... actions) :
     FitsFile(filename, permission), // FIXME create Primary after strategy is set?
-    m_hdus(std::max(1L, Cfitsio::HduAccess::count(m_fptr))), // 1 for create, count() for open
-    m_strategy()
+    m_hdus(permission == FileMode::Read ? 1 : std::max(1L, Cfitsio::HduAccess::count(m_fptr))), // 1 for lazy or create
+    m_lazy(permission == FileMode::Read), m_counted(not m_lazy), m_strategy()
 {
   if (m_permission != FileMode::Read) {
     strategy(CiteEleFits()); // FIXME document
   }
   if constexpr (sizeof...(TActions)) {
     strategy(actions...);
-    for (const auto& hdu : *this) {
-      m_strategy.opened(hdu);
+    if (not m_lazy) { // Otherwise triggered by access()
+      for (const auto& hdu : *this) {
+        m_strategy.opened(hdu);
+      }
     }
   }
 }
@@ -45,15 +47,21 @@ const T& MefFile::access(Linx::Index index)
     index += hdu_count();
   }
   Cfitsio::HduAccess::goto_index(m_fptr, index + 1); // CFITSIO index is 1-based
+  if (index >= static_cast<Linx::Index>(m_hdus.size())) { // Lazy discovery, index was checked by goto_index()
+    m_hdus.resize(index + 1);
+  }
   const auto hdu_type = Cfitsio::HduAccess::current_type(m_fptr);
   auto& ptr = m_hdus[index];
   if (ptr == nullptr) {
     if (hdu_type == HduCategory::Image) {
-      ptr.reset(new ImageHdu(Hdu::Token {}, m_fptr, index));
+      ptr.reset(new ImageHdu(Hdu::Token {&m_strategy}, m_fptr, index));
     } else if (hdu_type == HduCategory::Bintable) {
-      ptr.reset(new BintableHdu(Hdu::Token {}, m_fptr, index));
+      ptr.reset(new BintableHdu(Hdu::Token {&m_strategy}, m_fptr, index));
     } else {
-      ptr.reset(new Hdu(Hdu::Token {}, m_fptr, index));
+      ptr.reset(new Hdu(Hdu::Token {&m_strategy}, m_fptr, index));
+    }
+    if (m_lazy) {
+      m_strategy.opened(*ptr);
     }
     m_strategy.accessed(*ptr);
   }
@@ -109,13 +117,13 @@ const T& MefFile::append(const T& hdu)
   const auto index = m_hdus.size();
 
   if (hdu.matches(HduCategory::Bintable)) {
-    Cfitsio::HduAccess::copy_verbatim(hdu.m_fptr, m_fptr);
-    m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {}, m_fptr, index, HduCategory::Created));
+    copy_bintable(hdu);
+    m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
   } else {
     if (hdu.matches(HduCategory::RawImage) &&
         (m_strategy.m_compression.empty() || hdu.matches(HduCategory::Metadata))) {
       Cfitsio::HduAccess::copy_verbatim(hdu.m_fptr, m_fptr);
-      m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {}, m_fptr, index, HduCategory::Created));
+      m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
     } else {
       // // setting to huge hdu if hdu size > 2^32
       // if (hdu.size_in_file() > (1ULL << 32))
@@ -125,10 +133,14 @@ const T& MefFile::append(const T& hdu)
 
 #define ELEFITS_COPY_HDU(type, name) \
   if (image.read_typeid() == typeid(type)) { \
-    append_image( \
-        hdu.read_name(), \
-        hdu.header().parse_all(KeywordCategory::User), \
-        image.raster().template read<type, -1>()); \
+    if (image.raster().read_size() * sizeof(type) <= ImageRaster::default_buffer_size) { \
+      append_image( \
+          hdu.read_name(), \
+          hdu.header().parse_all(KeywordCategory::User), \
+          image.raster().template read<type, -1>()); \
+    } else { \
+      stream_image<type>(image); \
+    } \
   }
       ELEFITS_FOREACH_RASTER_TYPE(ELEFITS_COPY_HDU)
 #undef ELEFITS_COPY_HDU
@@ -140,12 +152,50 @@ const T& MefFile::append(const T& hdu)
   return copy;
 }
 
+template <typename T>
+const T& MefFile::append_verbatim(const T& hdu)
+{
+  const auto index = m_hdus.size();
+  const auto is_bintable = hdu.matches(HduCategory::Bintable); // Also moves to the HDU
+  Cfitsio::HduAccess::copy_verbatim(hdu.m_fptr, m_fptr);
+  if (is_bintable) {
+    m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
+  } else {
+    m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
+  }
+  const auto& copy = access<T>(index);
+  m_strategy.copied(copy);
+  return copy;
+}
+
+template <typename T>
+const ImageHdu& MefFile::stream_image(const ImageHdu& image)
+{
+  const auto index = m_hdus.size();
+  const auto name = image.read_name();
+  const auto records = image.header().parse_all(KeywordCategory::User);
+  const auto shape = image.read_shape<-1>();
+  ImageHdu::Initializer<T> init {static_cast<Linx::Index>(index), name, records, shape, nullptr};
+  if (not m_strategy.m_compression.empty()) {
+    init.statistics_cache = image.raster().template read_statistics<T>(); // Additional streamed pass
+  }
+  m_strategy.compress(m_fptr, init);
+  Cfitsio::HduAccess::init_image<T>(m_fptr, name, shape);
+  m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
+  const auto& hdu = m_hdus[index]->as<ImageHdu>();
+  m_strategy.created(hdu);
+  hdu.header().write_n(records);
+  hdu.raster().template stream_from<T>(image.raster());
+  return hdu;
+}
+
 template <typename T>
 const ImageHdu& MefFile::append_image_header(const std::string& name, const RecordSeq& records)
 {
   Cfitsio::HduAccess::init_image<T, 0>(m_fptr, name, {});
   const auto index = m_hdus.size();
-  m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {}, m_fptr, index, HduCategory::Created)); // FIXME factorize
+  m_hdus.push_back(
+      std::make_unique<ImageHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created)); // FIXME factorize
   const auto& hdu = m_hdus[index]->as<ImageHdu>();
   m_strategy.created(hdu);
   hdu.header().write_n(records);
@@ -163,7 +213,7 @@ MefFile::append_null_image(const std::string& name, const RecordSeq& records, co
   ImageHdu::Initializer<T> init {static_cast<Linx::Index>(index), name, records, dynamic_shape, nullptr};
   m_strategy.compress(m_fptr, init);
   Cfitsio::HduAccess::init_image<T>(m_fptr, name, shape);
-  m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {}, m_fptr, index, HduCategory::Created));
+  m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
   const auto& hdu = m_hdus[index]->as<ImageHdu>();
   m_strategy.created(hdu);
   hdu.header().write_n(records);
@@ -198,7 +248,7 @@ const ImageHdu& MefFile::append_image(const std::string& name, const RecordSeq&
   ImageHdu::Initializer<T> init {static_cast<Linx::Index>(index), name, records, dynamic_shape, raster.data()};
   m_strategy.compress(m_fptr, init);
   Cfitsio::HduAccess::init_image<typename TRaster::value_type>(m_fptr, name, raster.shape());
-  m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {}, m_fptr, index, HduCategory::Created));
+  m_hdus.push_back(std::make_unique<ImageHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
   const auto& hdu = m_hdus[index]->as<ImageHdu>();
   m_strategy.created(hdu);
   hdu.header().write_n(records);
@@ -215,7 +265,7 @@ MefFile::append_bintable_header(const std::string& name, const RecordSeq& record
 {
   Cfitsio::HduAccess::init_bintable(m_fptr, name, infos...);
   const auto index = m_hdus.size();
-  m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {}, m_fptr, index, HduCategory::Created));
+  m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
   const auto& hdu = m_hdus[index]->as<BintableHdu>();
   m_strategy.created(hdu);
   hdu.header().write_n(records);
@@ -246,6 +296,10 @@ template <typename... TColumns>
 const BintableHdu&
 MefFile::append_bintable(const std::string& name, const RecordSeq& records, const TColumns&... columns)
 {
+  if (m_strategy.compresses_bintables()) {
+    MefFile staging("mem://", FileMode::Create);
+    return append_staged_bintable(staging.append_bintable(name, records, columns...));
+  }
   const auto& hdu = append_bintable_header(name, records, columns.info()...);
   hdu.columns().write_n(std::forward_as_tuple(columns...)); // FIXME rm forwarding => should accept single column
   return hdu;
@@ -254,10 +308,14 @@ MefFile::append_bintable(const std::string& name, const RecordSeq& records, cons
 template <typename TColumns, std::size_t Size>
 const BintableHdu& MefFile::append_bintable(const std::string& name, const RecordSeq& records, const TColumns& columns)
 {
+  if (m_strategy.compresses_bintables()) {
+    MefFile staging("mem://", FileMode::Create);
+    return append_staged_bintable(staging.append_bintable<TColumns, Size>(name, records, columns));
+  }
   Cfitsio::HduAccess::assign_bintable<TColumns, Size>(m_fptr, name,
                                                       columns); // FIXME doesn't check for column size
   const auto index = m_hdus.size();
-  m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {}, m_fptr, index, HduCategory::Created));
+  m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
   const auto& hdu = m_hdus[index]->as<BintableHdu>();
   m_strategy.created(hdu);
   hdu.header().write_n(records);
@@ -0,0 +1,41 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#if defined(_ELEFITS_MEFFILEPOOL_IMPL) || defined(CHECK_QUALITY)
+
+#include "EleFits/MefFilePool.h"
+#include "EleFitsUtils/Parallel.h"
+
+namespace Fits {
+
+template <class T>
+const T& MefFilePool::access(Linx::Index index)
+{
+  return local().access<T>(index);
+}
+
+template <class T>
+const T& MefFilePool::find(const std::string& name, long version)
+{
+  return local().find<T>(name, version);
+}
+
+template <typename THdu, typename TFunc>
+void MefFilePool::parallel_for_each(const HduFilter& filter, TFunc&& func, Linx::Index thread_count)
+{
+  const auto f = filter * HduCategory::forClass<THdu>();
+  Parallel::for_each_index(
+      hdu_count(),
+      [&](long index, long) {
+        const auto& hdu = access<Hdu>(index);
+        if (hdu.matches(f)) {
+          func(hdu.as<THdu>());
+        }
+      },
+      is_concurrent() ? thread_count : 1);
+}
+
+} // namespace Fits
+
+#endif
@@ -0,0 +1,119 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#if defined(_ELEFITS_MEFWRITER_IMPL) || defined(CHECK_QUALITY)
+
+#include "EleFits/MefWriter.h"
+
+#include <algorithm> // copy
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+namespace Fits {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the number of bytes held by a column.
+ * @details
+ * For string columns, the number of characters is returned instead of the size of the `std::string`s.
+ */
+template <typename TColumn>
+std::size_t held_bytes(const TColumn& column)
+{
+  using T = std::decay_t<typename TColumn::Value>;
+  if constexpr (std::is_same_v<T, std::string>) {
+    return static_cast<std::size_t>(column.info().repeat_count() * column.row_count());
+  } else {
+    return static_cast<std::size_t>(column.size()) * sizeof(T);
+  }
+}
+
+/**
+ * @brief Get an owning copy of a raster, or move it if it is already owning.
+ * @details
+ * Non-owning rasters, like `PtrRaster`, are deep-copied,
+ * such that the I/O thread never reads the caller's buffer after the append method has returned.
+ */
+template <typename TRaster>
+auto owning_raster(TRaster&& raster)
+{
+  using T = std::remove_const_t<typename std::decay_t<TRaster>::Value>;
+  using Owning = Linx::Raster<T, std::decay_t<TRaster>::Dimension>;
+  if constexpr (std::is_base_of_v<Owning, std::decay_t<TRaster>>) {
+    return Owning(std::forward<TRaster>(raster));
+  } else {
+    Owning out(raster.shape());
+    std::copy(raster.begin(), raster.end(), out.begin());
+    return out;
+  }
+}
+
+/**
+ * @brief Get an owning copy of a column, or move it if it is already owning.
+ * @copydetails owning_raster()
+ */
+template <typename TColumn>
+auto owning_column(TColumn&& column)
+{
+  using T = typename std::decay_t<TColumn>::Value;
+  constexpr auto N = std::decay_t<TColumn>::Dimension;
+  using Owning = VecColumn<T, N>;
+  if constexpr (std::is_base_of_v<Owning, std::decay_t<TColumn>>) {
+    return Owning(std::forward<TColumn>(column));
+  } else {
+    const auto& info = column.info();
+    return Owning(ColumnInfo<T, N>(info.name, info.unit, info.shape), column.begin(), column.end());
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+template <typename... TActions>
+MefWriter::MefWriter(const std::string& filename, FileMode mode, std::size_t byte_budget, TActions&&... actions) :
+    m_file(filename, mode, std::forward<TActions>(actions)...), m_budget(byte_budget), m_queue(),
+    m_pending_bytes(0), m_hdu_count(m_file.hdu_count()), m_busy(false), m_stopping(false), m_error(), m_mutex(),
+    m_not_empty(), m_released(), m_thread()
+{
+  ReadOnlyError::may_throw("Cannot create MefWriter", mode);
+  m_thread = std::thread(&MefWriter::run, this);
+}
+
+template <typename TRaster>
+Linx::Index MefWriter::append_image(const std::string& name, const RecordSeq& records, TRaster&& raster)
+{
+  using T = std::decay_t<typename std::decay_t<TRaster>::Value>;
+  const auto bytes = static_cast<std::size_t>(raster.size()) * sizeof(T);
+  auto data = std::make_shared<decltype(Internal::owning_raster(std::forward<TRaster>(raster)))>(
+      Internal::owning_raster(std::forward<TRaster>(raster)));
+  return enqueue(
+      [name, records, data](MefFile& f) {
+        f.append_image(name, records, *data);
+      },
+      bytes);
+}
+
+template <typename... TColumns>
+Linx::Index MefWriter::append_bintable(const std::string& name, const RecordSeq& records, TColumns&&... columns)
+{
+  const std::size_t bytes = (std::size_t(0) + ... + Internal::held_bytes(columns));
+  auto data = std::make_shared<std::tuple<decltype(Internal::owning_column(std::forward<TColumns>(columns)))...>>(
+      Internal::owning_column(std::forward<TColumns>(columns))...);
+  return enqueue(
+      [name, records, data](MefFile& f) {
+        std::apply(
+            [&](const auto&... cs) {
+              f.append_bintable(name, records, cs...);
+            },
+            *data);
+      },
+      bytes);
+}
+
+} // namespace Fits
+
+#endif
@@ -0,0 +1,79 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#if defined(_ELEFITS_SHARDEDMEFWRITER_IMPL) || defined(CHECK_QUALITY)
+
+#include "EleFits/ShardedMefWriter.h"
+
+#include <tuple>
+
+namespace Fits {
+
+template <typename... TActions>
+ShardedMefWriter::ShardedMefWriter(
+    Mapping mapping,
+    FileMode mode,
+    Linx::Index worker_count,
+    std::size_t byte_budget,
+    const TActions&... actions) :
+    m_mapping(std::move(mapping)),
+    m_open(), m_budget(byte_budget), m_shards(), m_ready(), m_pending_bytes(0), m_pending_count(0), m_stopping(false),
+    m_error(), m_mutex(), m_ready_cv(), m_released(), m_workers()
+{
+  if (mode != FileMode::Create && mode != FileMode::Overwrite && mode != FileMode::Temporary) {
+    throw FitsError("Cannot create ShardedMefWriter: mode must be Create, Overwrite or Temporary.");
+  }
+  if (not m_mapping) {
+    throw FitsError("Cannot create ShardedMefWriter: no mapping provided.");
+  }
+  m_open = [mode, actions...](const std::string& filename) {
+    return std::make_unique<MefFile>(filename, mode, actions...); // Copy actions
+  };
+  start(worker_count);
+}
+
+template <typename TRaster>
+ShardedMefWriter::Location ShardedMefWriter::append_image(
+    const std::string& key,
+    const std::string& name,
+    const RecordSeq& records,
+    TRaster&& raster)
+{
+  using T = std::decay_t<typename std::decay_t<TRaster>::Value>;
+  const auto bytes = static_cast<std::size_t>(raster.size()) * sizeof(T);
+  auto data = std::make_shared<decltype(Internal::owning_raster(std::forward<TRaster>(raster)))>(
+      Internal::owning_raster(std::forward<TRaster>(raster)));
+  return enqueue(
+      key,
+      [name, records, data](MefFile& f) {
+        f.append_image(name, records, *data);
+      },
+      bytes);
+}
+
+template <typename... TColumns>
+ShardedMefWriter::Location ShardedMefWriter::append_bintable(
+    const std::string& key,
+    const std::string& name,
+    const RecordSeq& records,
+    TColumns&&... columns)
+{
+  const std::size_t bytes = (std::size_t(0) + ... + Internal::held_bytes(columns));
+  auto data = std::make_shared<std::tuple<decltype(Internal::owning_column(std::forward<TColumns>(columns)))...>>(
+      Internal::owning_column(std::forward<TColumns>(columns))...);
+  return enqueue(
+      key,
+      [name, records, data](MefFile& f) {
+        std::apply(
+            [&](const auto&... cs) {
+              f.append_bintable(name, records, cs...);
+            },
+            *data);
+      },
+      bytes);
+}
+
+} // namespace Fits
+
+#endif
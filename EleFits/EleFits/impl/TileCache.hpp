@@ -0,0 +1,25 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#if defined(_ELEFITS_TILECACHE_IMPL) || defined(CHECK_QUALITY)
+
+#include "EleFits/TileCache.h"
+
+namespace Fits {
+
+template <typename T, typename TFunc>
+std::shared_ptr<const std::vector<T>> TileCache::get(Linx::Index index, TFunc&& load)
+{
+  const Key key {index, std::type_index(typeid(T))};
+  if (auto cached = find(key)) {
+    return std::static_pointer_cast<const std::vector<T>>(cached);
+  }
+  auto tile = std::make_shared<const std::vector<T>>(load()); // Outside of the lock
+  insert(key, tile, tile->size() * sizeof(T));
+  return tile;
+}
+
+} // namespace Fits
+
+#endif
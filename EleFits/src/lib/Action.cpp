@@ -0,0 +1,335 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/Action.h"
+
+#include "EleCfitsioWrapper/FileWrapper.h"
+#include "EleFitsData/FitsError.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace Fits {
+
+namespace {
+
+using Cfitsio::Profiling::call_class_count;
+using Cfitsio::Profiling::call_class_name;
+using Cfitsio::Profiling::CallClass;
+using Cfitsio::Profiling::Counters;
+
+std::string escape(const std::string& text)
+{
+  std::string out;
+  for (auto c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+
+void write_json(std::ostream& os, const Counters& counters)
+{
+  for (std::size_t i = 0; i < call_class_count; ++i) {
+    const auto c = static_cast<CallClass>(i);
+    const auto& counter = counters[c];
+    os << (i == 0 ? "" : ", ") << "\"" << call_class_name(c) << "\": {\"calls\": " << counter.calls
+       << ", \"bytes\": " << counter.bytes << ", \"seconds\": " << counter.seconds << "}";
+  }
+}
+
+void write_csv(std::ostream& os, const Counters& counters)
+{
+  for (const auto& counter : counters.counters) {
+    os << ',' << counter.calls << ',' << counter.bytes << ',' << counter.seconds;
+  }
+  os << '\n';
+}
+
+std::string position_to_string(const Linx::Position<-1>& position)
+{
+  std::string out;
+  for (std::size_t i = 0; i < position.size(); ++i) {
+    out += (i == 0 ? "" : ",") + std::to_string(position[i]);
+  }
+  return out;
+}
+
+Linx::Position<-1> position_from_string(const std::string& text)
+{
+  std::vector<Linx::Index> out;
+  std::stringstream ss(text);
+  std::string length;
+  while (std::getline(ss, length, ',')) {
+    out.push_back(std::stol(length));
+  }
+  return Linx::Position<-1>(std::move(out));
+}
+
+/**
+ * @brief Aggregate the counters of some HDUs per file.
+ */
+std::map<std::string, Counters> aggregate(const std::vector<HduProfile>& hdus)
+{
+  std::map<std::string, Counters> out;
+  for (const auto& h : hdus) {
+    out[h.file] += h.counters;
+  }
+  return out;
+}
+
+/**
+ * @brief Save a profile as JSON if the file name ends with ".json", or as CSV otherwise.
+ */
+void save_profile(const std::vector<HduProfile>& hdus, const std::string& filename)
+{
+  std::ofstream os(filename);
+  if (not os) {
+    throw FitsError("Cannot create I/O profile: " + filename);
+  }
+  const auto per_file = aggregate(hdus);
+  const std::string extension = ".json";
+  const bool json = filename.size() >= extension.size() &&
+      filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+
+  if (json) {
+    os << "{\n  \"hdus\": [";
+    for (std::size_t i = 0; i < hdus.size(); ++i) {
+      const auto& h = hdus[i];
+      os << (i == 0 ? "" : ",") << "\n    {\"file\": \"" << escape(h.file) << "\", \"index\": " << h.index
+         << ", \"name\": \"" << escape(h.name) << "\", ";
+      write_json(os, h.counters);
+      os << "}";
+    }
+    os << "\n  ],\n  \"files\": [";
+    bool first = true;
+    for (const auto& f : per_file) {
+      os << (first ? "" : ",") << "\n    {\"file\": \"" << escape(f.first) << "\", ";
+      write_json(os, f.second);
+      os << "}";
+      first = false;
+    }
+    os << "\n  ]\n}\n";
+    return;
+  }
+
+  os << "File,HDU,Name";
+  for (std::size_t i = 0; i < call_class_count; ++i) {
+    const auto name = call_class_name(static_cast<CallClass>(i));
+    os << ',' << name << " calls," << name << " bytes," << name << " (s)";
+  }
+  os << '\n';
+  for (const auto& h : hdus) {
+    os << h.file << ',' << h.index << ',' << h.name;
+    write_csv(os, h.counters);
+  }
+  for (const auto& f : per_file) {
+    os << f.first << ",,";
+    write_csv(os, f.second);
+  }
+}
+
+} // namespace
+
+ProfileIo::ProfileIo(std::string filename) :
+    m_hdus(new std::vector<HduProfile>(), [filename = std::move(filename)](std::vector<HduProfile>* hdus) {
+      if (not filename.empty()) {
+        try {
+          save_profile(*hdus, filename);
+        } catch (...) {
+          // Destructors cannot throw: use save() to get the error
+        }
+      }
+      delete hdus;
+    })
+{}
+
+void ProfileIo::opened(const Hdu& hdu)
+{
+  enable(hdu);
+}
+
+void ProfileIo::accessed(const Hdu& hdu)
+{
+  enable(hdu);
+}
+
+void ProfileIo::created(const Hdu& hdu)
+{
+  enable(hdu);
+}
+
+void ProfileIo::closing(const Hdu& hdu)
+{
+  auto counters = Cfitsio::Profiling::take(hdu.m_fptr, hdu.m_cfitsio_index);
+  const auto file = Cfitsio::FileAccess::name(hdu.m_fptr);
+  const auto name = hdu.read_name();
+  Cfitsio::Profiling::take(hdu.m_fptr, hdu.m_cfitsio_index); // Discard the I/Os of the profiler itself
+  m_hdus->push_back({file, hdu.index(), name, std::move(counters)});
+}
+
+const std::vector<HduProfile>& ProfileIo::hdus() const
+{
+  return *m_hdus;
+}
+
+std::map<std::string, Counters> ProfileIo::files() const
+{
+  return aggregate(*m_hdus);
+}
+
+Counters ProfileIo::total() const
+{
+  Counters out;
+  for (const auto& h : *m_hdus) {
+    out += h.counters;
+  }
+  return out;
+}
+
+void ProfileIo::save(const std::string& filename) const
+{
+  save_profile(*m_hdus, filename);
+}
+
+void ProfileIo::enable(const Hdu& hdu) const
+{
+  Cfitsio::Profiling::enable(hdu.m_fptr);
+}
+
+TraceEvent TraceEvent::from_string(const std::string& line)
+{
+  TraceEvent out;
+  std::stringstream ss(line);
+  std::string type;
+  if (not(ss >> type >> out.hdu) || type.size() != 1) {
+    throw FitsError("Malformed trace event: " + line);
+  }
+  out.type = static_cast<Type>(type[0]);
+  switch (out.type) {
+    case Type::Access:
+      return out;
+    case Type::Parse: {
+      std::string keyword;
+      while (ss >> keyword) {
+        out.keywords.push_back(keyword);
+      }
+      return out;
+    }
+    case Type::Read:
+    case Type::Write: {
+      std::string type_name;
+      std::string kind;
+      ss >> type_name >> kind;
+      out.data.set_type(type_name);
+      if (kind == "I") {
+        std::string front;
+        std::string shape;
+        ss >> front >> shape;
+        out.data.front = position_from_string(front);
+        out.data.shape = position_from_string(shape);
+      } else if (kind == "T") {
+        ss >> out.data.column >> out.data.rows.front >> out.data.rows.back;
+      } else {
+        throw FitsError("Malformed trace event: " + line);
+      }
+      if (not(ss >> out.data.bytes)) {
+        throw FitsError("Malformed trace event: " + line);
+      }
+      return out;
+    }
+  }
+  throw FitsError("Unknown trace event type: " + line);
+}
+
+std::string TraceEvent::to_string() const
+{
+  std::string out(1, static_cast<char>(type));
+  out += " " + std::to_string(hdu);
+  switch (type) {
+    case Type::Access:
+      break;
+    case Type::Parse:
+      for (const auto& k : keywords) {
+        out += " " + k;
+      }
+      break;
+    case Type::Read:
+    case Type::Write:
+      out += " " + data.type_name();
+      if (data.is_image()) {
+        out += " I " + position_to_string(data.front) + " " + position_to_string(data.shape);
+      } else {
+        out += " T " + std::to_string(data.column) + " " + std::to_string(data.rows.front) + " " +
+            std::to_string(data.rows.back);
+      }
+      out += " " + std::to_string(data.bytes);
+      break;
+  }
+  return out;
+}
+
+TraceAccesses::TraceAccesses(const std::string& filename) : m_trace(std::make_shared<std::ofstream>(filename))
+{
+  if (not *m_trace) {
+    throw FitsError("Cannot create trace file: " + filename);
+  }
+  *m_trace << "# EleFits access trace\n";
+}
+
+void TraceAccesses::accessed(const Hdu& hdu)
+{
+  record({TraceEvent::Type::Access, hdu.index()});
+}
+
+void TraceAccesses::created(const Hdu& hdu)
+{
+  record({TraceEvent::Type::Access, hdu.index()});
+}
+
+void TraceAccesses::closing(const Hdu&)
+{
+  m_trace->flush();
+}
+
+void TraceAccesses::parsed(const Hdu& hdu, const std::vector<std::string>& keywords)
+{
+  record({TraceEvent::Type::Parse, hdu.index(), keywords});
+}
+
+void TraceAccesses::read(const Hdu& hdu, const DataAccess& access)
+{
+  record({TraceEvent::Type::Read, hdu.index(), {}, access});
+}
+
+void TraceAccesses::written(const Hdu& hdu, const DataAccess& access)
+{
+  record({TraceEvent::Type::Write, hdu.index(), {}, access});
+}
+
+std::vector<TraceEvent> TraceAccesses::load(const std::string& filename)
+{
+  std::ifstream file(filename);
+  if (not file) {
+    throw FitsError("Cannot open trace file: " + filename);
+  }
+  std::vector<TraceEvent> out;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    out.push_back(TraceEvent::from_string(line));
+  }
+  return out;
+}
+
+void TraceAccesses::record(const TraceEvent& event) const
+{
+  *m_trace << event.to_string() << '\n';
+}
+
+} // namespace Fits
@@ -4,12 +4,18 @@
 
 #include "EleFits/BintableColumns.h"
 
+#include "EleFits/Hdu.h"
+
 #include <algorithm> // sort
 
 namespace Fits {
 
-BintableColumns::BintableColumns(fitsfile*& fptr, std::function<void(void)> touch, std::function<void(void)> edit) :
-    m_fptr(fptr), m_touch(touch), m_edit(edit)
+BintableColumns::BintableColumns(
+    fitsfile*& fptr,
+    std::function<void(void)> touch,
+    std::function<void(void)> edit,
+    const Hdu* hdu) :
+    m_fptr(fptr), m_touch(touch), m_edit(edit), m_hdu(hdu)
 {}
 
 Linx::Index BintableColumns::read_column_count() const
@@ -96,4 +102,14 @@ void BintableColumns::remove_n(std::vector<ColumnKey> keys) const
   }
 }
 
+bool BintableColumns::observed() const
+{
+  return m_hdu && m_hdu->observed();
+}
+
+void BintableColumns::notify(DataStage stage, const DataAccess& access) const
+{
+  m_hdu->notify(stage, access);
+}
+
 } // namespace Fits
@@ -4,30 +4,44 @@
 
 #include "EleFits/BintableHdu.h"
 
+#include "EleCfitsioWrapper/CompressionWrapper.h"
+
 namespace Fits {
 
 BintableHdu::BintableHdu(Token token, fitsfile*& fptr, Linx::Index index, HduCategory status) :
     Hdu(token, fptr, index, HduCategory::Bintable, status),
+    m_compressed(), m_decompressed(), m_data_fptr(m_fptr),
     m_columns(
-        m_fptr,
+        m_data_fptr,
         [&]() {
-          touch();
+          m_data_fptr = data_fptr();
         },
         [&]() {
+          if (is_compressed()) {
+            throw FitsError("Cannot edit compressed binary table: " + read_name());
+          }
           edit();
-        })
+          m_data_fptr = m_fptr;
+        },
+        this)
 {}
 
 BintableHdu::BintableHdu() :
     Hdu(),
+    m_compressed(), m_decompressed(), m_data_fptr(m_fptr),
     m_columns(
-        m_fptr,
+        m_data_fptr,
         [&]() {
-          touch();
+          m_data_fptr = data_fptr();
         },
         [&]() {
+          if (is_compressed()) {
+            throw FitsError("Cannot edit compressed binary table: " + read_name());
+          }
           edit();
-        })
+          m_data_fptr = m_fptr;
+        },
+        this)
 {}
 
 const BintableColumns& BintableHdu::columns() const
@@ -43,10 +57,32 @@ Linx::Index BintableHdu::read_column_count() const
 
 Linx::Index BintableHdu::read_row_count() const
 {
-  touch();
+  if (is_compressed()) {
+    return Cfitsio::TableCompression::row_count(m_fptr);
+  }
   return Cfitsio::BintableIo::row_count(m_fptr);
 }
 
+bool BintableHdu::is_compressed() const
+{
+  touch();
+  if (not m_compressed) {
+    m_compressed = Cfitsio::TableCompression::is_compressed(m_fptr);
+  }
+  return *m_compressed;
+}
+
+fitsfile* BintableHdu::data_fptr() const
+{
+  if (not is_compressed()) {
+    return m_fptr;
+  }
+  if (not m_decompressed) {
+    m_decompressed = Cfitsio::TableCompression::decompress_to_memory(m_fptr);
+  }
+  return m_decompressed.get();
+}
+
 HduCategory BintableHdu::category() const
 {
   auto cat = Hdu::category();
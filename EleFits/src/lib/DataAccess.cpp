@@ -0,0 +1,37 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/DataAccess.h"
+
+#include "EleFitsData/ColumnInfo.h"
+#include "EleFitsData/FitsError.h"
+
+#include <complex>
+
+namespace Fits {
+
+std::string DataAccess::type_name() const
+{
+#define ELEFITS_RETURN_TYPE_NAME(T, name) \
+  if (*type == typeid(T)) { \
+    return #name; \
+  }
+  ELEFITS_FOREACH_COLUMN_TYPE(ELEFITS_RETURN_TYPE_NAME)
+#undef ELEFITS_RETURN_TYPE_NAME
+  return "void";
+}
+
+void DataAccess::set_type(const std::string& name)
+{
+#define ELEFITS_SET_TYPE(T, type_name) \
+  if (name == #type_name) { \
+    type = &typeid(T); \
+    return; \
+  }
+  ELEFITS_FOREACH_COLUMN_TYPE(ELEFITS_SET_TYPE)
+#undef ELEFITS_SET_TYPE
+  throw FitsError("Unknown value type name: " + name);
+}
+
+} // namespace Fits
@@ -7,10 +7,11 @@
 #include "EleCfitsioWrapper/HduWrapper.h"
 #include "EleCfitsioWrapper/HeaderWrapper.h"
 #include "EleCfitsioWrapper/ImageWrapper.h"
+#include "EleFits/Strategy.h"
 
 namespace Fits {
 
-Hdu::Hdu(Token, fitsfile*& fptr, Linx::Index index, HduCategory type, HduCategory status) :
+Hdu::Hdu(Token token, fitsfile*& fptr, Linx::Index index, HduCategory type, HduCategory status) :
     m_fptr(fptr), m_cfitsio_index(index + 1), m_type(type),
     m_header(
         m_fptr,
@@ -19,8 +20,9 @@ Hdu::Hdu(Token, fitsfile*& fptr, Linx::Index index, HduCategory type, HduCategor
         },
         [&]() {
           edit();
-        }),
-    m_status(status)
+        },
+        this),
+    m_status(status), m_strategy(token.m_strategy)
 {}
 
 Hdu::Hdu() : Hdu(Token(), m_dummy_fptr, 0, HduCategory::Image, HduCategory::Untouched) {}
@@ -121,6 +123,25 @@ void Hdu::edit() const
   m_status &= HduCategory::Edited;
 }
 
+bool Hdu::observed() const
+{
+  return m_strategy && m_strategy->observes_data();
+}
+
+void Hdu::notify(DataStage stage, const DataAccess& access) const
+{
+  if (m_strategy) {
+    m_strategy->notify(*this, stage, access);
+  }
+}
+
+void Hdu::notify(const std::vector<std::string>& keywords) const
+{
+  if (m_strategy) {
+    m_strategy->parsed(*this, keywords);
+  }
+}
+
 template <>
 const Header& Hdu::as() const
 {
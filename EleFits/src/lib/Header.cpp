@@ -9,10 +9,24 @@
 
 namespace Fits {
 
-Header::Header(fitsfile*& fptr, std::function<void(void)> touch, std::function<void(void)> edit) :
-    m_fptr(fptr), m_touch(touch), m_edit(edit)
+Header::Header(
+    fitsfile*& fptr,
+    std::function<void(void)> touch,
+    std::function<void(void)> edit,
+    const Hdu* hdu) :
+    m_fptr(fptr), m_touch(touch), m_edit(edit), m_hdu(hdu)
 {}
 
+bool Header::observed() const
+{
+  return m_hdu && m_hdu->observed();
+}
+
+void Header::notify(const std::vector<std::string>& keywords) const
+{
+  m_hdu->notify(keywords);
+}
+
 bool Header::has(const std::string& keyword) const
 {
   m_touch();
@@ -47,7 +61,7 @@ std::string Header::read_all(KeywordCategory categories) const
 
 RecordSeq Header::parse_all(KeywordCategory categories) const
 {
-  return parse_n<VariantValue>(read_all_keywords(categories & ~KeywordCategory::Comment));
+  return parse_n<VariantValue>(read_all_keywords(categories & ~KeywordCategory::Comment)); // Notifies
   // TODO return comments as string Records?
 }
 
@@ -20,7 +20,8 @@ ImageHdu::ImageHdu(Token token, fitsfile*& fptr, Linx::Index index, HduCategory
         },
         [&]() {
           edit();
-        })
+        },
+        this)
 {}
 
 ImageHdu::ImageHdu() :
@@ -32,7 +33,8 @@ ImageHdu::ImageHdu() :
         },
         [&]() {
           edit();
-        })
+        },
+        this)
 {}
 
 const ImageHdu& ImageHdu::operator=(const ImageHdu& rhs) const
@@ -41,11 +43,8 @@ const ImageHdu& ImageHdu::operator=(const ImageHdu& rhs) const
   header().write_n(rhs.header().parse_all(KeywordCategory::User)); // FIXME others?
 #define ELEFITS_COPY_HDU(T, _) \
   if (rhs.read_typeid() == typeid(T)) { \
-    const auto r = rhs.raster().template read<T, -1>(); \
-    update_type_shape<T, -1>(r.shape()); \
-    if (r.size()) { \
-      raster().write(r); \
-    } \
+    update_type_shape<T, -1>(rhs.read_shape<-1>()); \
+    m_raster.template stream_from<T>(rhs.raster()); \
     return *this; \
   }
   ELEFITS_FOREACH_RASTER_TYPE(ELEFITS_COPY_HDU)
@@ -4,10 +4,16 @@
 
 #include "EleFits/ImageRaster.h"
 
+#include "EleFits/Hdu.h"
+
 namespace Fits {
 
-ImageRaster::ImageRaster(fitsfile*& fptr, std::function<void(void)> touch, std::function<void(void)> edit) :
-    m_fptr(fptr), m_touch(touch), m_edit(edit)
+ImageRaster::ImageRaster(
+    fitsfile*& fptr,
+    std::function<void(void)> touch,
+    std::function<void(void)> edit,
+    const Hdu* hdu) :
+    m_fptr(fptr), m_touch(touch), m_edit(edit), m_hdu(hdu), m_cache()
 {}
 
 const std::type_info& ImageRaster::read_typeid() const
@@ -27,4 +33,37 @@ Linx::Index ImageRaster::read_size() const
   return shape_size(read_shape<-1>());
 }
 
+std::shared_ptr<TileCache> ImageRaster::cache_tiles(std::size_t byte_budget) const
+{
+  m_cache = std::make_shared<TileCache>(byte_budget);
+  return m_cache;
+}
+
+void ImageRaster::cache_tiles(std::shared_ptr<TileCache> cache) const
+{
+  m_cache = std::move(cache);
+}
+
+const std::shared_ptr<TileCache>& ImageRaster::tile_cache() const
+{
+  return m_cache;
+}
+
+void ImageRaster::invalidate_tiles() const
+{
+  if (m_cache) {
+    m_cache->clear();
+  }
+}
+
+bool ImageRaster::observed() const
+{
+  return m_hdu && m_hdu->observed();
+}
+
+void ImageRaster::notify(DataStage stage, const DataAccess& access) const
+{
+  m_hdu->notify(stage, access);
+}
+
 } // namespace Fits
@@ -4,6 +4,7 @@
 
 #include "EleFits/MefFile.h"
 
+#include "EleCfitsioWrapper/CompressionWrapper.h"
 #include "EleCfitsioWrapper/HduWrapper.h"
 
 namespace Fits {
@@ -16,8 +17,18 @@ void MefFile::open(const std::string& filename, FileMode permission)
 void MefFile::open_impl(const std::string& filename, FileMode permission)
 {
   FitsFile::open(filename, permission);
-  for (const auto& hdu : *this) {
-    m_strategy.opened(hdu);
+  m_lazy = (permission == FileMode::Read);
+  m_counted = not m_lazy;
+  if (m_lazy) {
+    for (const auto& ptr : m_hdus) {
+      if (ptr) {
+        m_strategy.opened(*ptr);
+      }
+    }
+  } else {
+    for (const auto& hdu : *this) {
+      m_strategy.opened(hdu);
+    }
   }
 }
 
@@ -31,8 +42,16 @@ void MefFile::close_impl()
   if (not m_fptr) {
     return;
   }
-  for (const auto& hdu : *this) {
-    m_strategy.closing(hdu);
+  if (m_lazy) { // Don't count HDUs just for closing
+    for (const auto& ptr : m_hdus) {
+      if (ptr) {
+        m_strategy.closing(*ptr);
+      }
+    }
+  } else {
+    for (const auto& hdu : *this) {
+      m_strategy.closing(hdu);
+    }
   }
   FitsFile::close();
 }
@@ -44,6 +63,13 @@ MefFile::~MefFile()
 
 Linx::Index MefFile::hdu_count() const
 {
+  if (not m_counted) {
+    const auto count = std::max(1L, Cfitsio::HduAccess::count(m_fptr));
+    if (count > static_cast<Linx::Index>(m_hdus.size())) {
+      m_hdus.resize(count);
+    }
+    m_counted = true;
+  }
   return m_hdus.size();
 }
 
@@ -80,4 +106,29 @@ const ImageHdu& MefFile::primary()
   return access<ImageHdu>(0);
 }
 
+void MefFile::copy_bintable(const Hdu& hdu)
+{
+  hdu.touch();
+  auto* fptr = hdu.m_fptr;
+  if (Cfitsio::TableCompression::is_compressed(fptr)) {
+    if (m_strategy.compresses_bintables()) {
+      Cfitsio::HduAccess::copy_verbatim(fptr, m_fptr);
+    } else {
+      Cfitsio::TableCompression::decompress(fptr, m_fptr);
+    }
+  } else if (not m_strategy.compress_bintable(fptr, m_fptr)) {
+    Cfitsio::HduAccess::copy_verbatim(fptr, m_fptr);
+  }
+}
+
+const BintableHdu& MefFile::append_staged_bintable(const BintableHdu& staged)
+{
+  const auto index = m_hdus.size();
+  copy_bintable(staged);
+  m_hdus.push_back(std::make_unique<BintableHdu>(Hdu::Token {&m_strategy}, m_fptr, index, HduCategory::Created));
+  const auto& hdu = m_hdus[index]->as<BintableHdu>();
+  m_strategy.created(hdu);
+  return hdu;
+}
+
 } // namespace Fits
@@ -0,0 +1,204 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/MefFilePool.h"
+
+#include "EleCfitsioWrapper/FileWrapper.h"
+
+#include <algorithm> // remove_if
+#include <fcntl.h> // open
+#include <mutex>
+#include <thread>
+#include <unistd.h> // access, close
+#include <unordered_map>
+#include <vector>
+
+namespace Fits {
+namespace Internal {
+
+/**
+ * @brief A `MefFile` which is opened through its own file descriptor, if possible.
+ */
+class PoolHandler {
+public:
+
+  /**
+   * @brief Open the file.
+   * @details
+   * If the pool is concurrent, the file is opened as `/proc/self/fd/<fd>`,
+   * such that CFITSIO does not merge the handler with the other handlers of the same file.
+   */
+  explicit PoolHandler(const std::string& filename) : m_fd(-1), m_file()
+  {
+    if (not MefFilePool::is_concurrent()) {
+      m_file = std::make_unique<MefFile>(filename, FileMode::Read);
+      return;
+    }
+    m_fd = ::open(filename.c_str(), O_RDONLY);
+    if (m_fd == -1) {
+      throw FitsError("Cannot open file: " + filename);
+    }
+    try {
+      m_file = std::make_unique<MefFile>("/proc/self/fd/" + std::to_string(m_fd), FileMode::Read);
+    } catch (...) {
+      ::close(m_fd);
+      throw;
+    }
+  }
+
+  LINX_NON_COPYABLE(PoolHandler)
+  LINX_NON_MOVABLE(PoolHandler)
+
+  /**
+   * @brief Close the file, and then the file descriptor.
+   */
+  ~PoolHandler()
+  {
+    m_file.reset();
+    if (m_fd != -1) {
+      ::close(m_fd);
+    }
+  }
+
+  /**
+   * @brief Get the handler.
+   */
+  MefFile& file()
+  {
+    return *m_file;
+  }
+
+private:
+
+  /** @brief The file descriptor, or -1. */
+  int m_fd;
+
+  /** @brief The handler. */
+  std::unique_ptr<MefFile> m_file;
+};
+
+/**
+ * @brief The shared state of a `MefFilePool`.
+ */
+struct MefFilePoolState {
+  std::string filename; ///< The file name
+  std::unordered_map<std::thread::id, std::unique_ptr<PoolHandler>> handlers; ///< The handlers, by thread
+  std::mutex mutex; ///< The mutex which protects the handler map
+
+  /**
+   * @brief Close the handler of a thread, if any.
+   */
+  void release(std::thread::id id)
+  {
+    std::unique_ptr<PoolHandler> handler;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = handlers.find(id);
+      if (it == handlers.end()) {
+        return;
+      }
+      handler = std::move(it->second);
+      handlers.erase(it);
+    }
+    // Closed outside of the lock
+  }
+};
+
+namespace {
+
+/**
+ * @brief The pools which hold a handler of the thread, which is released when the thread exits.
+ */
+struct ThreadHandlers {
+  std::vector<std::weak_ptr<MefFilePoolState>> states;
+
+  ~ThreadHandlers()
+  {
+    const auto id = std::this_thread::get_id();
+    for (const auto& s : states) {
+      if (auto state = s.lock()) {
+        state->release(id);
+      }
+    }
+  }
+};
+
+thread_local ThreadHandlers thread_handlers;
+
+} // namespace
+} // namespace Internal
+
+MefFilePool::MefFilePool(const std::string& filename) : m_state(std::make_shared<Internal::MefFilePoolState>())
+{
+  m_state->filename = filename;
+  local(); // Fail early if the file cannot be opened
+}
+
+const std::string& MefFilePool::filename() const
+{
+  return m_state->filename;
+}
+
+Linx::Index MefFilePool::hdu_count()
+{
+  return local().hdu_count();
+}
+
+Linx::Index MefFilePool::handler_count() const
+{
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->handlers.size();
+}
+
+bool MefFilePool::is_concurrent()
+{
+  static const bool concurrent = Cfitsio::FileAccess::is_reentrant() && ::access("/proc/self/fd", F_OK) == 0;
+  return concurrent;
+}
+
+MefFile& MefFilePool::local()
+{
+  const auto id = std::this_thread::get_id();
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    auto it = m_state->handlers.find(id);
+    if (it != m_state->handlers.end()) {
+      return it->second->file();
+    }
+    if (not m_state->handlers.empty() && not is_concurrent()) {
+      throw FitsError("Cannot access file from several threads: CFITSIO is not reentrant or /proc is unavailable.");
+    }
+  }
+  auto handler = std::make_unique<Internal::PoolHandler>(m_state->filename); // Open outside of the lock
+  auto& states = Internal::thread_handlers.states;
+  states.erase(
+      std::remove_if(
+          states.begin(),
+          states.end(),
+          [](const auto& s) {
+            return s.expired();
+          }),
+      states.end());
+  states.push_back(m_state);
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  auto& ptr = m_state->handlers[id];
+  ptr = std::move(handler);
+  return ptr->file();
+}
+
+void MefFilePool::release()
+{
+  m_state->release(std::this_thread::get_id());
+}
+
+void MefFilePool::close()
+{
+  std::unordered_map<std::thread::id, std::unique_ptr<Internal::PoolHandler>> handlers;
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    std::swap(handlers, m_state->handlers);
+  }
+}
+
+} // namespace Fits
@@ -0,0 +1,132 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/MefWriter.h"
+
+namespace Fits {
+
+MefWriter::~MefWriter()
+{
+  try {
+    stop();
+  } catch (...) {
+    // Destructors cannot throw: use close() to get the error
+  }
+}
+
+std::size_t MefWriter::byte_budget() const
+{
+  return m_budget;
+}
+
+std::size_t MefWriter::pending_bytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pending_bytes;
+}
+
+Linx::Index MefWriter::hdu_count() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hdu_count;
+}
+
+MefFile& MefWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  wait_empty(lock);
+  may_rethrow();
+  return m_file;
+}
+
+void MefWriter::close()
+{
+  stop();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  may_rethrow();
+}
+
+Linx::Index MefWriter::enqueue(std::function<void(MefFile&)> write, std::size_t bytes)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  may_rethrow();
+  if (m_stopping) {
+    throw FitsError("Cannot append HDU: MefWriter is closed.");
+  }
+  m_released.wait(lock, [&]() {
+    return m_pending_bytes == 0 || m_pending_bytes + bytes <= m_budget || m_error;
+  });
+  may_rethrow();
+  m_queue.push_back({std::move(write), bytes});
+  m_pending_bytes += bytes;
+  const auto index = m_hdu_count;
+  ++m_hdu_count;
+  lock.unlock();
+  m_not_empty.notify_one();
+  return index;
+}
+
+void MefWriter::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_not_empty.wait(lock, [&]() {
+      return not m_queue.empty() || m_stopping;
+    });
+    if (m_queue.empty()) { // Stopping
+      return;
+    }
+    auto task = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_busy = true;
+    if (not m_error) {
+      lock.unlock();
+      try {
+        task.write(m_file);
+      } catch (...) {
+        lock.lock();
+        m_error = std::current_exception();
+        lock.unlock();
+      }
+      task.write = nullptr; // Release the data before notifying producers
+      lock.lock();
+    }
+    m_pending_bytes -= task.bytes;
+    m_busy = false;
+    m_released.notify_all();
+  }
+}
+
+void MefWriter::wait_empty(std::unique_lock<std::mutex>& lock)
+{
+  m_released.wait(lock, [&]() {
+    return m_queue.empty() && not m_busy;
+  });
+}
+
+void MefWriter::may_rethrow()
+{
+  if (m_error) {
+    std::rethrow_exception(m_error);
+  }
+}
+
+void MefWriter::stop()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_stopping) {
+      return;
+    }
+    wait_empty(lock);
+    m_stopping = true;
+  }
+  m_not_empty.notify_one();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  m_file.close();
+}
+
+} // namespace Fits
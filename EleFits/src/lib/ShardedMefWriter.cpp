@@ -0,0 +1,190 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/ShardedMefWriter.h"
+
+#include "EleCfitsioWrapper/FileWrapper.h"
+#include "EleFitsUtils/Parallel.h"
+
+namespace Fits {
+
+ShardedMefWriter::~ShardedMefWriter()
+{
+  try {
+    stop();
+  } catch (...) {
+    // Destructors cannot throw: use close() to get the error
+  }
+}
+
+Linx::Index ShardedMefWriter::worker_count() const
+{
+  return m_workers.size();
+}
+
+Linx::Index ShardedMefWriter::file_count() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_shards.size();
+}
+
+std::size_t ShardedMefWriter::byte_budget() const
+{
+  return m_budget;
+}
+
+std::size_t ShardedMefWriter::pending_bytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pending_bytes;
+}
+
+std::string ShardedMefWriter::filename(const std::string& key) const
+{
+  return m_mapping(key);
+}
+
+void ShardedMefWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_released.wait(lock, [&]() {
+    return m_pending_count == 0;
+  });
+  may_rethrow();
+}
+
+void ShardedMefWriter::close()
+{
+  stop();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  may_rethrow();
+}
+
+void ShardedMefWriter::start(Linx::Index worker_count)
+{
+  // Files are written concurrently only if CFITSIO is thread-safe
+  const auto count = Cfitsio::FileAccess::is_reentrant() ? Parallel::thread_count(worker_count) : 1;
+  m_workers.reserve(count);
+  for (Linx::Index i = 0; i < count; ++i) {
+    m_workers.emplace_back(&ShardedMefWriter::run, this);
+  }
+}
+
+ShardedMefWriter::Location
+ShardedMefWriter::enqueue(const std::string& key, std::function<void(MefFile&)> write, std::size_t bytes)
+{
+  auto filename = m_mapping(key);
+  std::unique_lock<std::mutex> lock(m_mutex);
+  may_rethrow();
+  if (m_stopping) {
+    throw FitsError("Cannot append HDU: ShardedMefWriter is closed.");
+  }
+  m_released.wait(lock, [&]() {
+    return m_pending_bytes == 0 || m_pending_bytes + bytes <= m_budget || m_error;
+  });
+  may_rethrow();
+  auto& shard = m_shards[filename];
+  if (not shard) { // The file is created by the worker, and starts with the Primary
+    shard.reset(new Shard {filename, nullptr, {}, 1, false});
+  }
+  shard->queue.push_back({std::move(write), bytes});
+  m_pending_bytes += bytes;
+  ++m_pending_count;
+  const auto index = shard->hdu_count;
+  ++shard->hdu_count;
+  const bool ready = not shard->scheduled;
+  if (ready) {
+    shard->scheduled = true;
+    m_ready.push_back(shard.get());
+  }
+  lock.unlock();
+  if (ready) {
+    m_ready_cv.notify_one();
+  }
+  return {std::move(filename), index};
+}
+
+void ShardedMefWriter::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_ready_cv.wait(lock, [&]() {
+      return not m_ready.empty() || m_stopping;
+    });
+    if (m_ready.empty()) { // Stopping
+      return;
+    }
+    auto* shard = m_ready.front();
+    m_ready.pop_front();
+    auto task = std::move(shard->queue.front());
+    shard->queue.pop_front();
+    if (not m_error) {
+      lock.unlock();
+      try {
+        if (not shard->file) { // Only one worker at a time handles the shard
+          shard->file = m_open(shard->filename);
+        }
+        task.write(*shard->file);
+      } catch (...) {
+        lock.lock();
+        if (not m_error) {
+          m_error = std::current_exception();
+        }
+        lock.unlock();
+      }
+      task.write = nullptr; // Release the data before notifying producers
+      lock.lock();
+    }
+    m_pending_bytes -= task.bytes;
+    --m_pending_count;
+    if (shard->queue.empty()) {
+      shard->scheduled = false;
+    } else { // Requeue at the back for fairness among files
+      m_ready.push_back(shard);
+      m_ready_cv.notify_one();
+    }
+    m_released.notify_all();
+  }
+}
+
+void ShardedMefWriter::may_rethrow()
+{
+  if (m_error) {
+    std::rethrow_exception(m_error);
+  }
+}
+
+void ShardedMefWriter::stop()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_stopping) {
+      return;
+    }
+    m_released.wait(lock, [&]() {
+      return m_pending_count == 0;
+    });
+    m_stopping = true;
+  }
+  m_ready_cv.notify_all();
+  for (auto& w : m_workers) {
+    if (w.joinable()) {
+      w.join();
+    }
+  }
+  for (auto& s : m_shards) {
+    if (not s.second->file) { // Failed or dropped before the first task
+      continue;
+    }
+    try {
+      s.second->file->close();
+    } catch (...) {
+      if (not m_error) {
+        m_error = std::current_exception();
+      }
+    }
+  }
+}
+
+} // namespace Fits
@@ -0,0 +1,83 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/TileCache.h"
+
+namespace Fits {
+
+TileCache::TileCache(std::size_t byte_budget) :
+    m_budget(byte_budget), m_bytes(0), m_hits(0), m_misses(0), m_entries(), m_index(), m_mutex()
+{}
+
+std::size_t TileCache::byte_budget() const
+{
+  return m_budget;
+}
+
+std::size_t TileCache::size_in_bytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_bytes;
+}
+
+Linx::Index TileCache::tile_count() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+Linx::Index TileCache::hit_count() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+Linx::Index TileCache::miss_count() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+void TileCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_index.clear();
+  m_bytes = 0;
+}
+
+std::shared_ptr<const void> TileCache::find(const Key& key)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(key);
+  if (it == m_index.end()) {
+    ++m_misses;
+    return nullptr;
+  }
+  ++m_hits;
+  m_entries.splice(m_entries.begin(), m_entries, it->second); // Iterators remain valid
+  return it->second->data;
+}
+
+void TileCache::insert(const Key& key, std::shared_ptr<const void> data, std::size_t bytes)
+{
+  if (bytes > m_budget) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_index.count(key)) { // Inserted by another thread in the meantime
+    return;
+  }
+  while (m_bytes + bytes > m_budget) {
+    const auto& lru = m_entries.back();
+    m_bytes -= lru.bytes;
+    m_index.erase(lru.key);
+    m_entries.pop_back();
+  }
+  m_entries.push_front({key, std::move(data), bytes});
+  m_index[key] = m_entries.begin();
+  m_bytes += bytes;
+}
+
+} // namespace Fits
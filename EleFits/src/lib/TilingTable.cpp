@@ -0,0 +1,119 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/TilingTable.h"
+
+#include "EleFitsData/FitsError.h"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace Fits {
+
+namespace {
+
+std::mutex& installed_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::shared_ptr<const TilingTable>& installed_table()
+{
+  static std::shared_ptr<const TilingTable> table;
+  return table;
+}
+
+} // namespace
+
+TilingTable TilingTable::load(const std::string& filename)
+{
+  std::ifstream file(filename);
+  if (not file) {
+    throw FitsError("Cannot open tiling table: " + filename);
+  }
+  TilingTable out;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#' || line.rfind("Algorithm,", 0) == 0) {
+      continue;
+    }
+    std::vector<std::string> cells;
+    std::stringstream row(line);
+    std::string cell;
+    while (std::getline(row, cell, ',')) {
+      cells.push_back(cell);
+    }
+    if (cells.size() < 4) {
+      throw FitsError("Malformed tiling table row: " + line);
+    }
+    std::vector<Linx::Index> lengths;
+    std::stringstream tiling(cells[3]);
+    Linx::Index length;
+    while (tiling >> length) {
+      lengths.push_back(length);
+    }
+    if (lengths.empty() || not tiling.eof()) {
+      throw FitsError("Malformed tiling in tiling table row: " + line);
+    }
+    out.set(cells[0], std::stol(cells[1]), std::stol(cells[2]), Linx::Position<-1>(std::move(lengths)));
+  }
+  return out;
+}
+
+Linx::Index TilingTable::size() const
+{
+  return m_tilings.size();
+}
+
+const Linx::Position<-1>*
+TilingTable::find(const std::string& algorithm, Linx::Index bitpix, Linx::Index dimension) const
+{
+  auto it = m_tilings.find({algorithm, bitpix, dimension});
+  if (it == m_tilings.end()) {
+    it = m_tilings.find({algorithm, 0, dimension});
+  }
+  return it == m_tilings.end() ? nullptr : &it->second;
+}
+
+void TilingTable::set(
+    const std::string& algorithm,
+    Linx::Index bitpix,
+    Linx::Index dimension,
+    Linx::Position<-1> tiling)
+{
+  m_tilings[{algorithm, bitpix, dimension}] = std::move(tiling);
+}
+
+void TilingTable::save(const std::string& filename) const
+{
+  std::ofstream file(filename);
+  if (not file) {
+    throw FitsError("Cannot create tiling table: " + filename);
+  }
+  file << "Algorithm,Bitpix,Dimension,Tiling\n";
+  for (const auto& e : m_tilings) {
+    file << std::get<0>(e.first) << ',' << std::get<1>(e.first) << ',' << std::get<2>(e.first) << ',';
+    for (std::size_t i = 0; i < e.second.size(); ++i) {
+      file << (i == 0 ? "" : " ") << e.second[i];
+    }
+    file << '\n';
+  }
+}
+
+void TilingTable::install(std::shared_ptr<const TilingTable> table)
+{
+  std::lock_guard<std::mutex> lock(installed_mutex());
+  installed_table() = std::move(table);
+}
+
+std::shared_ptr<const TilingTable> TilingTable::installed()
+{
+  std::lock_guard<std::mutex> lock(installed_mutex());
+  return installed_table();
+}
+
+} // namespace Fits
@@ -3,18 +3,31 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "EleFits/MefFile.h"
+#include "EleFits/MefFilePool.h"
+#include "EleFitsUtils/Parallel.h"
 #include "ElementsKernel/ProgramHeaders.h"
 #include "Linx/Run/ProgramOptions.h"
 
+#include <condition_variable>
+#include <exception>
 #include <iomanip> // setw, setfill
+#include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace Fits;
 
-void set_strategy(MefFile& out, const std::string& algo, char lossless)
+void set_strategy(MefFile& out, const std::string& algo, char lossless, bool bintables)
 {
+  if (bintables) {
+    out.strategy(CompressBintables());
+  }
+
   auto type = CompressionType::Lossless;
   if (lossless == 'i') {
     type = CompressionType::LosslessInts;
@@ -59,6 +72,98 @@ void set_strategy(MefFile& out, const std::string& algo, char lossless)
   }
 }
 
+/**
+ * @brief Compress HDUs concurrently in in-memory files, and then append them in order.
+ * @param window The maximum number of HDUs being compressed or waiting to be appended
+ * @details
+ * Each thread reads the input through its own handler (see `MefFilePool`).
+ * HDUs are picked in order, and are appended as soon as all of the previous ones are,
+ * such that at most `window` compressed HDUs are held in memory.
+ */
+void compress_parallel(
+    const std::string& input,
+    MefFile& compressed,
+    Linx::Index first,
+    const std::string& algo,
+    char lossless,
+    bool bintables,
+    long threads,
+    Linx::Index window)
+{
+  Elements::Logging logger = Elements::Logging::getLogger("EleFitsCompress");
+  MefFilePool pool(input);
+  const auto count = pool.hdu_count() - first;
+  std::map<Linx::Index, std::unique_ptr<MefFile>> packed; // Completed but not appended yet
+  Linx::Index next = 0; // Next HDU to be compressed
+  Linx::Index appended = 0; // Number of appended HDUs
+  bool writing = false; // Whether a thread is appending
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable released;
+
+  const auto work = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (next < count && not error) {
+      const auto i = next++;
+      released.wait(lock, [&]() {
+        return i < appended + window || error;
+      });
+      if (error) {
+        break;
+      }
+      lock.unlock();
+      auto out = std::make_unique<MefFile>("mem://", FileMode::Create);
+      try {
+        set_strategy(*out, algo, lossless, bintables);
+        out->append(pool.access<>(first + i));
+      } catch (...) {
+        lock.lock();
+        error = std::current_exception();
+        released.notify_all();
+        break;
+      }
+      lock.lock();
+      packed[i] = std::move(out);
+      if (writing) {
+        continue; // The writing thread will append it
+      }
+      writing = true;
+      for (auto it = packed.find(appended); it != packed.end(); it = packed.find(appended)) {
+        auto ready = std::move(it->second);
+        packed.erase(it);
+        lock.unlock();
+        try {
+          const auto& hdu = (*ready)[1];
+          logger.info() << "  HDU #" << first + appended << ": " << hdu.read_name();
+          compressed.append_verbatim(hdu);
+        } catch (...) {
+          lock.lock();
+          error = std::current_exception();
+          break;
+        }
+        ready.reset(); // Free memory as soon as possible
+        lock.lock();
+        ++appended;
+        released.notify_all();
+      }
+      writing = false;
+      released.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (long t = 1; t < threads; ++t) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto& w : workers) {
+    w.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 int main(int argc, char const* argv[])
 {
   Linx::ProgramOptions options; // FIXME description
@@ -67,6 +172,9 @@ int main(int argc, char const* argv[])
   options.named<std::string>("algo", "Compression algorithm (NONE, GZIP, SGZIP, RICE, HCOMPRESS, PLIO, AUTO)", "AUTO");
   options.named<char>("lossless", "Losslessness: yes (y), no (n), integers only (i)", 'y');
   options.flag("primary", "Compress the Primary (as the first extension)");
+  options.flag("bintables", "Compress binary tables");
+  options.named<long>("threads", "Number of threads to compress HDUs concurrently (0 for hardware threads)", 1);
+  options.named<std::string>("tiling", "Tiling table for adaptive tilings (see EleFitsOptimizeTiling)", "");
   options.parse(argc, argv);
 
   Elements::Logging logger = Elements::Logging::getLogger("EleFitsCompress");
@@ -77,6 +185,13 @@ int main(int argc, char const* argv[])
   const auto algo = options.as<std::string>("algo");
   const auto lossless = options.as<char>("lossless");
   const auto compress_primary = options.as<bool>("primary");
+  const auto compress_bintables = options.as<bool>("bintables");
+  const auto requested_threads = options.as<long>("threads");
+  const auto tiling = options.as<std::string>("tiling");
+  if (not tiling.empty()) {
+    TilingTable::install(std::make_shared<TilingTable>(TilingTable::load(tiling)));
+    logger.info() << "Tiling table: " << tiling;
+  }
 
   /* Open files */
   MefFile raw(input, FileMode::Read);
@@ -90,14 +205,23 @@ int main(int argc, char const* argv[])
     compressed.primary() = raw.primary();
   }
 
-  /* Enable compression (or not) */
-  set_strategy(compressed, algo, lossless);
-
-  /* Loop over HDUs or extensions */
-  for (Linx::Index i = 1 - compress_primary; i < hdu_count; ++i) {
-    const auto& hdu = raw[i];
-    logger.info() << "  HDU #" << i << ": " << hdu.read_name();
-    compressed.append(hdu);
+  /* Compress HDUs concurrently */
+  const Linx::Index first = 1 - compress_primary;
+  const auto threads = MefFilePool::is_concurrent() ? Parallel::thread_count(requested_threads) : 1;
+  if (threads > 1) {
+    logger.info() << "Thread count: " << threads;
+    compress_parallel(input, compressed, first, algo, lossless, compress_bintables, threads, threads * 2);
+  } else {
+
+    /* Enable compression (or not) */
+    set_strategy(compressed, algo, lossless, compress_bintables);
+
+    /* Loop over HDUs or extensions */
+    for (Linx::Index i = first; i < hdu_count; ++i) {
+      const auto& hdu = raw[i];
+      logger.info() << "  HDU #" << i << ": " << hdu.read_name();
+      compressed.append(hdu);
+    }
   }
 
   raw.close();
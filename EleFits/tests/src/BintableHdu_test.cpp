@@ -122,6 +122,49 @@ BOOST_FIXTURE_TEST_CASE(column_renaming_test, Test::TemporaryMefFile)
   }
 }
 
+BOOST_AUTO_TEST_CASE(compressed_bintable_is_read_back_test)
+{
+  constexpr Linx::Index row_count = 10000;
+  Test::RandomScalarColumn<std::int32_t> ints(row_count, 0, 100);
+  ints.rename("INTS");
+  Test::RandomScalarColumn<double> doubles(row_count);
+  doubles.rename("DOUBLES");
+  Test::TemporaryMefFile file;
+  file.strategy(CompressBintables());
+
+  const RecordSeq records {{"FOO", 1}};
+  const auto& ext = file.append_bintable("COMPRESSED", records, ints, doubles);
+  BOOST_TEST(ext.is_compressed());
+  BOOST_TEST(ext.read_name() == "COMPRESSED");
+  BOOST_TEST(ext.header().parse<int>("FOO").value == 1);
+  BOOST_TEST(ext.read_row_count() == row_count);
+  BOOST_TEST(ext.read_column_count() == 2);
+  BOOST_TEST(ext.matches(HduCategory::Data));
+  BOOST_TEST(ext.columns().read_name(1) == "DOUBLES");
+  BOOST_TEST(ext.read_column<std::int32_t>("INTS").container() == ints.container());
+  BOOST_TEST(ext.read_column<double>("DOUBLES").container() == doubles.container());
+  BOOST_CHECK_THROW(ext.write_column(ints), FitsError);
+
+  Test::TemporaryMefFile raw;
+  const auto& copy = raw.append(ext);
+  BOOST_TEST(not copy.is_compressed());
+  BOOST_TEST(copy.read_column<std::int32_t>("INTS").container() == ints.container());
+
+  const auto& verbatim = raw.append_verbatim(ext);
+  BOOST_TEST(verbatim.is_compressed());
+  BOOST_TEST(verbatim.read_column<double>("DOUBLES").container() == doubles.container());
+}
+
+BOOST_AUTO_TEST_CASE(small_bintable_is_not_compressed_test)
+{
+  Test::RandomScalarColumn<float> column(10);
+  Test::TemporaryMefFile file;
+  file.strategy(CompressBintables());
+  const auto& ext = file.append_bintable("SMALL", {}, column);
+  BOOST_TEST(not ext.is_compressed());
+  BOOST_TEST(ext.read_column<float>(column.info().name).container() == column.container());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
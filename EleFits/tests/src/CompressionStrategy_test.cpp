@@ -236,6 +236,93 @@ BOOST_AUTO_TEST_CASE(plio_limit_test)
   raster_bad[0] = limit;
   ImageHdu::Initializer<T> data_bad {1, "", {}, shape, raster_bad.data()};
   BOOST_TEST(not can_compress(algo, data_bad));
+
+  Linx::Raster<T, -1> raster_negative(shape);
+  raster_negative[0] = -1;
+  ImageHdu::Initializer<T> data_negative {1, "", {}, shape, raster_negative.data()};
+  BOOST_TEST(not can_compress(algo, data_negative));
+  BOOST_TEST(data_negative.statistics()->min == -1);
+}
+
+BOOST_AUTO_TEST_CASE(sample_tile_is_copied_from_region_test)
+{
+  using T = std::int32_t;
+  const Linx::Position<-1> shape {6, 5, 4};
+  Linx::Raster<T, -1> raster(shape);
+  for (Linx::Index i = 0; i < raster.size(); ++i) {
+    raster[i] = i;
+  }
+  ImageHdu::Initializer<T> init {1, "", {}, shape, raster.data()};
+  const Linx::Position<-1> front {2, 1, 3};
+  const Linx::Position<-1> tile {3, 2, 1};
+  const auto sample = copy_region(init, Linx::Box<-1>::from_shape(front, tile));
+  const std::vector<T> expected {98, 99, 100, 104, 105, 106}; // Not contiguous in the raster
+  BOOST_TEST(sample == expected);
+}
+
+struct RecordSelection : public Action {
+  explicit RecordSelection(std::vector<CompressionSelection>& selections) : m_selections(selections) {}
+  void selected(const CompressionSelection& selection) override
+  {
+    m_selections.push_back(selection);
+  }
+  std::vector<CompressionSelection>& m_selections;
+};
+
+BOOST_AUTO_TEST_CASE(sampled_compression_is_reported_test)
+{
+  using T = std::int16_t;
+  Linx::Raster<T, 2> raster({256, 256});
+  for (Linx::Index i = 0; i < raster.size(); ++i) {
+    raster[i] = i % 7;
+  }
+  std::vector<CompressionSelection> selections;
+  Test::TemporaryMefFile f;
+  f.strategy(CompressSampled(), RecordSelection(selections));
+
+  const auto& ext = f.append_image("SAMPLED", {}, raster);
+  BOOST_TEST(ext.is_compressed());
+  BOOST_TEST(ext.raster().read<T, 2>() == raster);
+
+  BOOST_TEST(selections.size() == 1);
+  const auto& selection = selections[0];
+  BOOST_TEST(selection.name == "SAMPLED");
+  BOOST_TEST(selection.trials.size() >= 2); // At least Rice and ShuffledGzip
+  const auto* choice = selection.choice();
+  BOOST_REQUIRE(choice);
+  const auto cost = CompressSampled::tradeoff(); // Default cost, i.e. the inverse ratio
+  for (const auto& t : selection.trials) {
+    BOOST_TEST(t.raw_bytes > 0);
+    BOOST_TEST(t.compressed_bytes > 0);
+    BOOST_TEST(cost(*choice) <= cost(t)); // Sample sizes differ with the tilings
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sampled_compression_follows_cost_test)
+{
+  using T = std::int32_t;
+  Linx::Raster<T, 2> raster({128, 128});
+  for (Linx::Index i = 0; i < raster.size(); ++i) {
+    raster[i] = i;
+  }
+  auto prefer_gzip = [](const CompressionTrial& trial) {
+    return trial.algorithm == "ShuffledGzip" ? 0. : 1.;
+  };
+  Test::TemporaryMefFile f;
+  f.strategy(CompressSampled(CompressionType::Lossless, 2, prefer_gzip));
+  const auto& ext = f.append_image("", {}, raster);
+  BOOST_TEST(ext.is_compressed());
+  BOOST_CHECK_NO_THROW(dynamic_cast<const ShuffledGzip&>(*ext.read_compression()));
+}
+
+BOOST_AUTO_TEST_CASE(sampled_compression_without_data_falls_back_test)
+{
+  std::vector<CompressionSelection> selections;
+  Test::TemporaryMefFile f;
+  f.strategy(CompressSampled(), RecordSelection(selections));
+  const auto& ext = f.append_null_image<float>("", {}, Linx::Position<2> {256, 256});
+  BOOST_TEST(ext.is_compressed());
+  BOOST_TEST(selections.empty());
 }
 
 //-----------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 
 #include "EleFits/FitsFileFixture.h"
 #include "EleFits/ImageRaster.h"
+#include "EleFits/MefFile.h"
 #include "EleFitsData/TestRaster.h"
 
 #include <boost/test/unit_test.hpp>
@@ -162,6 +163,64 @@ BOOST_FIXTURE_TEST_CASE(const_data_raster_is_read_back_test, Test::TemporarySifF
   BOOST_TEST(vec == c_data);
 }
 
+BOOST_FIXTURE_TEST_CASE(compressed_image_is_streamed_by_tile_aligned_slabs_test, Test::TemporaryMefFile)
+{
+  const Linx::Position<3> shape {16, 12, 10};
+  const Test::RandomRaster<std::int32_t, 3> input(shape);
+  const auto& src = this->append_image("SRC", {}, input);
+  this->strategy(Rice(Linx::Position<-1> {16, 12, 3}));
+  const auto& dst = this->append_null_image<std::int32_t, 3>("DST", {}, shape);
+  BOOST_TEST(dst.matches(HduCategory::CompressedImageExt));
+  dst.raster().stream_from<std::int32_t>(src.raster(), 1); // Enlarged to one tile-thick slab
+  const auto output = dst.raster().read<std::int32_t, 3>();
+  BOOST_TEST(output.shape() == shape);
+  BOOST_TEST(output.container() == input.container());
+}
+
+BOOST_FIXTURE_TEST_CASE(compressed_image_is_written_in_parallel_test, Test::TemporaryMefFile)
+{
+  const Linx::Position<2> shape {32, 100};
+  const Test::RandomRaster<std::int16_t, 2> input(shape);
+  this->strategy(Gzip(Linx::Position<-1> {32, 8}));
+  const auto& hdu = this->append_null_image<std::int16_t, 2>("GZIP", {}, shape);
+  hdu.raster().write_parallel(input, 4);
+  const auto output = hdu.raster().read<std::int16_t, 2>();
+  BOOST_TEST(output.container() == input.container());
+}
+
+BOOST_FIXTURE_TEST_CASE(compressed_image_is_read_in_parallel_test, Test::TemporaryMefFile)
+{
+  const Linx::Position<2> shape {32, 100};
+  const Test::RandomRaster<std::int32_t, 2> input(shape);
+  this->strategy(Rice(Linx::Position<-1> {16, 8}));
+  const auto& hdu = this->append_image("RICE", {}, input);
+  BOOST_TEST(hdu.matches(HduCategory::CompressedImageExt));
+  const auto output = hdu.raster().read_parallel<std::int32_t, 2>(4);
+  BOOST_TEST(output.container() == input.container());
+}
+
+BOOST_FIXTURE_TEST_CASE(compressed_regions_are_read_through_tile_cache_test, Test::TemporaryMefFile)
+{
+  const Linx::Position<2> shape {30, 20};
+  const Test::RandomRaster<std::int32_t, 2> input(shape);
+  this->strategy(Rice(Linx::Position<-1> {8, 8}));
+  const auto& du = this->append_image("RICE", {}, input).raster();
+  const auto cache = du.cache_tiles(1 << 20);
+  const auto region = Linx::Box<2>::from_shape({5, 3}, {12, 10}); // 3 x 2 tiles
+  const auto first = du.read_region<std::int32_t, 2>(region);
+  BOOST_TEST(cache->miss_count() == 6);
+  BOOST_TEST(cache->hit_count() == 0);
+  const auto second = du.read_region<std::int32_t, 2>(region);
+  BOOST_TEST(cache->miss_count() == 6);
+  BOOST_TEST(cache->hit_count() == 6);
+  for (const auto& p : first.domain()) {
+    BOOST_TEST(first[p] == input[p + region.front()]);
+    BOOST_TEST(second[p] == first[p]);
+  }
+  du.write(input);
+  BOOST_TEST(cache->tile_count() == 0);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/FitsFileFixture.h"
+#include "EleFits/MefFilePool.h"
+#include "EleFitsData/TestRaster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+using namespace Fits;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MefFilePool_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(concurrent_access_test, Test::NewMefFile)
+{
+  const Linx::Index count = 8;
+  std::vector<Test::RandomRaster<std::int32_t, 2>> rasters;
+  for (Linx::Index i = 0; i < count; ++i) {
+    rasters.emplace_back(Linx::Position<2> {32, 16});
+    append_image(std::to_string(i), {}, rasters.back());
+  }
+  close();
+
+  MefFilePool pool(filename());
+  BOOST_TEST(pool.hdu_count() == count + 1);
+  BOOST_TEST(pool.handler_count() == 1);
+
+  const Linx::Index thread_count = MefFilePool::is_concurrent() ? 4 : 0;
+  std::atomic<Linx::Index> mismatch_count(0);
+  std::atomic<Linx::Index> error_count(0);
+  auto read_all = [&]() {
+    try {
+      for (Linx::Index i = 0; i < count; ++i) {
+        const auto& hdu = pool.access<ImageHdu>(i + 1);
+        if (hdu.read_name() != std::to_string(i) || not(hdu.raster().read<std::int32_t>() == rasters[i])) {
+          ++mismatch_count;
+        }
+      }
+    } catch (...) {
+      ++error_count; // Would terminate the program if thrown by a thread
+    }
+  };
+  std::vector<std::thread> threads;
+  for (Linx::Index t = 0; t < thread_count; ++t) {
+    threads.emplace_back(read_all);
+  }
+  read_all();
+  for (auto& t : threads) {
+    t.join();
+  }
+  BOOST_TEST(error_count == 0);
+  BOOST_TEST(mismatch_count == 0);
+  BOOST_TEST(pool.handler_count() == 1); // Handlers of the threads are released at exit
+
+  pool.close();
+  BOOST_TEST(pool.handler_count() == 0);
+  std::remove(filename().c_str());
+}
+
+BOOST_FIXTURE_TEST_CASE(parallel_for_each_test, Test::NewMefFile)
+{
+  const Linx::Index count = 12;
+  std::vector<Test::RandomRaster<float, 2>> rasters;
+  for (Linx::Index i = 0; i < count; ++i) {
+    rasters.emplace_back(Linx::Position<2> {8 * (i + 1), 8});
+    append_image(std::to_string(i), {}, rasters.back());
+    append_image_header("HEADER");
+  }
+  close();
+
+  MefFilePool pool(filename());
+  const Linx::Index thread_count = MefFilePool::is_concurrent() ? 3 : 1;
+  std::vector<Linx::Index> sizes(pool.hdu_count(), -1);
+  pool.parallel_for_each<ImageHdu>(
+      HduCategory::ImageExt - HduCategory::Metadata,
+      [&](const ImageHdu& hdu) {
+        const auto raster = hdu.raster().read<float>();
+        sizes[std::stol(hdu.read_name())] = raster.size();
+      },
+      thread_count);
+  for (Linx::Index i = 0; i < count; ++i) {
+    BOOST_TEST(sizes[i] == rasters[i].size());
+  }
+  BOOST_TEST(pool.handler_count() <= thread_count);
+
+  pool.close();
+  std::remove(filename().c_str());
+}
+
+BOOST_FIXTURE_TEST_CASE(release_test, Test::NewMefFile)
+{
+  close();
+  MefFilePool pool(filename());
+  BOOST_TEST(pool.handler_count() == 1);
+  pool.release();
+  BOOST_TEST(pool.handler_count() == 0);
+  BOOST_TEST(pool.hdu_count() == 1); // Reopened
+  BOOST_TEST(pool.handler_count() == 1);
+  if (MefFilePool::is_concurrent()) {
+    std::thread([&]() {
+      pool.local();
+      BOOST_TEST(pool.handler_count() == 2);
+    }).join();
+    BOOST_TEST(pool.handler_count() == 1);
+  }
+  pool.close();
+  std::remove(filename().c_str());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
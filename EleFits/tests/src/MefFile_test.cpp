@@ -8,8 +8,10 @@
 #include "EleFitsData/TestRaster.h"
 #include "ElementsKernel/Temporary.h"
 
+#include <algorithm> // max
 #include <boost/test/unit_test.hpp>
 #include <cstdio>
+#include <memory>
 
 using namespace Fits;
 
@@ -443,6 +445,64 @@ BOOST_AUTO_TEST_CASE(copy_compressed_to_raw_test)
   check_append_copy(true, false);
 }
 
+/**
+ * @brief An action which records the largest data read.
+ */
+struct MaxReadAction : public Action {
+  bool observes_data() const override
+  {
+    return true;
+  }
+
+  void read(const Hdu&, const DataAccess& access) override
+  {
+    *max_bytes = std::max(*max_bytes, access.bytes);
+    ++*count;
+  }
+
+  std::shared_ptr<Linx::Index> max_bytes = std::make_shared<Linx::Index>(0); ///< Shared by the copies
+  std::shared_ptr<Linx::Index> count = std::make_shared<Linx::Index>(0); ///< Shared by the copies
+};
+
+BOOST_AUTO_TEST_CASE(large_image_copy_is_streamed_with_statistics_test)
+{
+  const Linx::Index buffer_size = ImageRaster::default_buffer_size;
+  const Linx::Position<2> shape {1024, buffer_size / 1024 / sizeof(std::int32_t) + 1}; // Just too large
+  const Test::RandomRaster<std::int32_t, 2> raster(shape, 0, 1000); // Plio-compatible, without DATAMAX
+  MaxReadAction action;
+  Test::TemporaryMefFile in;
+  Test::TemporaryMefFile out;
+  const auto& image = in.append_image("", {}, raster);
+  in.strategy(action);
+  out.strategy(Plio());
+
+  const auto& image_copy = out.append(image);
+  BOOST_TEST(*action.count > 1);
+  BOOST_TEST(*action.max_bytes <= buffer_size);
+  BOOST_TEST(image_copy.is_compressed()); // Plio was selected thanks to the streamed statistics
+  BOOST_CHECK_NO_THROW(dynamic_cast<const Plio&>(*image_copy.read_compression()));
+  BOOST_TEST(image_copy.raster().read<std::int32_t, 2>() == raster);
+}
+
+BOOST_AUTO_TEST_CASE(append_verbatim_keeps_compression_test)
+{
+  Test::RandomRaster<std::int16_t, 2> raster({100, 100});
+  Test::TemporaryMefFile in;
+  Test::TemporaryMefFile out;
+  in.strategy(Rice());
+  const auto& image = in.append_image("IMAGE", {}, raster);
+  const auto& bintable = in.append_bintable_header("TABLE");
+
+  const auto& image_copy = out.append_verbatim(image);
+  BOOST_TEST(image_copy.is_compressed());
+  BOOST_CHECK_NO_THROW(dynamic_cast<const Rice&>(*image_copy.read_compression()));
+  BOOST_TEST(image_copy.read_name() == "IMAGE");
+  BOOST_TEST(image_copy.raster().read<std::int16_t, 2>() == raster);
+  const auto& bintable_copy = out.append_verbatim(bintable);
+  BOOST_TEST(bintable_copy.matches(HduCategory::Bintable));
+  BOOST_TEST(bintable_copy.read_name() == "TABLE");
+}
+
 // This tests the is_compressed function from the ImageWrapper
 BOOST_FIXTURE_TEST_CASE(is_compressed_test, Test::TemporaryMefFile)
 {
@@ -459,6 +519,42 @@ BOOST_FIXTURE_TEST_CASE(is_compressed_test, Test::TemporaryMefFile)
   BOOST_TEST(not image2.is_compressed());
 }
 
+/**
+ * @brief An action which counts the opened HDUs.
+ */
+struct OpenedCounter : public Action {
+  explicit OpenedCounter(Linx::Index& count) : m_count(count) {}
+  void opened(const Hdu&) override
+  {
+    ++m_count;
+  }
+  Linx::Index& m_count;
+};
+
+BOOST_FIXTURE_TEST_CASE(lazy_opening_test, Test::NewMefFile)
+{
+  Test::SmallRaster raster;
+  for (const auto& name : {"A", "B", "C", "D"}) {
+    append_image(name, {}, raster);
+  }
+  close();
+
+  Linx::Index opened_count = 0;
+  MefFile f(filename(), FileMode::Read, OpenedCounter(opened_count));
+  BOOST_TEST(opened_count == 0);
+  BOOST_TEST(f.access<>(2).read_name() == "B"); // Discovered on demand
+  BOOST_TEST(opened_count == 1);
+  BOOST_TEST(f.find("C").index() == 3);
+  BOOST_TEST(opened_count == 2);
+  BOOST_TEST(f.hdu_count() == 5); // Counted on demand
+  BOOST_TEST(opened_count == 2);
+  BOOST_TEST(f[-1].read_name() == "D");
+  BOOST_TEST(opened_count == 3);
+  BOOST_CHECK_THROW(f.access<>(5), FitsError);
+  f.close();
+  std::remove(filename().c_str());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
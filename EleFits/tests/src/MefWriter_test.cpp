@@ -0,0 +1,125 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/FitsFileFixture.h"
+#include "EleFits/MefWriter.h"
+#include "EleFitsData/TestColumn.h"
+#include "EleFitsData/TestRaster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm> // all_of, fill
+#include <cstdio>
+
+using namespace Fits;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MefWriter_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(extensions_are_written_in_order_test)
+{
+  const auto filename = Test::temporary_filename();
+  const Test::RandomRaster<std::int16_t, 2> raster({16, 9});
+  const auto column = Test::RandomTable::generate_column<float>("FLOAT", 2, 10);
+  {
+    MefWriter f(filename, FileMode::Create, 1 << 20);
+    BOOST_TEST(f.hdu_count() == 1);
+    auto copy = raster;
+    BOOST_TEST(f.append_image("MOVED", {}, std::move(copy)) == 1);
+    BOOST_TEST(f.append_image("COPIED", {{"KEY", 1}}, raster) == 2);
+    BOOST_TEST(f.append_bintable("TABLE", {}, column) == 3);
+    BOOST_TEST(f.hdu_count() == 4);
+    f.close();
+  }
+  MefFile f(filename, FileMode::Read);
+  BOOST_TEST(f.hdu_count() == 4);
+  BOOST_TEST(f.access<>(1).read_name() == "MOVED");
+  BOOST_TEST(f.access<ImageRaster>(1).read<std::int16_t>() == raster);
+  BOOST_TEST(f.access<>(2).read_name() == "COPIED");
+  BOOST_TEST(f.access<Header>(2).parse<int>("KEY").value == 1);
+  BOOST_TEST(f.access<ImageRaster>(2).read<std::int16_t>() == raster);
+  BOOST_TEST(f.access<BintableColumns>(3).read<float>("FLOAT").container() == column.container());
+  f.close();
+  std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(non_owning_data_is_deep_copied_test)
+{
+  const auto filename = Test::temporary_filename();
+  std::vector<std::int32_t> pixels(12, 1);
+  std::vector<float> values(5, 2);
+  {
+    MefWriter f(filename, FileMode::Create, 1 << 20);
+    f.append_image("IMAGE", {}, Linx::PtrRaster<std::int32_t, 2>({4, 3}, pixels.data()));
+    f.append_bintable("TABLE", {}, PtrColumn<float>({"FLOAT", "", 1}, values.size(), values.data()));
+    std::fill(pixels.begin(), pixels.end(), 0); // Possibly before the I/O thread has written the data
+    std::fill(values.begin(), values.end(), 0);
+    f.close();
+  }
+  MefFile f(filename, FileMode::Read);
+  const auto raster = f.access<ImageRaster>(1).read<std::int32_t>();
+  BOOST_TEST(std::all_of(raster.begin(), raster.end(), [](auto p) {
+    return p == 1;
+  }));
+  const auto column = f.access<BintableColumns>(2).read<float>("FLOAT");
+  BOOST_TEST(std::all_of(column.begin(), column.end(), [](auto v) {
+    return v == 2;
+  }));
+  f.close();
+  std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(budget_is_respected_test)
+{
+  const auto filename = Test::temporary_filename();
+  const Linx::Position<2> shape {32, 32};
+  const std::size_t bytes = shape_size(shape) * sizeof(float);
+  const Linx::Index count = 10;
+  {
+    MefWriter f(filename, FileMode::Create, 2 * bytes);
+    for (Linx::Index i = 0; i < count; ++i) {
+      f.append_image(std::to_string(i), {}, Test::RandomRaster<float, 2>(shape));
+      BOOST_TEST(f.pending_bytes() <= f.byte_budget());
+    }
+    auto& mef = f.flush();
+    BOOST_TEST(f.pending_bytes() == 0);
+    BOOST_TEST(mef.hdu_count() == count + 1);
+  }
+  MefFile f(filename, FileMode::Read);
+  BOOST_TEST(f.hdu_count() == count + 1);
+  BOOST_TEST(f.access<>(-1).read_name() == std::to_string(count - 1));
+  f.close();
+  std::remove(filename.c_str());
+}
+
+/**
+ * @brief An action which throws when the second extension is created.
+ */
+struct ThrowingAction : public Action {
+  void created(const Hdu& hdu) override
+  {
+    if (hdu.index() == 2) {
+      throw FitsError("Failed on purpose");
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(error_is_rethrown_test)
+{
+  const auto filename = Test::temporary_filename();
+  const Test::RandomRaster<float, 2> raster({8, 8});
+  MefWriter f(filename, FileMode::Create, 1 << 20, ThrowingAction());
+  f.append_image("OK", {}, raster);
+  f.append_image("KO", {}, raster);
+  BOOST_CHECK_THROW(f.flush(), FitsError);
+  BOOST_CHECK_THROW(f.append_image("DROPPED", {}, raster), FitsError);
+  BOOST_CHECK_THROW(f.close(), FitsError);
+  std::remove(filename.c_str());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
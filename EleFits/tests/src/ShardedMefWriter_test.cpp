@@ -0,0 +1,105 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/FitsFileFixture.h"
+#include "EleFits/ShardedMefWriter.h"
+#include "EleFitsData/TestRaster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <map>
+
+using namespace Fits;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(ShardedMefWriter_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(extensions_are_routed_by_key_test)
+{
+  const Linx::Index file_count = 7;
+  std::map<std::string, std::string> filenames;
+  for (Linx::Index i = 0; i < file_count; ++i) {
+    filenames[std::to_string(i)] = Test::temporary_filename();
+  }
+  const Linx::Index count = 30;
+  const Test::RandomRaster<std::int64_t, 2> raster({12, 3});
+  std::vector<ShardedMefWriter::Location> locations;
+  {
+    ShardedMefWriter f(
+        [&](const std::string& key) {
+          return filenames.at(key);
+        },
+        FileMode::Create,
+        2,
+        1 << 20);
+    BOOST_TEST(f.worker_count() <= 2);
+    for (Linx::Index i = 0; i < count; ++i) {
+      const auto key = std::to_string(i % file_count);
+      const auto location = f.append_image(key, std::to_string(i), {}, raster);
+      BOOST_TEST(location.first == filenames.at(key));
+      BOOST_TEST(location.second == i / file_count + 1); // After the Primary
+      locations.push_back(location);
+    }
+    BOOST_TEST(f.file_count() == file_count);
+    f.close();
+  }
+  for (Linx::Index i = 0; i < count; ++i) {
+    MefFile f(locations[i].first, FileMode::Read);
+    const auto& hdu = f.access<ImageHdu>(locations[i].second);
+    BOOST_TEST(hdu.read_name() == std::to_string(i));
+    BOOST_TEST(hdu.raster().read<std::int64_t>() == raster);
+  }
+  for (const auto& filename : filenames) {
+    std::remove(filename.second.c_str());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(existing_files_are_rejected_test)
+{
+  const auto mapping = [](const std::string& key) {
+    return key;
+  };
+  BOOST_CHECK_THROW(ShardedMefWriter(mapping, FileMode::Read, 2, 1 << 20), FitsError);
+  BOOST_CHECK_THROW(ShardedMefWriter(mapping, FileMode::Edit, 2, 1 << 20), FitsError);
+  BOOST_CHECK_THROW(ShardedMefWriter(mapping, FileMode::Write, 2, 1 << 20), FitsError);
+}
+
+/**
+ * @brief An action which throws when the second extension is created.
+ */
+struct ThrowingAction : public Action {
+  void created(const Hdu& hdu) override
+  {
+    if (hdu.index() == 2) {
+      throw FitsError("Failed on purpose");
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(error_is_rethrown_test)
+{
+  const auto filename = Test::temporary_filename();
+  const Test::RandomRaster<float, 2> raster({8, 8});
+  ShardedMefWriter f(
+      [&](const std::string&) {
+        return filename;
+      },
+      FileMode::Create,
+      2,
+      1 << 20,
+      ThrowingAction());
+  f.append_image("", "OK", {}, raster);
+  f.append_image("", "KO", {}, raster);
+  BOOST_CHECK_THROW(f.flush(), FitsError);
+  BOOST_CHECK_THROW(f.append_image("", "DROPPED", {}, raster), FitsError);
+  BOOST_CHECK_THROW(f.close(), FitsError);
+  std::remove(filename.c_str());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
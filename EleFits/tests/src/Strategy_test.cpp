@@ -5,8 +5,12 @@
 #include "EleFits/FitsFileFixture.h"
 #include "EleFits/MefFile.h"
 #include "EleFits/Strategy.h"
+#include "EleFitsData/TestRaster.h"
+#include "ElementsKernel/Temporary.h"
 
+#include <algorithm> // find_if
 #include <boost/test/unit_test.hpp>
+#include <fstream>
 
 using namespace Fits;
 
@@ -54,6 +58,44 @@ struct AfterCreating : Action {
 
 const std::string AfterCreating::keyword = "CREATED";
 
+struct RecordDataAccesses : Action {
+  RecordDataAccesses() : accesses(std::make_shared<std::vector<std::pair<DataStage, DataAccess>>>()) {}
+  bool observes_data() const override
+  {
+    return true;
+  }
+  void reading(const Hdu&, const DataAccess& access) override
+  {
+    accesses->emplace_back(DataStage::Reading, access);
+  }
+  void read(const Hdu&, const DataAccess& access) override
+  {
+    accesses->emplace_back(DataStage::Read, access);
+  }
+  void writing(const Hdu&, const DataAccess& access) override
+  {
+    accesses->emplace_back(DataStage::Writing, access);
+  }
+  void written(const Hdu&, const DataAccess& access) override
+  {
+    accesses->emplace_back(DataStage::Written, access);
+  }
+  std::shared_ptr<std::vector<std::pair<DataStage, DataAccess>>> accesses;
+};
+
+struct RecordParsedKeywords : Action {
+  RecordParsedKeywords() : keywords(std::make_shared<std::vector<std::vector<std::string>>>()) {}
+  bool observes_data() const override
+  {
+    return true;
+  }
+  void parsed(const Hdu&, const std::vector<std::string>& k) override
+  {
+    keywords->push_back(k);
+  }
+  std::shared_ptr<std::vector<std::vector<std::string>>> keywords;
+};
+
 Strategy make_strategy()
 {
   Strategy out;
@@ -137,6 +179,169 @@ BOOST_AUTO_TEST_CASE(ctor_strategy_test)
   BOOST_TEST(copied.has(AfterCopying::keyword));
 }
 
+BOOST_AUTO_TEST_CASE(profile_io_test)
+{
+  using Cfitsio::Profiling::CallClass;
+  ProfileIo profile;
+  Test::RandomRaster<std::int16_t, 2> raster({16, 9});
+  const Linx::Index bytes = raster.size() * sizeof(std::int16_t);
+  {
+    MefFile mef(Test::temporary_filename(), FileMode::Temporary, profile);
+    mef.append_image("IMAGE", {}, raster);
+    mef.access<ImageHdu>(1).raster().read<std::int16_t, 2>();
+  }
+
+  BOOST_TEST(profile.hdus().size() == 2);
+  const auto& image = profile.hdus()[1];
+  BOOST_TEST(image.index == 1);
+  BOOST_TEST(image.name == "IMAGE");
+  BOOST_TEST(image.counters[CallClass::DataWrite].bytes == bytes);
+  BOOST_TEST(image.counters[CallClass::DataRead].bytes == bytes);
+  BOOST_TEST(profile.files().size() == 1);
+  BOOST_TEST(profile.total()[CallClass::DataRead].bytes == bytes);
+}
+
+BOOST_AUTO_TEST_CASE(profile_is_saved_once_closed_test)
+{
+  Elements::TempPath path("%%%%%%.csv");
+  const auto filename = path.path().string();
+  {
+    MefFile mef(Test::temporary_filename(), FileMode::Temporary, ProfileIo(filename));
+    mef.append_image("IMAGE", {}, Test::RandomRaster<std::int16_t, 2>({16, 9}));
+    BOOST_TEST(not std::ifstream(filename));
+  }
+  std::ifstream file(filename);
+  Linx::Index line_count = 0;
+  for (std::string line; std::getline(file, line);) {
+    ++line_count;
+  }
+  BOOST_TEST(line_count == 4); // Header, 2 HDUs, 1 file
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(data_access_hooks_test)
+{
+  RecordDataAccesses action;
+  const auto& accesses = *action.accesses;
+  Test::RandomRaster<std::int16_t, 2> raster({16, 9});
+  VecColumn<std::int32_t> column({"COL", "", 1}, std::vector<std::int32_t>(10));
+  Test::TemporaryMefFile mef;
+  mef.strategy(action);
+
+  const auto& image = mef.append_image("IMAGE", {}, raster);
+  BOOST_TEST(accesses.size() == 2);
+  BOOST_TEST((accesses[0].first == DataStage::Writing));
+  BOOST_TEST((accesses[1].first == DataStage::Written));
+  BOOST_TEST(accesses[1].second.is_image());
+  BOOST_TEST(accesses[1].second.bytes == raster.size() * 2);
+
+  image.raster().read_region<std::int16_t, 2>(Linx::Box<2>::from_shape({2, 3}, {4, 5}));
+  BOOST_TEST(accesses.size() == 4);
+  BOOST_TEST((accesses[2].first == DataStage::Reading));
+  BOOST_TEST((accesses[3].first == DataStage::Read));
+  const auto& region = accesses[3].second;
+  BOOST_TEST(region.front[0] == 2);
+  BOOST_TEST(region.front[1] == 3);
+  BOOST_TEST(region.shape[0] == 4);
+  BOOST_TEST(region.shape[1] == 5);
+  BOOST_TEST(region.bytes == 4 * 5 * 2);
+
+  const auto& table = mef.append_bintable("TABLE", {}, column);
+  BOOST_TEST(accesses.size() == 6);
+  BOOST_TEST((accesses[5].first == DataStage::Written));
+  BOOST_TEST(not accesses[5].second.is_image());
+  BOOST_TEST(accesses[5].second.column == 0);
+  BOOST_TEST(accesses[5].second.rows.front == 0);
+  BOOST_TEST(accesses[5].second.rows.back == 9);
+
+  table.columns().read_segment<std::int32_t>({2, 5}, "COL");
+  BOOST_TEST(accesses.size() == 8);
+  BOOST_TEST((accesses[7].first == DataStage::Read));
+  BOOST_TEST(accesses[7].second.rows.front == 2);
+  BOOST_TEST(accesses[7].second.rows.back == 5);
+  BOOST_TEST(accesses[7].second.bytes == 4 * 4);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(trace_event_string_test)
+{
+  const std::vector<std::string> lines {
+      "A 1",
+      "H 1 NAXIS1 NAXIS2",
+      "R 1 int16 I 2,3 4,5 40",
+      "W 2 string T 1 2 5 32"};
+  for (const auto& line : lines) {
+    BOOST_TEST(TraceEvent::from_string(line).to_string() == line);
+  }
+  const auto event = TraceEvent::from_string(lines[3]);
+  BOOST_TEST((event.type == TraceEvent::Type::Write));
+  BOOST_TEST((*event.data.type == typeid(std::string)));
+  BOOST_TEST(event.data.column == 1);
+  BOOST_CHECK_THROW(TraceEvent::from_string("R 1 int16 X 0 40"), FitsError);
+  BOOST_CHECK_THROW(TraceEvent::from_string("R 1 int128 I 0 1 16"), FitsError);
+}
+
+BOOST_AUTO_TEST_CASE(parse_hooks_test)
+{
+  using Keywords = std::vector<std::string>;
+  RecordParsedKeywords action;
+  const auto& keywords = *action.keywords;
+  Test::TemporaryMefFile mef;
+  mef.strategy(action);
+  const auto& h = mef.primary().header();
+  h.write("I", 1);
+  h.write("F", 3.14F);
+  const auto start = keywords.size();
+
+  h.parse<int>("I");
+  BOOST_TEST(keywords.back() == Keywords {"I"});
+  h.parse_or<int>("I", 0);
+  BOOST_TEST(keywords.back() == Keywords {"I"});
+  h.parse_or<int>("MISSING", 0);
+  BOOST_TEST(keywords.back() == Keywords {"MISSING"});
+  h.parse_n<int>({"I", "F"});
+  BOOST_TEST((keywords.back() == Keywords {"I", "F"}));
+  h.parse_n(as<int>("I"), as<float>("F"));
+  BOOST_TEST((keywords.back() == Keywords {"I", "F"}));
+  h.parse_n_or(Record<int>("I", 0), Record<float>("MISSING", 0));
+  BOOST_TEST((keywords.back() == Keywords {"I", "MISSING"}));
+  h.parse_n_or(std::make_tuple(Record<int>("MISSING", 0), Record<float>("F", 0)));
+  BOOST_TEST((keywords.back() == Keywords {"MISSING", "F"}));
+  const auto count = keywords.size();
+  const auto all = h.parse_all(KeywordCategory::User);
+  BOOST_TEST(keywords.size() == count + 1);
+  BOOST_TEST(keywords.back().size() == all.vector.size());
+  BOOST_TEST(count == start + 7);
+}
+
+BOOST_AUTO_TEST_CASE(trace_accesses_test)
+{
+  Elements::TempPath trace("%%%%%%.txt");
+  Test::RandomRaster<float, 2> raster({16, 9});
+  {
+    Test::TemporaryMefFile mef;
+    mef.strategy(TraceAccesses(trace.path().string()));
+    const auto& image = mef.append_image("IMAGE", {}, raster);
+    image.header().parse<std::string>("EXTNAME");
+    image.raster().read_region<float, 2>(Linx::Box<2>::from_shape({2, 3}, {4, 5}));
+  }
+
+  const auto events = TraceAccesses::load(trace.path().string());
+  BOOST_TEST(events.size() >= 4);
+  BOOST_TEST((events.front().type == TraceEvent::Type::Access));
+  const auto& read = events.back();
+  BOOST_TEST((read.type == TraceEvent::Type::Read));
+  BOOST_TEST(read.hdu == 1);
+  BOOST_TEST((*read.data.type == typeid(float)));
+  BOOST_TEST(read.data.bytes == 4 * 5 * 4);
+  const auto parse = std::find_if(events.begin(), events.end(), [](const auto& e) {
+    return e.type == TraceEvent::Type::Parse && e.keywords == std::vector<std::string> {"EXTNAME"};
+  });
+  BOOST_TEST((parse != events.end()));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,76 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/TileCache.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Fits;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(TileCache_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(tiles_are_loaded_once_test)
+{
+  TileCache cache(1024);
+  Linx::Index load_count = 0;
+  auto load = [&]() {
+    ++load_count;
+    return std::vector<int>(10, 42);
+  };
+  const auto a = cache.get<int>(0, load);
+  const auto b = cache.get<int>(0, load);
+  BOOST_TEST(load_count == 1);
+  BOOST_TEST(a == b);
+  BOOST_TEST(cache.hit_count() == 1);
+  BOOST_TEST(cache.miss_count() == 1);
+  BOOST_TEST(cache.tile_count() == 1);
+  BOOST_TEST(cache.size_in_bytes() == 10 * sizeof(int));
+
+  cache.get<double>(0, []() {
+    return std::vector<double>(10, 42);
+  });
+  BOOST_TEST(cache.tile_count() == 2); // Types are cached separately
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_used_tiles_are_evicted_test)
+{
+  TileCache cache(3 * sizeof(char));
+  auto load = []() {
+    return std::vector<char>(1, 'a');
+  };
+  cache.get<char>(0, load);
+  cache.get<char>(1, load);
+  cache.get<char>(2, load);
+  cache.get<char>(0, load); // 1 becomes the least recently used
+  cache.get<char>(3, load); // Evicts 1
+  BOOST_TEST(cache.tile_count() == 3);
+  BOOST_TEST(cache.size_in_bytes() <= cache.byte_budget());
+  const auto misses = cache.miss_count();
+  cache.get<char>(0, load);
+  cache.get<char>(2, load);
+  cache.get<char>(3, load);
+  BOOST_TEST(cache.miss_count() == misses);
+  cache.get<char>(1, load);
+  BOOST_TEST(cache.miss_count() == misses + 1);
+}
+
+BOOST_AUTO_TEST_CASE(too_large_tiles_are_not_cached_test)
+{
+  TileCache cache(4);
+  const auto tile = cache.get<char>(0, []() {
+    return std::vector<char>(5, 'a');
+  });
+  BOOST_TEST(tile->size() == 5);
+  BOOST_TEST(cache.tile_count() == 0);
+  cache.clear();
+  BOOST_TEST(cache.size_in_bytes() == 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/CompressionStrategy.h"
+#include "EleFits/TilingTable.h"
+#include "ElementsKernel/Temporary.h"
+
+#include <boost/test/unit_test.hpp>
+#include <memory>
+
+using namespace Fits;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(TilingTable_test)
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Install a tiling table for the lifetime of the object.
+ */
+struct InstalledTable {
+  explicit InstalledTable(std::shared_ptr<const TilingTable> table)
+  {
+    TilingTable::install(std::move(table));
+  }
+  ~InstalledTable()
+  {
+    TilingTable::install(nullptr);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(bitpix_fallback_test)
+{
+  TilingTable table;
+  BOOST_TEST(table.size() == 0);
+  BOOST_TEST(not table.find("Rice", 16, 2));
+
+  table.set("Rice", 0, 2, {256, 256});
+  table.set("Rice", 16, 2, Tile::rowwise(8));
+  BOOST_TEST(table.size() == 2);
+  BOOST_TEST((*table.find("Rice", 16, 2) == Tile::rowwise(8)));
+  BOOST_TEST((*table.find("Rice", 32, 2) == Linx::Position<-1> {256, 256}));
+  BOOST_TEST(not table.find("Gzip", 16, 2));
+}
+
+BOOST_AUTO_TEST_CASE(dimension_mismatch_test)
+{
+  TilingTable table;
+  table.set("Rice", 0, 2, {256, 256});
+  table.set("Rice", 16, 3, {64, 64, 1});
+  BOOST_TEST((*table.find("Rice", 16, 3) == Linx::Position<-1> {64, 64, 1}));
+  BOOST_TEST(not table.find("Rice", 32, 3));
+  BOOST_TEST(not table.find("Rice", 16, 1));
+}
+
+BOOST_AUTO_TEST_CASE(save_load_test)
+{
+  TilingTable table;
+  table.set("HCompress", 16, 2, Tile::rowwise(16));
+  table.set("Gzip", -32, 3, {64, 64, 1});
+  Elements::TempPath path("%%%%%%.csv");
+  const auto filename = path.path().string();
+  table.save(filename);
+
+  const auto loaded = TilingTable::load(filename);
+  BOOST_TEST(loaded.size() == 2);
+  BOOST_TEST((*loaded.find("HCompress", 16, 2) == Tile::rowwise(16)));
+  BOOST_TEST((*loaded.find("Gzip", -32, 3) == Linx::Position<-1> {64, 64, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(installed_table_drives_adaptive_tiling_test)
+{
+  using T = std::int16_t;
+  auto table = std::make_shared<TilingTable>();
+  table->set("Rice", 0, 2, {128, 128});
+  table->set("HCompress", 16, 2, Tile::rowwise(32));
+  auto installed = std::make_unique<InstalledTable>(table);
+
+  ImageHdu::Initializer<T> init {1, "", {}, {1000, 1000}, nullptr};
+  Rice rice;
+  adapt_tiling(rice, init);
+  BOOST_TEST((rice.tiling() == Linx::Position<-1> {128, 128}));
+
+  ImageHdu::Initializer<T> cube {1, "", {}, {1000, 1000, 3}, nullptr};
+  adapt_tiling(rice, cube); // 2D entry, fallback
+  BOOST_TEST((rice.tiling() != Linx::Position<-1> {128, 128}));
+
+  HCompress hcompress;
+  adapt_tiling(hcompress, init); // 1000 % 32 == 8
+  BOOST_TEST((hcompress.tiling() == Tile::rowwise(32)));
+
+  ImageHdu::Initializer<T> bad {1, "", {}, {1000, 1026}, nullptr};
+  adapt_tiling(hcompress, bad); // 1026 % 32 == 2, fallback
+  BOOST_TEST((hcompress.tiling() != Tile::rowwise(32)));
+
+  installed.reset();
+  adapt_tiling(rice, init);
+  BOOST_TEST((rice.tiling() != Linx::Position<-1> {128, 128}));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,98 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITSDATA_IMAGESTATISTICS_H
+#define _ELEFITSDATA_IMAGESTATISTICS_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <vector>
+
+namespace Fits {
+
+/**
+ * @ingroup compression
+ * @brief Summary statistics of image data, as used to select compression parameters.
+ *
+ * Non-finite values are counted as NaNs and ignored by the other statistics.
+ *
+ * The noise is estimated like CFITSIO does before quantization,
+ * i.e. as the median absolute deviation of the third order differences
+ * (`noise = 0.6052697 * median(|2 x[i] - x[i-2] - x[i+2]|)`),
+ * yet over the whole data instead of tile-wise.
+ * For large data, the differences are subsampled.
+ *
+ * Data which does not fit in memory can be processed by consecutive chunks with an `Accumulator`,
+ * which yields the same statistics as `from_data()`,
+ * except that the few differences which straddle two chunks are skipped.
+ */
+struct ImageStatistics {
+
+  /**
+   * @brief Statistics computation over consecutive chunks of data.
+   */
+  class Accumulator {
+  public:
+
+    /**
+     * @brief Constructor.
+     * @param size The total number of values
+     * @param max_samples The maximum number of differences used to estimate the noise
+     */
+    explicit Accumulator(Linx::Index size, Linx::Index max_samples = 1 << 20);
+
+    /**
+     * @brief Process the next chunk of data.
+     */
+    template <typename T>
+    void push(const T* data, Linx::Index size);
+
+    /**
+     * @brief Get the statistics of the data pushed so far.
+     */
+    ImageStatistics statistics();
+
+  private:
+
+    Linx::Index m_size; ///< The total number of values
+    Linx::Index m_step; ///< The subsampling step of the differences
+    Linx::Index m_offset; ///< The index of the next value to be pushed
+    double m_min; ///< The current minimum
+    double m_max; ///< The current maximum
+    Linx::Index m_nan_count; ///< The current number of non-finite values
+    std::vector<double> m_differences; ///< The absolute differences
+  };
+
+  /**
+   * @brief Compute the statistics of some data.
+   * @param data The values
+   * @param size The number of values
+   * @param max_samples The maximum number of differences used to estimate the noise
+   */
+  template <typename T>
+  static ImageStatistics from_data(const T* data, Linx::Index size, Linx::Index max_samples = 1 << 20);
+
+  /**
+   * @brief Check whether all of the finite values are equal.
+   */
+  bool is_constant() const
+  {
+    return min == max;
+  }
+
+  double min; ///< The minimum finite value, or 0 if there is none
+  double max; ///< The maximum finite value, or 0 if there is none
+  Linx::Index nan_count; ///< The number of non-finite values
+  double noise; ///< The noise estimate, or 0 if there are too few values
+};
+
+} // namespace Fits
+
+/// @cond INTERNAL
+#define _ELEFITSDATA_IMAGESTATISTICS_IMPL
+#include "EleFitsData/impl/ImageStatistics.hpp"
+#undef _ELEFITSDATA_IMAGESTATISTICS_IMPL
+/// @endcond
+
+#endif
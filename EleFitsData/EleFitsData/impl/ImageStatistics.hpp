@@ -0,0 +1,82 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#if defined(_ELEFITSDATA_IMAGESTATISTICS_IMPL) || defined(CHECK_QUALITY)
+
+#include "EleFitsData/ImageStatistics.h"
+
+#include <algorithm> // max, min, nth_element
+#include <cmath> // abs, isfinite
+#include <limits>
+#include <vector>
+
+namespace Fits {
+
+inline ImageStatistics::Accumulator::Accumulator(Linx::Index size, Linx::Index max_samples) :
+    m_size(size), m_step(std::max<Linx::Index>((size - 4) / max_samples, 1)), m_offset(0),
+    m_min(std::numeric_limits<double>::infinity()), m_max(-m_min), m_nan_count(0), m_differences()
+{
+  if (size > 4) {
+    m_differences.reserve((size - 4) / m_step + 1);
+  }
+}
+
+template <typename T>
+void ImageStatistics::Accumulator::push(const T* data, Linx::Index size)
+{
+  // Extrema and NaN count
+  for (const auto* it = data; it != data + size; ++it) {
+    const double value = *it;
+    if (std::isfinite(value)) {
+      m_min = std::min(m_min, value);
+      m_max = std::max(m_max, value);
+    } else {
+      ++m_nan_count;
+    }
+  }
+
+  // Subsampled third order differences, at global indices 2 + k * step, which lie in the chunk
+  const auto begin = std::max<Linx::Index>(m_offset + 2, 2);
+  const auto first = begin + (m_step - (begin - 2) % m_step) % m_step;
+  const auto end = std::min(m_offset + size - 2, m_size - 2);
+  for (auto i = first; i < end; i += m_step) {
+    const auto* x = data + (i - m_offset);
+    const double difference = 2. * x[0] - x[-2] - x[2];
+    if (std::isfinite(difference)) {
+      m_differences.push_back(std::abs(difference));
+    }
+  }
+  m_offset += size;
+}
+
+inline ImageStatistics ImageStatistics::Accumulator::statistics()
+{
+  ImageStatistics out {0., 0., m_nan_count, 0.};
+  if (m_nan_count == m_offset) {
+    return out;
+  }
+  out.min = m_min;
+  out.max = m_max;
+
+  // Noise from the median absolute difference
+  if (m_min == m_max || m_differences.empty()) {
+    return out;
+  }
+  auto median = m_differences.begin() + m_differences.size() / 2;
+  std::nth_element(m_differences.begin(), median, m_differences.end());
+  out.noise = 0.6052697 * *median;
+  return out;
+}
+
+template <typename T>
+ImageStatistics ImageStatistics::from_data(const T* data, Linx::Index size, Linx::Index max_samples)
+{
+  Accumulator accumulator(size, max_samples);
+  accumulator.push(data, size);
+  return accumulator.statistics();
+}
+
+} // namespace Fits
+
+#endif
@@ -0,0 +1,96 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsData/ImageStatistics.h"
+
+#include <algorithm> // min
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Fits;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(ImageStatistics_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(constant_data_test)
+{
+  std::vector<short> data(1000, 7);
+  const auto stats = ImageStatistics::from_data(data.data(), data.size());
+  BOOST_TEST(stats.min == 7);
+  BOOST_TEST(stats.max == 7);
+  BOOST_TEST(stats.is_constant());
+  BOOST_TEST(stats.nan_count == 0);
+  BOOST_TEST(stats.noise == 0);
+}
+
+BOOST_AUTO_TEST_CASE(nans_are_counted_and_ignored_test)
+{
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  const auto inf = std::numeric_limits<float>::infinity();
+  std::vector<float> data {nan, -1, 2, inf, 3, nan, 0, -inf};
+  const auto stats = ImageStatistics::from_data(data.data(), data.size());
+  BOOST_TEST(stats.min == -1);
+  BOOST_TEST(stats.max == 3);
+  BOOST_TEST(stats.nan_count == 4);
+  BOOST_TEST(std::isfinite(stats.noise));
+}
+
+BOOST_AUTO_TEST_CASE(nan_data_test)
+{
+  std::vector<double> data(10, std::numeric_limits<double>::quiet_NaN());
+  const auto stats = ImageStatistics::from_data(data.data(), data.size());
+  BOOST_TEST(stats.nan_count == 10);
+  BOOST_TEST(stats.min == 0);
+  BOOST_TEST(stats.max == 0);
+  BOOST_TEST(stats.noise == 0);
+}
+
+BOOST_AUTO_TEST_CASE(gaussian_noise_is_estimated_test)
+{
+  constexpr double sigma = 10;
+  std::mt19937 generator(42);
+  std::normal_distribution<double> distribution(1000, sigma);
+  std::vector<double> data(100000);
+  for (auto& e : data) {
+    e = distribution(generator);
+  }
+  const auto stats = ImageStatistics::from_data(data.data(), data.size());
+  BOOST_TEST(stats.noise > sigma * 0.95);
+  BOOST_TEST(stats.noise < sigma * 1.05);
+  const auto subsampled = ImageStatistics::from_data(data.data(), data.size(), 10000);
+  BOOST_TEST(subsampled.noise > sigma * 0.9);
+  BOOST_TEST(subsampled.noise < sigma * 1.1);
+}
+
+BOOST_AUTO_TEST_CASE(chunked_statistics_match_whole_data_statistics_test)
+{
+  std::mt19937 generator(42);
+  std::normal_distribution<double> distribution(1000, 10);
+  std::vector<double> data(100000);
+  for (auto& e : data) {
+    e = distribution(generator);
+  }
+  data[12345] = std::numeric_limits<double>::quiet_NaN();
+  const auto expected = ImageStatistics::from_data(data.data(), data.size(), 10000);
+  ImageStatistics::Accumulator accumulator(data.size(), 10000);
+  const Linx::Index chunk_size = 999;
+  for (Linx::Index i = 0; i < Linx::Index(data.size()); i += chunk_size) {
+    accumulator.push(data.data() + i, std::min<Linx::Index>(chunk_size, data.size() - i));
+  }
+  const auto stats = accumulator.statistics();
+  BOOST_TEST(stats.min == expected.min);
+  BOOST_TEST(stats.max == expected.max);
+  BOOST_TEST(stats.nan_count == 1);
+  BOOST_TEST(stats.noise == expected.noise, boost::test_tools::tolerance(0.01));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
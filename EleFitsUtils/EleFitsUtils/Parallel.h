@@ -0,0 +1,90 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITSUTILS_PARALLEL_H
+#define _ELEFITSUTILS_PARALLEL_H
+
+#include <deque>
+#include <mutex>
+
+namespace Fits {
+
+/**
+ * @brief Multi-threading utilities.
+ */
+namespace Parallel {
+
+/**
+ * @brief Get the number of threads to be used.
+ * @param requested The requested number of threads, or 0 for the number of hardware threads
+ * @return The requested number if positive, or the number of hardware threads (at least 1) otherwise
+ */
+long thread_count(long requested = 0);
+
+/**
+ * @brief Call a function on each index of a range in parallel, with work stealing.
+ * @param count The number of indices, i.e. the range is `[0, count)`
+ * @param func The function, with signature `void(long index, long worker)`
+ * @param threads The number of threads, or 0 for the number of hardware threads
+ * @details
+ * Each worker is first assigned a contiguous block of indices, which it processes in increasing order.
+ * When a worker has processed its own block, it steals the last indices of the other workers,
+ * such that the load is balanced even when the processing time varies from one index to the other.
+ * The calling thread is worker 0, such that no thread is spawned if `threads` is 1.
+ *
+ * If a call throws, no new index is processed, and the first exception is rethrown once all workers are done.
+ */
+template <typename TFunc>
+void for_each_index(long count, TFunc&& func, long threads = 0);
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A work queue of indices, which can be popped from the front by the owner and stolen from the back.
+ */
+class WorkDeque {
+public:
+
+  /**
+   * @brief Enqueue the indices of `[begin, end)`.
+   */
+  void assign(long begin, long end);
+
+  /**
+   * @brief Pop the front index (owner side).
+   * @return `false` if the queue is empty.
+   */
+  bool pop(long& index);
+
+  /**
+   * @brief Pop the back index (thief side).
+   * @return `false` if the queue is empty.
+   */
+  bool steal(long& index);
+
+private:
+
+  /**
+   * @brief The indices.
+   */
+  std::deque<long> m_indices;
+
+  /**
+   * @brief The mutex.
+   */
+  std::mutex m_mutex;
+};
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Parallel
+} // namespace Fits
+
+#define _ELEFITSUTILS_PARALLEL_IMPL
+#include "EleFitsUtils/impl/Parallel.hpp"
+#undef _ELEFITSUTILS_PARALLEL_IMPL
+
+#endif
@@ -0,0 +1,77 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#if defined(_ELEFITSUTILS_PARALLEL_IMPL) || defined(CHECK_QUALITY)
+
+#include "EleFitsUtils/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace Fits {
+namespace Parallel {
+
+template <typename TFunc>
+void for_each_index(long count, TFunc&& func, long threads)
+{
+  const auto worker_count = std::min(thread_count(threads), std::max(count, 1L));
+  if (worker_count == 1) {
+    for (long i = 0; i < count; ++i) {
+      func(i, 0L);
+    }
+    return;
+  }
+
+  std::vector<Internal::WorkDeque> deques(worker_count);
+  for (long w = 0; w < worker_count; ++w) {
+    deques[w].assign(count * w / worker_count, count * (w + 1) / worker_count);
+  }
+
+  std::atomic<bool> cancelled(false);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto work = [&](long w) {
+    long index = 0;
+    while (not cancelled) {
+      bool found = deques[w].pop(index);
+      for (long k = 1; k < worker_count && not found; ++k) {
+        found = deques[(w + k) % worker_count].steal(index);
+      }
+      if (not found) {
+        return;
+      }
+      try {
+        func(index, w);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (not error) {
+          error = std::current_exception();
+        }
+        cancelled = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count - 1);
+  for (long w = 1; w < worker_count; ++w) {
+    workers.emplace_back(work, w);
+  }
+  work(0);
+  for (auto& t : workers) {
+    t.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace Parallel
+} // namespace Fits
+
+#endif
@@ -0,0 +1,57 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsUtils/Parallel.h"
+
+#include <thread>
+
+namespace Fits {
+namespace Parallel {
+
+long thread_count(long requested)
+{
+  if (requested > 0) {
+    return requested;
+  }
+  const long hardware = std::thread::hardware_concurrency();
+  return hardware > 0 ? hardware : 1;
+}
+
+namespace Internal {
+
+void WorkDeque::assign(long begin, long end)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_indices.clear();
+  for (long i = begin; i < end; ++i) {
+    m_indices.push_back(i);
+  }
+}
+
+bool WorkDeque::pop(long& index)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_indices.empty()) {
+    return false;
+  }
+  index = m_indices.front();
+  m_indices.pop_front();
+  return true;
+}
+
+bool WorkDeque::steal(long& index)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_indices.empty()) {
+    return false;
+  }
+  index = m_indices.back();
+  m_indices.pop_back();
+  return true;
+}
+
+} // namespace Internal
+
+} // namespace Parallel
+} // namespace Fits
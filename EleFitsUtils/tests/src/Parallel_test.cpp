@@ -0,0 +1,73 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsUtils/Parallel.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+
+using namespace Fits;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Parallel_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(thread_count_test)
+{
+  BOOST_TEST(Parallel::thread_count(3) == 3);
+  BOOST_TEST(Parallel::thread_count(0) >= 1);
+}
+
+BOOST_AUTO_TEST_CASE(each_index_is_processed_once_test)
+{
+  const long count = 1000;
+  const long threads = 4;
+  std::vector<int> calls(count, 0);
+  std::vector<long> workers(count, -1);
+  Parallel::for_each_index(
+      count,
+      [&](long i, long w) {
+        ++calls[i]; // Each index is processed by a single worker, no race
+        workers[i] = w;
+      },
+      threads);
+  for (long i = 0; i < count; ++i) {
+    BOOST_TEST(calls[i] == 1);
+    BOOST_TEST(workers[i] >= 0);
+    BOOST_TEST(workers[i] < threads);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(empty_range_test)
+{
+  long calls = 0;
+  Parallel::for_each_index(
+      0,
+      [&](long, long) {
+        ++calls;
+      },
+      4);
+  BOOST_TEST(calls == 0);
+}
+
+BOOST_AUTO_TEST_CASE(exception_is_rethrown_test)
+{
+  BOOST_CHECK_THROW(
+      Parallel::for_each_index(
+          100,
+          [](long i, long) {
+            if (i == 42) {
+              throw std::runtime_error("Failed on purpose");
+            }
+          },
+          4),
+      std::runtime_error);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
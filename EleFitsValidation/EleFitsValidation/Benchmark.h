@@ -8,8 +8,12 @@
 #include "EleFitsData/Column.h"
 #include "EleFitsData/DataUtils.h"
 #include "EleFitsData/Raster.h"
+#include "EleFitsData/Segment.h"
 #include "EleFitsValidation/Chronometer.h"
+#include "EleFitsValidation/CsvAppender.h"
+#include "EleFitsValidation/MemoryMonitor.h"
 #include "ElementsKernel/Logging.h"
+#include "Linx/Data/Box.h"
 
 #include <memory>
 #include <tuple>
@@ -34,7 +38,7 @@ using BColumns = std::tuple<
     VecColumn<double>,
     VecColumn<std::complex<float>>,
     VecColumn<std::complex<double>>,
-    // VecColumn<std::string>, //TODO to be handled specially
+    // VecColumn<std::string>, // See Benchmark::write_wide_bintables()
     VecColumn<char>,
     VecColumn<std::uint32_t>,
     VecColumn<std::uint64_t>>;
@@ -46,8 +50,104 @@ constexpr std::size_t ColumnCount = std::tuple_size<BColumns>::value;
 
 /**
  * @brief The chronometer used for benchmarking.
+ * @details
+ * Increments are measured in nanoseconds, such that fast operations do not round to zero,
+ * and are converted to milliseconds for reporting.
  */
-using BChronometer = Chronometer<std::chrono::milliseconds>;
+using BChronometer = Chronometer<std::chrono::nanoseconds>;
+
+/**
+ * @brief The patterns of image region reads.
+ */
+enum class RegionPattern {
+  Random, ///< Regions at random positions
+  Sequential, ///< Adjacent regions in row-major order
+  Strips ///< Adjacent regions which span the whole image but along the last axis
+};
+
+/**
+ * @brief Parse a region pattern from its lower-case name, e.g. "random".
+ */
+RegionPattern parse_region_pattern(const std::string& name);
+
+/**
+ * @brief Generate regions of an image according to some pattern.
+ * @param shape The image shape
+ * @param pattern The pattern
+ * @param side The side length of the regions, or thickness of the strips
+ * @param count The number of regions
+ * @param seed The random seed
+ * @details
+ * Regions are clipped to the image shape:
+ * the side length is clipped to the image lengths,
+ * and the last sequential regions or strip along each axis are clipped if the lengths are not multiples of the side.
+ * Sequential regions and strips wrap around to the image front once the image is covered.
+ */
+std::vector<Linx::Box<-1>> make_regions(
+    const Linx::Position<-1>& shape,
+    RegionPattern pattern,
+    Linx::Index side,
+    Linx::Index count,
+    std::size_t seed = 0);
+
+/**
+ * @brief Loop over the column value types of the wide binary table benchmarks.
+ * @see Benchmark::write_wide_bintables()
+ */
+#define ELEFITS_BENCHMARK_FOREACH_WIDE_COLUMN_TYPE(MACRO) \
+  MACRO(double, double) \
+  MACRO(std::string, string)
+
+/**
+ * @brief The ways of reading a subset of columns.
+ */
+enum class ColumnReadMode {
+  ReadN, ///< Read the whole columns at once (`BintableColumns::read_n()`), even for a row segment
+  ReadNSegments, ///< Read the row segment of the columns at once (`BintableColumns::read_n_segments()`)
+  PerColumn ///< Read the row segment column by column (`BintableColumns::read_segment()`)
+};
+
+/**
+ * @brief Parse a column read mode from its name, i.e. "read_n", "read_n_segments" or "per_column".
+ */
+ColumnReadMode parse_column_read_mode(const std::string& name);
+
+/**
+ * @brief Select evenly spaced column indices.
+ * @param column_count The number of columns of the table
+ * @param selected_count The number of columns to be selected
+ */
+std::vector<Linx::Index> make_column_subset(Linx::Index column_count, Linx::Index selected_count);
+
+/**
+ * @brief Generate adjacent row segments, which wrap around to the first row once the table is covered.
+ * @details
+ * The last segment before wrapping is clipped if the number of rows is not a multiple of the segment size.
+ * @param row_count The number of rows of the table
+ * @param segment_size The number of rows per segment
+ * @param count The number of segments
+ */
+std::vector<Segment> make_segments(Linx::Index row_count, Linx::Index segment_size, Linx::Index count);
+
+/**
+ * @brief Get the current local date and time, formatted as ISO 8601 (`YYYY-MM-DDThh:mm:ss`).
+ * @details
+ * This is the value of the date column of the benchmark programs, which is computed once per run.
+ */
+std::string timestamp();
+
+/**
+ * @brief The names of the statistics columns written by `write_statistics_row()`.
+ */
+std::vector<std::string> statistics_columns();
+
+/**
+ * @brief Write a row which ends with the statistics of a chronometer, in milliseconds, and the memory usage.
+ * @see statistics_columns()
+ */
+template <typename... Ts>
+CsvAppender&
+write_statistics_row(CsvAppender& writer, const BChronometer& chrono, const MemoryUsage& memory, const Ts&... values);
 
 /**
  * @brief The exception which is thrown when a test case is not implemented.
@@ -100,6 +200,17 @@ public:
    */
   virtual void close() = 0;
 
+  /**
+   * @brief Get the memory usage of the last test case, e.g. of the last call to `write_images()`.
+   */
+  const MemoryUsage& memory() const;
+
+  /**
+   * @brief Enable or disable the reset of the peak RSS at the start of each test case.
+   * @see MemoryMonitor::reset_peak_at_start()
+   */
+  void reset_peak_at_start(bool enabled);
+
   /**
    * @brief Write the given raster in new image extensions.
    * @param count The number of HDUs
@@ -128,6 +239,49 @@ public:
    */
   const BChronometer& read_bintables(Linx::Index first, Linx::Index count);
 
+  /**
+   * @brief Write the given n-D raster in new image extensions.
+   * @param count The number of HDUs
+   * @param raster The raster to be written in each HDU
+   * @param compressed Whether to compress the HDUs (with lossless GZIP)
+   */
+  template <typename T>
+  const BChronometer& write_nd_images(Linx::Index count, const Linx::Raster<T, -1>& raster, bool compressed);
+
+  /**
+   * @brief Read regions of the given image extension.
+   * @param index The (0-based) HDU index
+   * @param regions The regions
+   */
+  template <typename T>
+  const BChronometer& read_regions(Linx::Index index, const std::vector<Linx::Box<-1>>& regions);
+
+  /**
+   * @brief Write the given columns, e.g. hundreds of them, in new binary table extensions.
+   * @param count The number of HDUs
+   * @param columns The columns to be written in each HDU
+   * @details
+   * Unlike `write_bintables()`, the number of columns is not fixed, but the value type is homogeneous,
+   * which allows benchmarking column subset reads with `read_column_subsets()`.
+   * @see ELEFITS_BENCHMARK_FOREACH_WIDE_COLUMN_TYPE
+   */
+  template <typename T>
+  const BChronometer& write_wide_bintables(Linx::Index count, const std::vector<VecColumn<T>>& columns);
+
+  /**
+   * @brief Read row segments of a subset of columns of the given binary table extension.
+   * @param index The (0-based) HDU index
+   * @param subset The (0-based) column indices
+   * @param segments The row segments, each of which is read and timed separately
+   * @param mode The read mode
+   */
+  template <typename T>
+  const BChronometer& read_column_subsets(
+      Linx::Index index,
+      const std::vector<Linx::Index>& subset,
+      const std::vector<Segment>& segments,
+      ColumnReadMode mode);
+
   /**
    * @brief Write the given raster in a new image extension.
    * @details
@@ -166,12 +320,57 @@ public:
     throw TestCaseNotImplemented("Read binary table");
   }
 
+  /**
+   * @brief Write the given n-D raster in a new image extension.
+   * @copydetails write_image
+   *
+   * Child classes override this method and `read_region()` for each raster type
+   * with `ELEFITS_BENCHMARK_OVERRIDE_REGIONS`.
+   */
+#define ELEFITS_BENCHMARK_DECLARE_REGIONS(T, name) \
+  virtual BChronometer::Unit write_nd_image(const Linx::Raster<T, -1>&, bool) \
+  { \
+    throw TestCaseNotImplemented("Write n-D image"); \
+  } \
+  virtual BChronometer::Unit read_region(Linx::Index, const Linx::Box<-1>&, Linx::Raster<T, -1>&) \
+  { \
+    throw TestCaseNotImplemented("Read image region"); \
+  }
+  ELEFITS_FOREACH_RASTER_TYPE(ELEFITS_BENCHMARK_DECLARE_REGIONS)
+#undef ELEFITS_BENCHMARK_DECLARE_REGIONS
+
+  /**
+   * @brief Write the given columns in a new binary table extension.
+   * @copydetails write_image
+   *
+   * Child classes override this method and `read_column_subset()` for each column type
+   * with `ELEFITS_BENCHMARK_OVERRIDE_WIDE_COLUMNS`.
+   */
+#define ELEFITS_BENCHMARK_DECLARE_WIDE_COLUMNS(T, name) \
+  virtual BChronometer::Unit write_wide_bintable(const std::vector<VecColumn<T>>&) \
+  { \
+    throw TestCaseNotImplemented("Write wide binary table"); \
+  } \
+  virtual BChronometer::Unit read_column_subset( \
+      Linx::Index, \
+      const std::vector<Linx::Index>&, \
+      const Segment&, \
+      ColumnReadMode, \
+      std::vector<VecColumn<T>>&) \
+  { \
+    throw TestCaseNotImplemented("Read column subset"); \
+  }
+  ELEFITS_BENCHMARK_FOREACH_WIDE_COLUMN_TYPE(ELEFITS_BENCHMARK_DECLARE_WIDE_COLUMNS)
+#undef ELEFITS_BENCHMARK_DECLARE_WIDE_COLUMNS
+
 protected:
 
   /** @brief The file name. */
   std::string m_filename;
   /** @brief The chronometer. */
   BChronometer m_chrono;
+  /** @brief The memory monitor. */
+  MemoryMonitor m_memory;
   /** @brief The logger. */
   Elements::Logging m_logger;
 };
@@ -229,4 +428,46 @@ private:
 } // namespace Validation
 } // namespace Fits
 
+/**
+ * @brief Override the region methods of `Benchmark` for a given raster type.
+ * @details
+ * The child class should implement templates `write_nd_image_impl()` and `read_region_impl()`.
+ */
+#define ELEFITS_BENCHMARK_OVERRIDE_REGIONS(T, name) \
+  virtual BChronometer::Unit write_nd_image(const Linx::Raster<T, -1>& raster, bool compressed) override \
+  { \
+    return write_nd_image_impl(raster, compressed); \
+  } \
+  virtual BChronometer::Unit read_region(Linx::Index index, const Linx::Box<-1>& region, Linx::Raster<T, -1>& out) \
+      override \
+  { \
+    return read_region_impl(index, region, out); \
+  }
+
+/**
+ * @brief Override the wide binary table methods of `Benchmark` for a given column type.
+ * @details
+ * The child class should implement templates `write_wide_bintable_impl()` and `read_column_subset_impl()`.
+ */
+#define ELEFITS_BENCHMARK_OVERRIDE_WIDE_COLUMNS(T, name) \
+  virtual BChronometer::Unit write_wide_bintable(const std::vector<VecColumn<T>>& columns) override \
+  { \
+    return write_wide_bintable_impl(columns); \
+  } \
+  virtual BChronometer::Unit read_column_subset( \
+      Linx::Index index, \
+      const std::vector<Linx::Index>& subset, \
+      const Segment& rows, \
+      ColumnReadMode mode, \
+      std::vector<VecColumn<T>>& out) override \
+  { \
+    return read_column_subset_impl(index, subset, rows, mode, out); \
+  }
+
+/// @cond INTERNAL
+#define _ELEFITS_VALIDATION_BENCHMARK_IMPL
+#include "EleFitsValidation/impl/Benchmark.hpp"
+#undef _ELEFITS_VALIDATION_BENCHMARK_IMPL
+/// @endcond
+
 #endif
@@ -70,6 +70,11 @@ public:
    */
   virtual BColumns read_bintable(Linx::Index index) override;
 
+  /// @cond INTERNAL
+  ELEFITS_FOREACH_RASTER_TYPE(ELEFITS_BENCHMARK_OVERRIDE_REGIONS)
+  ELEFITS_BENCHMARK_FOREACH_WIDE_COLUMN_TYPE(ELEFITS_BENCHMARK_OVERRIDE_WIDE_COLUMNS)
+  /// @endcond
+
 private:
 
   /**
@@ -115,6 +120,55 @@ private:
   template <std::size_t i>
   void read_column(BColumns& columns, Linx::Index first_row, Linx::Index row_count);
 
+  /**
+   * @brief Write an n-D image HDU, compressed with GZIP and default (row-wise) tiles if requested.
+   */
+  template <typename T>
+  BChronometer::Unit write_nd_image_impl(const Linx::Raster<T, -1>& raster, bool compressed);
+
+  /**
+   * @brief Read an image region with `fits_read_subset()`.
+   */
+  template <typename T>
+  BChronometer::Unit read_region_impl(Linx::Index index, const Linx::Box<-1>& region, Linx::Raster<T, -1>& out);
+
+  /**
+   * @brief Write a binary table HDU column by column, chunked like `write_bintable()`.
+   */
+  template <typename T>
+  BChronometer::Unit write_wide_bintable_impl(const std::vector<VecColumn<T>>& columns);
+
+  /**
+   * @brief Read a subset of columns with `fits_read_col()`.
+   * @details
+   * Depending on the mode, the whole columns are read one after the other,
+   * the row segment is read by chunks of the buffer size, or the row segment is read column by column.
+   */
+  template <typename T>
+  BChronometer::Unit read_column_subset_impl(
+      Linx::Index index,
+      const std::vector<Linx::Index>& subset,
+      const Segment& rows,
+      ColumnReadMode mode,
+      std::vector<VecColumn<T>>& out);
+
+  /**
+   * @brief Write a chunk of a column (1-based index).
+   */
+  template <typename T>
+  void write_wide_column(int colnum, const VecColumn<T>& column, Linx::Index first_row, Linx::Index row_count);
+
+  /**
+   * @brief Read a chunk of a column (1-based index) into the given column, starting at its given row.
+   */
+  template <typename T>
+  void read_wide_column(
+      int colnum,
+      Linx::Index first_row,
+      Linx::Index row_count,
+      VecColumn<T>& column,
+      Linx::Index first_column_row);
+
 private:
 
   /** @brief The FITS file. */
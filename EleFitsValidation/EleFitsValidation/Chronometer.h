@@ -22,10 +22,25 @@ namespace Validation {
  * An offset can be provided, which is the initial value of the elapsed time,
  * but has no effect on the increments.
  *
- * Simple statistics on the increments can be computed (e.g. mean increment).
+ * Simple statistics on the increments can be computed (e.g. mean increment or percentiles).
  *
  * The chronometer can be reset, which means that the list of increments is emptied,
  * and the elapsed time is set to 0 or the offset.
+ *
+ * The storage of the increments is preallocated, such that `start()` and `stop()` do not allocate
+ * as long as the number of increments does not exceed the capacity.
+ * For short operations, prefer `std::chrono::nanoseconds` as the unit
+ * and convert the statistics afterwards, e.g. with `milliseconds()`:
+ *
+ * \code
+ * Chronometer<std::chrono::nanoseconds> chrono;
+ * for (const auto& k : keywords) {
+ *   chrono.start();
+ *   header.parse<int>(k);
+ *   chrono.stop();
+ * }
+ * std::cout << chrono.milliseconds(chrono.percentile(99)) << " ms" << std::endl;
+ * \endcode
  */
 template <typename TUnit>
 class Chronometer {
@@ -37,9 +52,19 @@ public:
   using Unit = TUnit;
 
   /**
-   * @brief Create a chronometer with optional offset.
+   * @brief The default capacity of the increment storage.
+   */
+  static constexpr std::size_t default_capacity = 1024;
+
+  /**
+   * @brief Create a chronometer with optional offset and capacity.
+   */
+  Chronometer(TUnit offset = TUnit(), std::size_t capacity = default_capacity);
+
+  /**
+   * @brief Preallocate the storage of the increments.
    */
-  Chronometer(TUnit offset = TUnit());
+  void reserve(std::size_t capacity);
 
   /**
    * @brief Reset the chronometer with optional offset.
@@ -56,6 +81,13 @@ public:
    */
   TUnit stop();
 
+  /**
+   * @brief Append the increments of another chronometer, e.g. which ran in another thread.
+   * @details
+   * The elapsed time is incremented with that of the other chronometer, less its offset.
+   */
+  void merge(const Chronometer& other, TUnit other_offset = TUnit());
+
   /**
    * @brief Test whether the chronometer is running.
    */
@@ -81,6 +113,11 @@ public:
    */
   const std::vector<double>& increments() const;
 
+  /**
+   * @brief Get the increments converted to fractional milliseconds.
+   */
+  std::vector<double> increments_as_milliseconds() const;
+
   /**
    * @brief The mean of the increments.
    */
@@ -101,6 +138,25 @@ public:
    */
   double max() const;
 
+  /**
+   * @brief The median increment.
+   */
+  double median() const;
+
+  /**
+   * @brief The percentile of the increments at a given rank.
+   * @param rank The rank in percents, e.g. 99.9
+   * @details
+   * Percentiles are linearly interpolated between the closest increments, like `median()`.
+   * They are computed on a sorted copy of the increments, and should therefore not be called while timing.
+   */
+  double percentile(double rank) const;
+
+  /**
+   * @brief Convert a value in the chronometer unit (e.g. a statistics) to fractional milliseconds.
+   */
+  static double milliseconds(double value);
+
 private:
 
   /**
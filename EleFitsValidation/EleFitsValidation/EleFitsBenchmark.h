@@ -104,6 +104,42 @@ public:
    * @copybrief Benchmark::read_bintable
    */
   virtual BColumns read_bintable(Linx::Index index) override;
+
+  /// @cond INTERNAL
+  ELEFITS_FOREACH_RASTER_TYPE(ELEFITS_BENCHMARK_OVERRIDE_REGIONS)
+  ELEFITS_BENCHMARK_FOREACH_WIDE_COLUMN_TYPE(ELEFITS_BENCHMARK_OVERRIDE_WIDE_COLUMNS)
+  /// @endcond
+
+private:
+
+  /**
+   * @brief Write an n-D image HDU, compressed with GZIP and row-wise tiles if requested (like CFITSIO's default).
+   */
+  template <typename T>
+  BChronometer::Unit write_nd_image_impl(const Linx::Raster<T, -1>& raster, bool compressed);
+
+  /**
+   * @brief Read an image region.
+   */
+  template <typename T>
+  BChronometer::Unit read_region_impl(Linx::Index index, const Linx::Box<-1>& region, Linx::Raster<T, -1>& out);
+
+  /**
+   * @brief Write a binary table HDU with `BintableColumns::write_n()`.
+   */
+  template <typename T>
+  BChronometer::Unit write_wide_bintable_impl(const std::vector<VecColumn<T>>& columns);
+
+  /**
+   * @brief Read a subset of columns with `BintableColumns::read_n()`, `read_n_segments()` or `read_segment()`.
+   */
+  template <typename T>
+  BChronometer::Unit read_column_subset_impl(
+      Linx::Index index,
+      const std::vector<Linx::Index>& subset,
+      const Segment& rows,
+      ColumnReadMode mode,
+      std::vector<VecColumn<T>>& out);
 };
 
 } // namespace Validation
@@ -0,0 +1,178 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_VALIDATION_MEMORYMONITOR_H
+#define _ELEFITS_VALIDATION_MEMORYMONITOR_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <cstdlib> // malloc, free
+#include <new> // bad_alloc
+#include <string>
+#include <vector>
+
+namespace Fits {
+namespace Validation {
+
+/**
+ * @brief The memory footprint of a test case.
+ */
+struct MemoryUsage {
+  Linx::Index peak_rss = -1; ///< The peak resident set size in bytes, or -1 if unavailable
+  Linx::Index allocation_count = -1; ///< The number of heap allocations, or -1 if they are not counted
+  Linx::Index allocated_bytes = -1; ///< The number of heap-allocated bytes, or -1 if they are not counted
+
+  /**
+   * @brief Merge the usage of a concurrent test case, i.e. keep the maximum peak and sum the allocations.
+   */
+  MemoryUsage& merge(const MemoryUsage& other);
+};
+
+/**
+ * @brief The names of the memory columns, in the order of `MemoryUsage`.
+ */
+std::vector<std::string> memory_columns();
+
+/**
+ * @brief A monitor of the peak resident set size (RSS) and heap allocations.
+ * @details
+ * The peak RSS is read from `/proc/self/status`, and reset at `start()` where the system allows it
+ * (Linux >= 4.0), such that it is the peak of the monitored section;
+ * otherwise, `getrusage()` is used and the peak is that of the process.
+ *
+ * Allocations are counted per thread by an `operator new` replacement,
+ * which is installed by expanding `ELEFITS_VALIDATION_COUNT_ALLOCATIONS()` once in the program.
+ * Only allocations made through `new` (e.g. by `std::vector`) are counted,
+ * such that `malloc()` calls by CFITSIO are not, but staging copies in EleFits are.
+ *
+ * \code
+ * ELEFITS_VALIDATION_COUNT_ALLOCATIONS()
+ *
+ * int main()
+ * {
+ *   MemoryMonitor monitor;
+ *   monitor.start();
+ *   f.append_image("", {}, raster);
+ *   const auto& usage = monitor.stop();
+ *   std::cout << usage.peak_rss << " " << usage.allocation_count << " " << usage.allocated_bytes << std::endl;
+ * }
+ * \endcode
+ */
+class MemoryMonitor {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  MemoryMonitor();
+
+  /**
+   * @brief Enable or disable the reset of the peak RSS at `start()` (enabled by default).
+   * @details
+   * As the peak RSS is that of the process, it should not be reset by concurrent monitors,
+   * but once before the monitored threads are started, and read once after they are joined.
+   */
+  void reset_peak_at_start(bool enabled);
+
+  /**
+   * @brief Reset the peak RSS if possible and enabled, and start counting allocations.
+   */
+  void start();
+
+  /**
+   * @brief Stop monitoring and get the usage since the last `start()`.
+   */
+  const MemoryUsage& stop();
+
+  /**
+   * @brief Get the usage of the last monitored section.
+   */
+  const MemoryUsage& usage() const;
+
+  /**
+   * @brief Get the current peak RSS, in bytes, or -1 if unavailable.
+   */
+  static Linx::Index peak_rss();
+
+  /**
+   * @brief Reset the peak RSS of the process.
+   * @return True if the system supports it
+   */
+  static bool reset_peak_rss();
+
+  /**
+   * @brief Check whether the allocation hook is installed.
+   */
+  static bool counts_allocations();
+
+  /**
+   * @brief Declare the allocation hook installed.
+   * @details
+   * This is called by `ELEFITS_VALIDATION_COUNT_ALLOCATIONS()`.
+   */
+  static void enable_allocation_count() noexcept;
+
+  /**
+   * @brief Count an allocation in the calling thread.
+   * @details
+   * This is called by the `operator new` replacement of `ELEFITS_VALIDATION_COUNT_ALLOCATIONS()`.
+   */
+  static void count_allocation(std::size_t bytes) noexcept;
+
+private:
+
+  /** @brief The allocation count at start. */
+  Linx::Index m_count;
+
+  /** @brief The allocated bytes at start. */
+  Linx::Index m_bytes;
+
+  /** @brief The usage of the last monitored section. */
+  MemoryUsage m_usage;
+
+  /** @brief Whether the peak RSS is reset at start. */
+  bool m_reset_peak;
+};
+
+} // namespace Validation
+} // namespace Fits
+
+/**
+ * @brief Replace the global `operator new` and `operator delete` to count allocations with `MemoryMonitor`.
+ * @details
+ * This macro must be expanded once, at global scope, in a translation unit of the program.
+ */
+#define ELEFITS_VALIDATION_COUNT_ALLOCATIONS() \
+  void* operator new(std::size_t size) \
+  { \
+    Fits::Validation::MemoryMonitor::count_allocation(size); \
+    if (void* ptr = std::malloc(size ? size : 1)) { \
+      return ptr; \
+    } \
+    throw std::bad_alloc(); \
+  } \
+  void* operator new[](std::size_t size) \
+  { \
+    return ::operator new(size); \
+  } \
+  void operator delete(void* ptr) noexcept \
+  { \
+    std::free(ptr); \
+  } \
+  void operator delete[](void* ptr) noexcept \
+  { \
+    std::free(ptr); \
+  } \
+  void operator delete(void* ptr, std::size_t) noexcept \
+  { \
+    std::free(ptr); \
+  } \
+  void operator delete[](void* ptr, std::size_t) noexcept \
+  { \
+    std::free(ptr); \
+  } \
+  [[maybe_unused]] static const bool elefits_validation_allocation_hook = \
+      (Fits::Validation::MemoryMonitor::enable_allocation_count(), true);
+
+#endif
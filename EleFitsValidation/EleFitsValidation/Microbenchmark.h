@@ -0,0 +1,147 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef _ELEFITS_VALIDATION_MICROBENCHMARK_H
+#define _ELEFITS_VALIDATION_MICROBENCHMARK_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Fits {
+namespace Validation {
+
+/**
+ * @brief Prevent the compiler from optimizing away a value computed in a microbenchmark.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * @brief The summary of a microbenchmark, with per-iteration times in nanoseconds.
+ */
+struct MicrobenchmarkResult {
+  std::string name; ///< The benchmark name
+  Linx::Index iterations = 0; ///< The number of iterations per repetition
+  Linx::Index repetitions = 0; ///< The number of repetitions
+  double mean = 0; ///< The mean time per iteration
+  double stdev = 0; ///< The standard deviation of the time per iteration over the repetitions
+  double min = 0; ///< The minimum time per iteration over the repetitions
+  double median = 0; ///< The median time per iteration over the repetitions
+  double max = 0; ///< The maximum time per iteration over the repetitions
+  Linx::Index bytes = 0; ///< The number of bytes processed per iteration, if any
+  std::vector<double> samples = {}; ///< The time per iteration of each repetition
+};
+
+/**
+ * @brief A suite of microbenchmarks, in the spirit of Google Benchmark.
+ * @details
+ * Each benchmark is a function which is called repeatedly:
+ * the number of iterations is first calibrated such that a repetition lasts at least some minimum time,
+ * then several repetitions are timed with nanosecond resolution,
+ * and statistics of the time per iteration are computed over the repetitions.
+ *
+ * Fixtures should be created outside of the benchmarked functions, e.g. captured by reference in lambdas,
+ * and results should be passed to `do_not_optimize()`:
+ *
+ * \code
+ * Microbenchmark suite;
+ * const auto& header = f.primary().header();
+ * suite.add("Header::parse", [&]() {
+ *   do_not_optimize(header.parse<int>("KEY"));
+ * });
+ * for (const auto& r : suite.run()) {
+ *   std::cout << r.name << ": " << r.median << " ns" << std::endl;
+ * }
+ * \endcode
+ */
+class Microbenchmark {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param min_time The minimum duration of a repetition
+   * @param repetitions The number of repetitions
+   */
+  explicit Microbenchmark(
+      std::chrono::nanoseconds min_time = std::chrono::milliseconds(10),
+      Linx::Index repetitions = 10);
+
+  /**
+   * @brief Register a benchmark.
+   * @param name The benchmark name
+   * @param body The benchmarked function
+   * @param bytes The number of bytes processed per call, if relevant, to compute throughputs
+   */
+  void add(const std::string& name, std::function<void()> body, Linx::Index bytes = 0);
+
+  /**
+   * @brief Get the names of the registered benchmarks.
+   */
+  std::vector<std::string> names() const;
+
+  /**
+   * @brief Run the benchmarks whose name contains some filter.
+   */
+  std::vector<MicrobenchmarkResult> run(const std::string& filter = "") const;
+
+  /**
+   * @brief Run a single function.
+   */
+  MicrobenchmarkResult run(const std::string& name, const std::function<void()>& body, Linx::Index bytes = 0) const;
+
+  /**
+   * @brief Write results as a tab-separated CSV file, with one row per benchmark.
+   * @details
+   * If the file exists, rows are appended.
+   */
+  static void write_csv(const std::vector<MicrobenchmarkResult>& results, const std::string& filename);
+
+  /**
+   * @brief Write results as a JSON file, including the samples.
+   */
+  static void write_json(const std::vector<MicrobenchmarkResult>& results, const std::string& filename);
+
+private:
+
+  /**
+   * @brief A registered benchmark.
+   */
+  struct Entry {
+    std::string name; ///< The name
+    std::function<void()> body; ///< The function
+    Linx::Index bytes; ///< The number of bytes per call
+  };
+
+  /**
+   * @brief The minimum duration of a repetition.
+   */
+  std::chrono::nanoseconds m_min_time;
+
+  /**
+   * @brief The number of repetitions.
+   */
+  Linx::Index m_repetitions;
+
+  /**
+   * @brief The registered benchmarks.
+   */
+  std::vector<Entry> m_entries;
+};
+
+} // namespace Validation
+} // namespace Fits
+
+#endif
@@ -0,0 +1,115 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#if defined(_ELEFITS_VALIDATION_BENCHMARK_IMPL) || defined(CHECK_QUALITY)
+
+#include "EleFitsValidation/Benchmark.h"
+
+namespace Fits {
+namespace Validation {
+
+template <typename... Ts>
+CsvAppender&
+write_statistics_row(CsvAppender& writer, const BChronometer& chrono, const MemoryUsage& memory, const Ts&... values)
+{
+  using mock_unpack = int[];
+  (void)mock_unpack {0, (writer << values, 0)...};
+  std::string samples;
+  for (auto inc : chrono.increments_as_milliseconds()) {
+    samples += (samples.empty() ? "" : ",") + std::to_string(inc);
+  }
+  return writer.write_row(
+      BChronometer::milliseconds(chrono.elapsed().count()),
+      BChronometer::milliseconds(chrono.min()),
+      BChronometer::milliseconds(chrono.max()),
+      BChronometer::milliseconds(chrono.mean()),
+      BChronometer::milliseconds(chrono.stdev()),
+      BChronometer::milliseconds(chrono.median()),
+      BChronometer::milliseconds(chrono.percentile(90)),
+      BChronometer::milliseconds(chrono.percentile(99)),
+      BChronometer::milliseconds(chrono.percentile(99.9)),
+      memory.peak_rss < 0 ? memory.peak_rss : memory.peak_rss / 1024,
+      memory.allocation_count,
+      memory.allocated_bytes,
+      samples);
+}
+
+template <typename T>
+const BChronometer& Benchmark::write_nd_images(Linx::Index count, const Linx::Raster<T, -1>& raster, bool compressed)
+{
+  open();
+  m_memory.start();
+  m_chrono.reset();
+  for (Linx::Index i = 0; i < count; ++i) {
+    const auto inc = write_nd_image(raster, compressed);
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(inc.count()) << "ms";
+  }
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(m_chrono.elapsed().count()) << "ms";
+  m_memory.stop();
+  close();
+  return m_chrono;
+}
+
+template <typename T>
+const BChronometer& Benchmark::read_regions(Linx::Index index, const std::vector<Linx::Box<-1>>& regions)
+{
+  open();
+  m_memory.start();
+  m_chrono.reset();
+  m_chrono.reserve(regions.size());
+  const auto count = regions.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    Linx::Raster<T, -1> out(regions[i].shape()); // Allocation is not timed
+    const auto inc = read_region(index, regions[i], out);
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(inc.count()) << "ms";
+  }
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(m_chrono.elapsed().count()) << "ms";
+  m_memory.stop();
+  close();
+  return m_chrono;
+}
+
+template <typename T>
+const BChronometer& Benchmark::write_wide_bintables(Linx::Index count, const std::vector<VecColumn<T>>& columns)
+{
+  open();
+  m_memory.start();
+  m_chrono.reset();
+  for (Linx::Index i = 0; i < count; ++i) {
+    const auto inc = write_wide_bintable(columns);
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(inc.count()) << "ms";
+  }
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(m_chrono.elapsed().count()) << "ms";
+  m_memory.stop();
+  close();
+  return m_chrono;
+}
+
+template <typename T>
+const BChronometer& Benchmark::read_column_subsets(
+    Linx::Index index,
+    const std::vector<Linx::Index>& subset,
+    const std::vector<Segment>& segments,
+    ColumnReadMode mode)
+{
+  open();
+  m_memory.start();
+  m_chrono.reset();
+  m_chrono.reserve(segments.size());
+  const auto count = segments.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    std::vector<VecColumn<T>> out;
+    const auto inc = read_column_subset(index, subset, segments[i], mode, out);
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(inc.count()) << "ms";
+  }
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(m_chrono.elapsed().count()) << "ms";
+  m_memory.stop();
+  close();
+  return m_chrono;
+}
+
+} // namespace Validation
+} // namespace Fits
+
+#endif
@@ -75,6 +75,228 @@ void CfitsioBenchmark::read_column(BColumns& columns, long first_row, long row_c
   may_throw("Cannot read column");
 }
 
+template <typename T>
+BChronometer::Unit CfitsioBenchmark::write_nd_image_impl(const Linx::Raster<T, -1>& raster, bool compressed)
+{
+  if (compressed) {
+    fits_set_compression_type(m_fptr, GZIP_1, &m_status);
+    fits_set_quantize_level(m_fptr, 0, &m_status); // Lossless for floating point images, too
+    may_throw("Cannot enable compression");
+  }
+  std::vector<long> nonconst_shape(raster.shape().begin(), raster.shape().end());
+  std::vector<T> nonconst_data(raster.data(), raster.data() + raster.size());
+  m_chrono.start();
+  fits_create_img(
+      m_fptr,
+      Cfitsio::TypeCode<T>::bitpix(),
+      nonconst_shape.size(),
+      nonconst_shape.data(),
+      &m_status);
+  may_throw("Cannot create image HDU");
+  fits_write_img(m_fptr, Cfitsio::TypeCode<T>::for_image(), 1, raster.size(), nonconst_data.data(), &m_status);
+  may_throw("Cannot write image");
+  const auto inc = m_chrono.stop();
+  if (compressed) {
+    fits_set_compression_type(m_fptr, NOCOMPRESS, &m_status);
+    may_throw("Cannot disable compression");
+  }
+  return inc;
+}
+
+template <typename T>
+BChronometer::Unit
+CfitsioBenchmark::read_region_impl(Linx::Index index, const Linx::Box<-1>& region, Linx::Raster<T, -1>& out)
+{
+  const auto& front = region.front();
+  const auto shape = region.shape();
+  const auto dimension = front.size();
+  std::vector<long> fpixel(dimension);
+  std::vector<long> lpixel(dimension);
+  for (Linx::Index i = 0; i < dimension; ++i) {
+    fpixel[i] = front[i] + 1;
+    lpixel[i] = front[i] + shape[i];
+  }
+  std::vector<long> inc(dimension, 1);
+  m_chrono.start();
+  int hdu_type = 0;
+  fits_movabs_hdu(m_fptr, index + 1, &hdu_type, &m_status);
+  fits_read_subset(
+      m_fptr,
+      Cfitsio::TypeCode<T>::for_image(),
+      fpixel.data(),
+      lpixel.data(),
+      inc.data(),
+      nullptr,
+      out.data(),
+      nullptr,
+      &m_status);
+  may_throw("Cannot read image region");
+  return m_chrono.stop();
+}
+
+template <typename T>
+BChronometer::Unit CfitsioBenchmark::write_wide_bintable_impl(const std::vector<VecColumn<T>>& columns)
+{
+  const auto column_count = columns.size();
+  const long row_count = column_count > 0 ? columns[0].row_count() : 0;
+  std::vector<std::string> names(column_count);
+  std::vector<std::string> formats(column_count);
+  std::vector<std::string> units(column_count);
+  for (std::size_t i = 0; i < column_count; ++i) {
+    const auto& info = columns[i].info();
+    names[i] = info.name;
+    formats[i] = Cfitsio::TypeCode<T>::tform(info.repeat_count());
+    units[i] = info.unit;
+  }
+  String::CStrArray name_array(names);
+  String::CStrArray format_array(formats);
+  String::CStrArray unit_array(units);
+  m_chrono.start();
+  fits_create_tbl(
+      m_fptr,
+      BINARY_TBL,
+      0,
+      column_count,
+      name_array.data(),
+      format_array.data(),
+      unit_array.data(),
+      "",
+      &m_status);
+  may_throw("Cannot create binary table HDU");
+  long chunk_row_count = compute_chunk_row_count(row_count);
+  for (long first_row = 0; first_row < row_count;) {
+    const long past_last_row = std::min(first_row + chunk_row_count, row_count);
+    for (std::size_t i = 0; i < column_count; ++i) {
+      write_wide_column(i + 1, columns[i], first_row, past_last_row - first_row);
+    }
+    first_row = past_last_row;
+  }
+  return m_chrono.stop();
+}
+
+template <typename T>
+BChronometer::Unit CfitsioBenchmark::read_column_subset_impl(
+    Linx::Index index,
+    const std::vector<Linx::Index>& subset,
+    const Segment& rows,
+    ColumnReadMode mode,
+    std::vector<VecColumn<T>>& out)
+{
+  int hdu_type = 0;
+  fits_movabs_hdu(m_fptr, index + 1, &hdu_type, &m_status);
+  may_throw("Cannot access HDU");
+  m_chrono.start();
+  Segment segment = rows;
+  if (mode == ColumnReadMode::ReadN) {
+    long row_count = 0;
+    fits_get_num_rows(m_fptr, &row_count, &m_status);
+    may_throw("Cannot read number of rows");
+    segment = Segment::fromSize(0, row_count);
+  }
+  out.clear();
+  out.reserve(subset.size());
+  for (auto i : subset) {
+    long repeat = 0;
+    char ttype[FLEN_VALUE];
+    char tunit[FLEN_VALUE];
+    fits_get_bcolparms(m_fptr, i + 1, ttype, tunit, nullptr, &repeat, nullptr, nullptr, nullptr, nullptr, &m_status);
+    may_throw("Cannot initialize column");
+    out.emplace_back(ColumnInfo<T>(ttype, tunit, repeat), segment.size());
+  }
+  if (mode == ColumnReadMode::ReadNSegments) {
+    long chunk_row_count = 0;
+    fits_get_rowsize(m_fptr, &chunk_row_count, &m_status);
+    may_throw("Cannot compute buffer size");
+    for (long first_row = segment.front; first_row <= segment.back;) {
+      const long past_last_row = std::min(first_row + chunk_row_count, segment.back + 1);
+      for (std::size_t i = 0; i < subset.size(); ++i) {
+        read_wide_column(subset[i] + 1, first_row, past_last_row - first_row, out[i], first_row - segment.front);
+      }
+      first_row = past_last_row;
+    }
+  } else {
+    for (std::size_t i = 0; i < subset.size(); ++i) {
+      read_wide_column(subset[i] + 1, segment.front, segment.size(), out[i], 0);
+    }
+  }
+  return m_chrono.stop();
+}
+
+template <typename T>
+void CfitsioBenchmark::write_wide_column(
+    int colnum,
+    const VecColumn<T>& column,
+    Linx::Index first_row,
+    Linx::Index row_count)
+{
+  const auto element_count = column.info().element_count();
+  const auto b = column.container().begin() + first_row * element_count;
+  const auto e = b + row_count * element_count;
+  if constexpr (std::is_same_v<T, std::string>) {
+    String::CStrArray array(b, e);
+    fits_write_col(m_fptr, TSTRING, colnum, first_row + 1, 1, row_count, array.data(), &m_status);
+  } else {
+    std::vector<T> nonconst_vec(b, e);
+    fits_write_col(
+        m_fptr,
+        Cfitsio::TypeCode<T>::for_bintable(),
+        colnum,
+        first_row + 1,
+        1,
+        row_count * element_count,
+        nonconst_vec.data(),
+        &m_status);
+  }
+  may_throw("Cannot write column");
+}
+
+template <typename T>
+void CfitsioBenchmark::read_wide_column(
+    int colnum,
+    Linx::Index first_row,
+    Linx::Index row_count,
+    VecColumn<T>& column,
+    Linx::Index first_column_row)
+{
+  if constexpr (std::is_same_v<T, std::string>) {
+    const auto width = column.info().repeat_count() + 1; // Null-terminated
+    std::vector<char> buffer(row_count * width);
+    std::vector<char*> pointers(row_count);
+    for (Linx::Index r = 0; r < row_count; ++r) {
+      pointers[r] = buffer.data() + r * width;
+    }
+    fits_read_col(
+        m_fptr,
+        TSTRING,
+        colnum,
+        first_row + 1,
+        1,
+        row_count,
+        nullptr,
+        pointers.data(),
+        nullptr,
+        &m_status);
+    auto data = column.data() + first_column_row;
+    for (Linx::Index r = 0; r < row_count; ++r) {
+      data[r] = pointers[r];
+    }
+  } else {
+    const auto element_count = column.info().element_count();
+    fits_read_col(
+        m_fptr,
+        Cfitsio::TypeCode<T>::for_bintable(),
+        colnum,
+        first_row + 1,
+        1,
+        row_count * element_count,
+        nullptr,
+        column.data() + first_column_row * element_count,
+        nullptr,
+        &m_status);
+  }
+  may_throw("Cannot read column");
+}
+
 } // namespace Validation
 } // namespace Fits
 
@@ -6,19 +6,31 @@
 
 #include "EleFitsValidation/Chronometer.h"
 
-#include <algorithm> // min_element, max_element
-#include <cmath> // sqrt
+#include <algorithm> // min_element, max_element, sort, transform
+#include <cmath> // floor, sqrt
+#include <limits> // quiet_NaN
 #include <numeric> // inner_product
 
 namespace Fits {
 namespace Validation {
 
 template <typename TUnit>
-Chronometer<TUnit>::Chronometer(TUnit offset) : m_tic(), m_toc(), m_running(false), m_incs(), m_elapsed(offset)
+constexpr std::size_t Chronometer<TUnit>::default_capacity;
+
+template <typename TUnit>
+Chronometer<TUnit>::Chronometer(TUnit offset, std::size_t capacity) :
+    m_tic(), m_toc(), m_running(false), m_incs(), m_elapsed(offset)
 {
+  reserve(capacity);
   reset(offset);
 }
 
+template <typename TUnit>
+void Chronometer<TUnit>::reserve(std::size_t capacity)
+{
+  m_incs.reserve(capacity);
+}
+
 template <typename TUnit>
 void Chronometer<TUnit>::reset(TUnit offset)
 {
@@ -46,6 +58,13 @@ TUnit Chronometer<TUnit>::stop()
   return inc;
 }
 
+template <typename TUnit>
+void Chronometer<TUnit>::merge(const Chronometer& other, TUnit other_offset)
+{
+  m_incs.insert(m_incs.end(), other.m_incs.begin(), other.m_incs.end());
+  m_elapsed += other.m_elapsed - other_offset;
+}
+
 template <typename TUnit>
 bool Chronometer<TUnit>::is_running() const
 {
@@ -76,6 +95,14 @@ const std::vector<double>& Chronometer<TUnit>::increments() const
   return m_incs;
 }
 
+template <typename TUnit>
+std::vector<double> Chronometer<TUnit>::increments_as_milliseconds() const
+{
+  std::vector<double> out(m_incs.size());
+  std::transform(m_incs.begin(), m_incs.end(), out.begin(), milliseconds);
+  return out;
+}
+
 template <typename TUnit>
 double Chronometer<TUnit>::mean() const
 {
@@ -102,6 +129,33 @@ double Chronometer<TUnit>::max() const
   return *std::max_element(m_incs.begin(), m_incs.end());
 }
 
+template <typename TUnit>
+double Chronometer<TUnit>::median() const
+{
+  return percentile(50);
+}
+
+template <typename TUnit>
+double Chronometer<TUnit>::percentile(double rank) const
+{
+  if (m_incs.empty()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  auto sorted = m_incs;
+  std::sort(sorted.begin(), sorted.end());
+  const auto position = std::min(std::max(rank, 0.), 100.) / 100. * (sorted.size() - 1);
+  const auto below = static_cast<std::size_t>(std::floor(position));
+  const auto above = std::min(below + 1, sorted.size() - 1);
+  return sorted[below] + (position - below) * (sorted[above] - sorted[below]);
+}
+
+template <typename TUnit>
+double Chronometer<TUnit>::milliseconds(double value)
+{
+  using Fractional = std::chrono::duration<double, typename TUnit::period>;
+  return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(Fractional(value)).count();
+}
+
 } // namespace Validation
 } // namespace Fits
 
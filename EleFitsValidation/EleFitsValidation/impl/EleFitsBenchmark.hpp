@@ -16,6 +16,74 @@ EleFitsColwiseBenchmark::col_indexed() const
   return TypedKey<typename std::tuple_element<I, BColumns>::type::Value, Linx::Index>(I);
 }
 
+template <typename T>
+BChronometer::Unit EleFitsBenchmark::write_nd_image_impl(const Linx::Raster<T, -1>& raster, bool compressed)
+{
+  if (compressed) {
+    m_f.strategy(Compress<Gzip>(Tile::rowwise()));
+  }
+  m_chrono.start();
+  m_f.append_image("", {}, raster);
+  const auto inc = m_chrono.stop();
+  if (compressed) {
+    m_f.strategy().clear();
+    m_f.strategy(CiteEleFits()); // Default strategy
+  }
+  return inc;
+}
+
+template <typename T>
+BChronometer::Unit
+EleFitsBenchmark::read_region_impl(Linx::Index index, const Linx::Box<-1>& region, Linx::Raster<T, -1>& out)
+{
+  m_chrono.start();
+  m_f.access<ImageHdu>(index).raster().read_region_to(region.front(), out);
+  return m_chrono.stop();
+}
+
+template <typename T>
+BChronometer::Unit EleFitsBenchmark::write_wide_bintable_impl(const std::vector<VecColumn<T>>& columns)
+{
+  std::vector<ColumnInfo<T>> infos;
+  infos.reserve(columns.size());
+  for (const auto& c : columns) {
+    infos.push_back(c.info());
+  }
+  m_chrono.start();
+  const auto& ext = m_f.append_bintable_header("", {});
+  ext.columns().insert_n_null(-1, infos);
+  ext.columns().write_n(columns);
+  return m_chrono.stop();
+}
+
+template <typename T>
+BChronometer::Unit EleFitsBenchmark::read_column_subset_impl(
+    Linx::Index index,
+    const std::vector<Linx::Index>& subset,
+    const Segment& rows,
+    ColumnReadMode mode,
+    std::vector<VecColumn<T>>& out)
+{
+  const auto& columns = m_f.access<BintableColumns>(index);
+  const std::vector<ColumnKey> keys(subset.begin(), subset.end());
+  m_chrono.start();
+  switch (mode) {
+    case ColumnReadMode::ReadN:
+      out = columns.read_n<T>(keys);
+      break;
+    case ColumnReadMode::ReadNSegments:
+      out = columns.read_n_segments<T>(rows, keys);
+      break;
+    case ColumnReadMode::PerColumn:
+      out.clear();
+      for (const auto& k : keys) {
+        out.push_back(columns.read_segment<T>(rows, k));
+      }
+      break;
+  }
+  return m_chrono.stop();
+}
+
 } // namespace Validation
 } // namespace Fits
 
@@ -0,0 +1,139 @@
+# Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+# This file is part of EleFits <github.com/CNES/EleFits>
+# SPDX-License-Identifier: LGPL-3.0-or-later
+
+import argparse
+from collections import defaultdict
+import csv
+import math
+import random
+import sys
+import ElementsKernel.Logging as log
+
+
+def median(values):
+    """Compute the median of a non-empty list."""
+    s = sorted(values)
+    n = len(s)
+    return s[n // 2] if n % 2 else (s[n // 2 - 1] + s[n // 2]) / 2
+
+
+def mann_whitney(baseline, candidate):
+    """Compute the one-sided p-value of the Mann-Whitney U test
+    for the hypothesis that the candidate samples are greater (slower) than the baseline samples.
+    The normal approximation is used, with tie and continuity corrections.
+    """
+    nb = len(baseline)
+    nc = len(candidate)
+    n = nb + nc
+    values = sorted([(v, 0) for v in baseline] + [(v, 1) for v in candidate])
+    ranks = [0.] * n
+    ties = 0.
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+    u = sum(r for r, (_, group) in zip(ranks, values) if group == 1) - nc * (nc + 1) / 2
+    mean = nb * nc / 2
+    variance = nb * nc / 12 * ((n + 1) - ties / (n * (n - 1))) if n > 1 else 0
+    if variance <= 0:
+        return 1.
+    z = (u - mean - 0.5) / math.sqrt(variance)
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def bootstrap_ratio(baseline, candidate, resamples, confidence, rng):
+    """Compute a bootstrap confidence interval of the ratio of the medians (candidate over baseline)."""
+    ratios = []
+    for _ in range(resamples):
+        b = median(rng.choices(baseline, k=len(baseline)))
+        c = median(rng.choices(candidate, k=len(candidate)))
+        ratios.append(c / b if b > 0 else math.inf)
+    ratios.sort()
+    alpha = (1 - confidence) / 2
+    low = ratios[int(alpha * (resamples - 1))]
+    high = ratios[int((1 - alpha) * (resamples - 1))]
+    return low, high
+
+
+def load(filename, keys, samples):
+    """Load the samples of a result file, grouped by test case.
+    Rows with the same test case (e.g. repeated runs) are merged.
+    """
+    out = defaultdict(list)
+    with open(filename, 'r') as f:
+        for row in csv.DictReader(f, delimiter='\t'):
+            if not row.get(samples):
+                continue
+            case = tuple(row.get(k, '') for k in keys)
+            out[case] += [float(s) for s in row[samples].split(',') if s]
+    return out
+
+
+def defineSpecificProgramOptions():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('baseline', help='The baseline results TSV, as output by EleFitsRunBenchmark.')
+    parser.add_argument('candidate', help='The candidate results TSV, as output by EleFitsRunBenchmark.')
+    parser.add_argument('--keys', default='Test setup,Mode,HDU type,HDU count,Value count / HDU,Threads',
+                        help='The comma-separated columns which identify a test case.')
+    parser.add_argument('--samples', default='Samples (ms)', help='The column of comma-separated samples.')
+    parser.add_argument('--threshold', type=float, default=5.,
+                        help='The relative slowdown of the median above which a test case may regress, in percents.')
+    parser.add_argument('--alpha', type=float, default=0.01,
+                        help='The significance level of the Mann-Whitney test.')
+    parser.add_argument('--resamples', type=int, default=1000,
+                        help='The number of bootstrap resamples for the confidence interval of the median ratio.')
+    parser.add_argument('--confidence', type=float, default=0.95, help='The confidence level of the interval.')
+    parser.add_argument('--seed', type=int, default=0, help='The seed of the bootstrap.')
+    parser.add_argument('--report', default=None, help='The filename of the comparison TSV, if any.')
+    return parser
+
+
+def mainMethod(args):
+
+    logger = log.getLogger('EleFitsCompareBenchmarks')
+
+    keys = args.keys.split(',')
+    baseline = load(args.baseline, keys, args.samples)
+    candidate = load(args.candidate, keys, args.samples)
+    rng = random.Random(args.seed)
+
+    rows = []
+    regressions = 0
+    for case in sorted(set(baseline) & set(candidate)):
+        b = baseline[case]
+        c = candidate[case]
+        delta = (median(c) / median(b) - 1) * 100 if median(b) > 0 else 0.
+        p = mann_whitney(b, c)
+        low, high = bootstrap_ratio(b, c, args.resamples, args.confidence, rng)
+        regressed = p < args.alpha and delta > args.threshold and low > 1
+        regressions += int(regressed)
+        name = ' / '.join(case)
+        message = f'{name}: {median(b):.4g} -> {median(c):.4g} ({delta:+.1f}%, p={p:.2g}, ' \
+            f'ratio in [{low:.3f}, {high:.3f}])'
+        if regressed:
+            logger.error('REGRESSION ' + message)
+        else:
+            logger.info(message)
+        rows.append(list(case) + [len(b), len(c), median(b), median(c), delta, p, low, high, regressed])
+
+    for case in sorted(set(baseline) ^ set(candidate)):
+        logger.warning(f'Unmatched test case: {" / ".join(case)}')
+
+    if args.report is not None:
+        with open(args.report, 'w') as f:
+            writer = csv.writer(f, delimiter='\t')
+            writer.writerow(keys + ['Baseline count', 'Candidate count', 'Baseline median', 'Candidate median',
+                                    'Delta (%)', 'p-value', 'Ratio low', 'Ratio high', 'Regression'])
+            writer.writerows(rows)
+        logger.info(f'Saved comparison as: {args.report}')
+
+    logger.info(f'{len(rows)} test cases compared, {regressions} regressions')
+    if regressions > 0:
+        sys.exit(1)
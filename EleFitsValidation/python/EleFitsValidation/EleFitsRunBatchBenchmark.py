@@ -20,7 +20,7 @@ def scientific_notation(value):
 
 def make_command(test_case, output, results, log_level):
     """Run a test case specified as a dictionary with following keys:
-    "Test setup", "HDU type", "HDU count", "Value count / HDU"
+    "Test setup", "HDU type", "HDU count", "Value count / HDU", and optionally "Threads"
     """
     cmd = f'EleFitsRunBenchmark --log-level {log_level} --output {output} --res {results}'
     cmd += f' --setup "{test_case["Test setup"]}"'
@@ -29,6 +29,8 @@ def make_command(test_case, output, results, log_level):
         # int(float(value)) allows value to be an integer in scientific notation
     if test_case['HDU type'] == 'Binary table':
         cmd += f' --tables {int(float(test_case["HDU count"]))} --rows {int(float(test_case["Value count / HDU"]))//10}'
+    if test_case.get('Threads'):
+        cmd += f' --threads {int(test_case["Threads"])}'
     return cmd
 
 
@@ -4,25 +4,172 @@
 
 #include "EleFitsValidation/Benchmark.h"
 
+#include <algorithm> // min
+#include <ctime>
+#include <iomanip> // put_time
+#include <random>
+#include <sstream>
+
 namespace Fits {
 namespace Validation {
 
+RegionPattern parse_region_pattern(const std::string& name)
+{
+  if (name == "random") {
+    return RegionPattern::Random;
+  }
+  if (name == "sequential") {
+    return RegionPattern::Sequential;
+  }
+  if (name == "strips") {
+    return RegionPattern::Strips;
+  }
+  throw TestCaseNotImplemented("Region pattern: " + name);
+}
+
+std::vector<Linx::Box<-1>> make_regions(
+    const Linx::Position<-1>& shape,
+    RegionPattern pattern,
+    Linx::Index side,
+    Linx::Index count,
+    std::size_t seed)
+{
+  const std::vector<Linx::Index> image_shape(shape.begin(), shape.end());
+  const auto dimension = image_shape.size();
+  std::vector<Linx::Index> region_shape(image_shape);
+  if (pattern == RegionPattern::Strips) {
+    region_shape.back() = std::min(side, image_shape.back());
+  } else {
+    for (std::size_t i = 0; i < dimension; ++i) {
+      region_shape[i] = std::min(side, image_shape[i]);
+    }
+  }
+
+  std::mt19937 generator(seed);
+  std::vector<Linx::Index> front(dimension, 0);
+  std::vector<Linx::Box<-1>> out;
+  out.reserve(count);
+  for (Linx::Index r = 0; r < count; ++r) {
+    if (pattern == RegionPattern::Random) {
+      for (std::size_t i = 0; i < dimension; ++i) {
+        std::uniform_int_distribution<Linx::Index> distribution(0, image_shape[i] - region_shape[i]);
+        front[i] = distribution(generator);
+      }
+    }
+    std::vector<Linx::Index> clipped(region_shape);
+    for (std::size_t i = 0; i < dimension; ++i) {
+      clipped[i] = std::min(region_shape[i], image_shape[i] - front[i]);
+    }
+    out.push_back(Linx::Box<-1>::from_shape(Linx::Position<-1>(front), Linx::Position<-1>(std::move(clipped))));
+    if (pattern != RegionPattern::Random) { // Move to the next region in row-major order, or wrap around
+      for (std::size_t i = 0; i < dimension; ++i) {
+        front[i] += region_shape[i];
+        if (front[i] < image_shape[i]) {
+          break;
+        }
+        front[i] = 0;
+      }
+    }
+  }
+  return out;
+}
+
+ColumnReadMode parse_column_read_mode(const std::string& name)
+{
+  if (name == "read_n") {
+    return ColumnReadMode::ReadN;
+  }
+  if (name == "read_n_segments") {
+    return ColumnReadMode::ReadNSegments;
+  }
+  if (name == "per_column") {
+    return ColumnReadMode::PerColumn;
+  }
+  throw TestCaseNotImplemented("Column read mode: " + name);
+}
+
+std::vector<Linx::Index> make_column_subset(Linx::Index column_count, Linx::Index selected_count)
+{
+  const auto count = std::min(selected_count, column_count);
+  std::vector<Linx::Index> out(count);
+  for (Linx::Index i = 0; i < count; ++i) {
+    out[i] = i * column_count / count;
+  }
+  return out;
+}
+
+std::vector<Segment> make_segments(Linx::Index row_count, Linx::Index segment_size, Linx::Index count)
+{
+  const auto size = std::min(segment_size, row_count);
+  std::vector<Segment> out;
+  out.reserve(count);
+  Linx::Index front = 0;
+  for (Linx::Index s = 0; s < count; ++s) {
+    if (front >= row_count) {
+      front = 0;
+    }
+    out.push_back(Segment::fromSize(front, std::min(size, row_count - front))); // Clip the last segment
+    front += size;
+  }
+  return out;
+}
+
+std::string timestamp()
+{
+  const auto now = std::time(nullptr);
+  std::tm local {};
+  localtime_r(&now, &local);
+  std::ostringstream oss;
+  oss << std::put_time(&local, "%Y-%m-%dT%H:%M:%S");
+  return oss.str();
+}
+
+std::vector<std::string> statistics_columns()
+{
+  std::vector<std::string> out {
+      "Elapsed (ms)",
+      "Min (ms)",
+      "Max (ms)",
+      "Mean (ms)",
+      "Standard deviation (ms)",
+      "Median (ms)",
+      "P90 (ms)",
+      "P99 (ms)",
+      "P99.9 (ms)"};
+  const auto memory = memory_columns();
+  out.insert(out.end(), memory.begin(), memory.end());
+  out.push_back("Samples (ms)");
+  return out;
+}
+
 Benchmark::Benchmark(const std::string& filename) :
-    m_filename(filename), m_chrono(), m_logger(Elements::Logging::getLogger("Benchmark"))
+    m_filename(filename), m_chrono(), m_memory(), m_logger(Elements::Logging::getLogger("Benchmark"))
 {}
 
+const MemoryUsage& Benchmark::memory() const
+{
+  return m_memory.usage();
+}
+
+void Benchmark::reset_peak_at_start(bool enabled)
+{
+  m_memory.reset_peak_at_start(enabled);
+}
+
 const BChronometer& Benchmark::write_images(Linx::Index count, const BRaster& raster)
 {
   open();
+  m_memory.start();
   m_chrono.reset();
   m_logger.debug() << "First pixel: " << raster.at({0});
   m_logger.debug() << "Last pixel: " << raster.at({-1});
   for (Linx::Index i = 0; i < count; ++i) {
     const auto inc = write_image(raster);
-    m_logger.debug() << i + 1 << "/" << count << ": " << inc.count() << "ms";
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(inc.count()) << "ms";
   }
   const auto total = m_chrono.elapsed();
-  m_logger.debug() << "TOTAL: " << total.count() << "ms";
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(total.count()) << "ms";
+  m_memory.stop();
   close();
   return m_chrono;
 }
@@ -30,15 +177,17 @@ const BChronometer& Benchmark::write_images(Linx::Index count, const BRaster& ra
 const BChronometer& Benchmark::write_bintables(Linx::Index count, const BColumns& columns)
 { // TODO avoid duplication
   open();
+  m_memory.start();
   m_chrono.reset();
   m_logger.debug() << "First column, first row: " << std::get<0>(columns).at(0, 0);
   m_logger.debug() << "Last column, last row: " << std::get<ColumnCount - 1>(columns).at(-1, -1);
   for (Linx::Index i = 0; i < count; ++i) {
     const auto inc = write_bintable(columns);
-    m_logger.debug() << i + 1 << "/" << count << ": " << inc.count() << "ms";
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(inc.count()) << "ms";
   }
   const auto total = m_chrono.elapsed();
-  m_logger.debug() << "TOTAL: " << total.count() << "ms";
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(total.count()) << "ms";
+  m_memory.stop();
   close();
   return m_chrono;
 }
@@ -46,15 +195,17 @@ const BChronometer& Benchmark::write_bintables(Linx::Index count, const BColumns
 const BChronometer& Benchmark::read_images(Linx::Index first, Linx::Index count)
 {
   open();
+  m_memory.start();
   m_chrono.reset();
   for (Linx::Index i = 0; i < count; ++i) {
     const auto raster = read_image(first + i);
-    m_logger.debug() << i + 1 << "/" << count << ": " << m_chrono.last().count() << "ms";
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(m_chrono.last().count()) << "ms";
     m_logger.debug() << "\tFirst pixel: " << raster.at({0});
     m_logger.debug() << "\tLast pixel: " << raster.at({-1});
   }
   const auto total = m_chrono.elapsed();
-  m_logger.debug() << "TOTAL: " << total.count() << "ms";
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(total.count()) << "ms";
+  m_memory.stop();
   close();
   return m_chrono;
 }
@@ -62,15 +213,17 @@ const BChronometer& Benchmark::read_images(Linx::Index first, Linx::Index count)
 const BChronometer& Benchmark::read_bintables(Linx::Index first, Linx::Index count)
 {
   open();
+  m_memory.start();
   m_chrono.reset();
   for (Linx::Index i = 0; i < count; ++i) {
     const auto columns = read_bintable(i + first);
-    m_logger.debug() << i + 1 << "/" << count << ": " << m_chrono.last().count() << "ms";
+    m_logger.debug() << i + 1 << "/" << count << ": " << BChronometer::milliseconds(m_chrono.last().count()) << "ms";
     m_logger.debug() << "\tFirst column, first row: " << std::get<0>(columns).at(0, 0);
     m_logger.debug() << "\tLast column, last row: " << std::get<ColumnCount - 1>(columns).at(-1, -1);
   }
   const auto total = m_chrono.elapsed();
-  m_logger.debug() << "TOTAL: " << total.count() << "ms";
+  m_logger.debug() << "TOTAL: " << BChronometer::milliseconds(total.count()) << "ms";
+  m_memory.stop();
   close();
   return m_chrono;
 }
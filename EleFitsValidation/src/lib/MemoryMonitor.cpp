@@ -0,0 +1,135 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsValidation/MemoryMonitor.h"
+
+#include <algorithm> // max
+#include <atomic>
+#include <fstream>
+#include <limits> // numeric_limits
+#include <sys/resource.h> // getrusage
+
+namespace Fits {
+namespace Validation {
+
+namespace {
+
+/**
+ * @brief Whether the allocation hook is installed.
+ */
+std::atomic<bool> allocation_hook(false);
+
+/**
+ * @brief The number of allocations of the thread.
+ */
+thread_local Linx::Index allocation_count = 0;
+
+/**
+ * @brief The number of bytes allocated by the thread.
+ */
+thread_local Linx::Index allocated_bytes = 0;
+
+} // namespace
+
+MemoryUsage& MemoryUsage::merge(const MemoryUsage& other)
+{
+  peak_rss = std::max(peak_rss, other.peak_rss);
+  if (allocation_count == -1 || other.allocation_count == -1) {
+    allocation_count = -1;
+    allocated_bytes = -1;
+  } else {
+    allocation_count += other.allocation_count;
+    allocated_bytes += other.allocated_bytes;
+  }
+  return *this;
+}
+
+std::vector<std::string> memory_columns()
+{
+  return {"Peak RSS (kB)", "Allocations", "Allocated (bytes)"};
+}
+
+MemoryMonitor::MemoryMonitor() : m_count(0), m_bytes(0), m_usage(), m_reset_peak(true) {}
+
+void MemoryMonitor::reset_peak_at_start(bool enabled)
+{
+  m_reset_peak = enabled;
+}
+
+void MemoryMonitor::start()
+{
+  if (m_reset_peak) {
+    reset_peak_rss();
+  }
+  m_count = allocation_count; // After reset_peak_rss(), which allocates
+  m_bytes = allocated_bytes;
+}
+
+const MemoryUsage& MemoryMonitor::stop()
+{
+  if (counts_allocations()) {
+    m_usage.allocation_count = allocation_count - m_count; // Before peak_rss(), which allocates
+    m_usage.allocated_bytes = allocated_bytes - m_bytes;
+  } else {
+    m_usage.allocation_count = -1;
+    m_usage.allocated_bytes = -1;
+  }
+  m_usage.peak_rss = peak_rss();
+  return m_usage;
+}
+
+const MemoryUsage& MemoryMonitor::usage() const
+{
+  return m_usage;
+}
+
+Linx::Index MemoryMonitor::peak_rss()
+{
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      Linx::Index kb = 0;
+      status >> kb;
+      return kb * 1024;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss; // Bytes
+#else
+  return usage.ru_maxrss * 1024; // kB
+#endif
+}
+
+bool MemoryMonitor::reset_peak_rss()
+{
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5"; // Reset VmHWM
+  clear_refs.flush();
+  return clear_refs.good();
+}
+
+bool MemoryMonitor::counts_allocations()
+{
+  return allocation_hook;
+}
+
+void MemoryMonitor::enable_allocation_count() noexcept
+{
+  allocation_hook = true;
+}
+
+void MemoryMonitor::count_allocation(std::size_t bytes) noexcept
+{
+  ++allocation_count;
+  allocated_bytes += bytes;
+}
+
+} // namespace Validation
+} // namespace Fits
@@ -0,0 +1,161 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsValidation/Microbenchmark.h"
+
+#include "EleFitsValidation/CsvAppender.h"
+
+#include <algorithm> // minmax_element, sort
+#include <cmath> // sqrt
+#include <fstream>
+#include <numeric> // accumulate
+
+namespace Fits {
+namespace Validation {
+
+namespace {
+
+/**
+ * @brief Time a number of calls, in nanoseconds.
+ */
+double time_calls(const std::function<void()>& body, Linx::Index iterations)
+{
+  const auto tic = std::chrono::steady_clock::now();
+  for (Linx::Index i = 0; i < iterations; ++i) {
+    body();
+  }
+  const auto toc = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(toc - tic).count();
+}
+
+double throughput(const MicrobenchmarkResult& result)
+{
+  return result.bytes > 0 && result.median > 0 ? result.bytes * 1.e3 / result.median : 0; // MB/s
+}
+
+} // namespace
+
+Microbenchmark::Microbenchmark(std::chrono::nanoseconds min_time, Linx::Index repetitions) :
+    m_min_time(min_time), m_repetitions(std::max<Linx::Index>(repetitions, 1)), m_entries()
+{}
+
+void Microbenchmark::add(const std::string& name, std::function<void()> body, Linx::Index bytes)
+{
+  m_entries.push_back({name, std::move(body), bytes});
+}
+
+std::vector<std::string> Microbenchmark::names() const
+{
+  std::vector<std::string> out;
+  for (const auto& e : m_entries) {
+    out.push_back(e.name);
+  }
+  return out;
+}
+
+std::vector<MicrobenchmarkResult> Microbenchmark::run(const std::string& filter) const
+{
+  std::vector<MicrobenchmarkResult> out;
+  for (const auto& e : m_entries) {
+    if (e.name.find(filter) != std::string::npos) {
+      out.push_back(run(e.name, e.body, e.bytes));
+    }
+  }
+  return out;
+}
+
+MicrobenchmarkResult Microbenchmark::run(const std::string& name, const std::function<void()>& body, Linx::Index bytes)
+    const
+{
+  MicrobenchmarkResult out;
+  out.name = name;
+  out.bytes = bytes;
+  out.repetitions = m_repetitions;
+
+  /* Calibrate (also warms up caches) */
+
+  const double min_time = m_min_time.count();
+  Linx::Index iterations = 1;
+  double elapsed = time_calls(body, iterations);
+  while (elapsed < min_time && iterations < (Linx::Index(1) << 40)) {
+    const double factor = elapsed > 0 ? min_time / elapsed * 1.2 : 10;
+    iterations = std::max(iterations + 1, static_cast<Linx::Index>(iterations * std::min(factor, 10.)));
+    elapsed = time_calls(body, iterations);
+  }
+  out.iterations = iterations;
+
+  /* Measure */
+
+  out.samples.reserve(m_repetitions);
+  for (Linx::Index r = 0; r < m_repetitions; ++r) {
+    out.samples.push_back(time_calls(body, iterations) / iterations);
+  }
+
+  /* Summarize */
+
+  const auto size = static_cast<double>(out.samples.size());
+  out.mean = std::accumulate(out.samples.begin(), out.samples.end(), 0.) / size;
+  double sum2 = 0;
+  for (auto s : out.samples) {
+    sum2 += (s - out.mean) * (s - out.mean);
+  }
+  out.stdev = size > 1 ? std::sqrt(sum2 / (size - 1)) : 0;
+  auto sorted = out.samples;
+  std::sort(sorted.begin(), sorted.end());
+  out.min = sorted.front();
+  out.max = sorted.back();
+  const auto middle = sorted.size() / 2;
+  out.median = sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+  return out;
+}
+
+void Microbenchmark::write_csv(const std::vector<MicrobenchmarkResult>& results, const std::string& filename)
+{
+  CsvAppender writer(
+      filename,
+      {"Benchmark",
+       "Iterations",
+       "Repetitions",
+       "Mean (ns)",
+       "Stdev (ns)",
+       "Min (ns)",
+       "Median (ns)",
+       "Max (ns)",
+       "Bytes",
+       "Throughput (MB/s)"});
+  for (const auto& r : results) {
+    writer.write_row(
+        r.name,
+        r.iterations,
+        r.repetitions,
+        r.mean,
+        r.stdev,
+        r.min,
+        r.median,
+        r.max,
+        r.bytes,
+        throughput(r));
+  }
+}
+
+void Microbenchmark::write_json(const std::vector<MicrobenchmarkResult>& results, const std::string& filename)
+{
+  std::ofstream os(filename);
+  os << "{\n  \"time_unit\": \"ns\",\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    os << (i == 0 ? "" : ",") << "\n    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+       << ", \"repetitions\": " << r.repetitions << ", \"mean\": " << r.mean << ", \"stdev\": " << r.stdev
+       << ", \"min\": " << r.min << ", \"median\": " << r.median << ", \"max\": " << r.max
+       << ", \"bytes\": " << r.bytes << ", \"throughput\": " << throughput(r) << ", \"samples\": [";
+    for (std::size_t j = 0; j < r.samples.size(); ++j) {
+      os << (j == 0 ? "" : ", ") << r.samples[j];
+    }
+    os << "]}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+} // namespace Validation
+} // namespace Fits
@@ -0,0 +1,275 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/MefFile.h"
+#include "EleFits/TilingTable.h"
+#include "EleFitsValidation/Chronometer.h"
+#include "EleFitsValidation/CsvAppender.h"
+#include "ElementsKernel/ProgramHeaders.h"
+#include "Linx/Run/ProgramOptions.h"
+
+#include <algorithm> // max, min
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Fits;
+
+static Elements::Logging logger = Elements::Logging::getLogger("EleFitsOptimizeTiling");
+
+/**
+ * @brief The accumulated measurements of a candidate tiling.
+ */
+struct Measure {
+  Linx::Index hdu_count = 0; ///< The number of HDUs the candidate was applied to
+  double raw_bytes = 0; ///< The uncompressed data size
+  double compressed_bytes = 0; ///< The compressed HDU size
+  double compress_seconds = 0; ///< The compression time
+  double decompress_seconds = 0; ///< The decompression time
+  double cutout_seconds = 0; ///< The mean cutout time, summed over HDUs
+};
+
+std::vector<std::string> split(const std::string& list, char sep = ',')
+{
+  std::vector<std::string> out;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, sep)) {
+    if (not item.empty()) {
+      out.push_back(item);
+    }
+  }
+  return out;
+}
+
+std::string to_string(const Linx::Position<-1>& tiling)
+{
+  std::string out;
+  for (std::size_t i = 0; i < tiling.size(); ++i) {
+    out += (i == 0 ? "" : " ") + std::to_string(tiling[i]);
+  }
+  return out;
+}
+
+/**
+ * @brief Row-wise, square and whole-image tilings.
+ */
+std::vector<Linx::Position<-1>> candidate_tilings()
+{
+  std::vector<Linx::Position<-1>> out;
+  for (Linx::Index rows : {1, 2, 4, 8, 16, 32, 64}) {
+    out.push_back(Tile::rowwise(rows));
+  }
+  for (Linx::Index side : {32, 64, 128, 256, 512}) {
+    out.push_back({side, side});
+  }
+  out.push_back(Tile::whole());
+  return out;
+}
+
+void set_strategy(MefFile& f, const std::string& algo, const Linx::Position<-1>& tiling, bool lossy)
+{
+  Quantization q(lossy ? Tile::rms / 16 : 0);
+  if (algo == "Gzip") {
+    f.strategy(Compress<Gzip>(tiling, q));
+  } else if (algo == "ShuffledGzip") {
+    f.strategy(Compress<ShuffledGzip>(tiling, q));
+  } else if (algo == "Rice") {
+    f.strategy(Compress<Rice>(tiling, q));
+  } else if (algo == "HCompress") {
+    f.strategy(Compress<HCompress>(tiling, q, Scaling(0)));
+  } else if (algo == "Plio") {
+    f.strategy(Compress<Plio>(tiling, q));
+  } else {
+    throw FitsError(std::string("Unknown compression algorithm: ") + algo);
+  }
+}
+
+/**
+ * @brief Measure each algorithm and tiling on an image HDU.
+ * @details
+ * Unsuitable algorithms (e.g. Plio for floating point data) and tilings (e.g. HCompress tiles of less than 4 rows)
+ * are skipped.
+ */
+template <typename T>
+void sweep(
+    const std::string& filename,
+    const ImageHdu& hdu,
+    const std::vector<std::string>& algos,
+    bool lossy,
+    Linx::Index cutout,
+    std::map<std::pair<std::string, Linx::Index>, std::map<std::string, Measure>>& measures,
+    Validation::CsvAppender& writer)
+{
+  const auto raster = hdu.raster().read<T, 2>();
+  const auto shape = raster.shape();
+  const double raw_bytes = raster.size() * sizeof(T);
+  const auto side = std::min({cutout, shape[0], shape[1]});
+  const Linx::Position<-1> image_shape {shape[0], shape[1]};
+  constexpr Linx::Index cutout_count = 16;
+  Validation::Chronometer<std::chrono::microseconds> chrono;
+
+  for (const auto& algo : algos) {
+    for (const auto& tiling : candidate_tilings()) {
+      if (algo == "HCompress" && not is_hcompress_tiling(tiling, image_shape)) {
+        continue; // Rejected by CFITSIO
+      }
+      MefFile f("mem://", FileMode::Create);
+      set_strategy(f, algo, tiling, lossy);
+
+      chrono.start();
+      const auto& z = f.append_image("", {}, raster);
+      const double compress_seconds = chrono.stop().count() / 1.e6;
+      if (not z.is_compressed()) {
+        continue; // Unsuitable algorithm
+      }
+
+      chrono.start();
+      z.raster().read<T, 2>();
+      const double decompress_seconds = chrono.stop().count() / 1.e6;
+
+      chrono.start();
+      for (Linx::Index i = 0; i < cutout_count; ++i) {
+        const Linx::Position<2> front {
+            (shape[0] - side) * i / (cutout_count - 1),
+            (shape[1] - side) * (cutout_count - 1 - i) / (cutout_count - 1)};
+        z.raster().read_region<T, 2>(Linx::Box<2>::from_shape(front, {side, side}));
+      }
+      const double cutout_seconds = chrono.stop().count() / 1.e6 / cutout_count;
+
+      const double compressed_bytes = z.size_in_file();
+      auto& m = measures[{algo, bitpix<T>()}][to_string(tiling)];
+      ++m.hdu_count;
+      m.raw_bytes += raw_bytes;
+      m.compressed_bytes += compressed_bytes;
+      m.compress_seconds += compress_seconds;
+      m.decompress_seconds += decompress_seconds;
+      m.cutout_seconds += cutout_seconds;
+
+      writer.write_row(
+          filename,
+          hdu.index(),
+          bitpix<T>(),
+          algo,
+          to_string(tiling),
+          raw_bytes,
+          compressed_bytes,
+          raw_bytes / compressed_bytes,
+          raw_bytes / compress_seconds / 1.e6,
+          raw_bytes / decompress_seconds / 1.e6,
+          cutout_seconds * 1.e3);
+    }
+  }
+}
+
+#define SWEEP_IF_TYPEID_MATCHES(type, name) \
+  if (hdu.read_typeid() == typeid(type)) { \
+    return sweep<type>(filename, hdu, algos, lossy, cutout, measures, writer); \
+  }
+
+void sweep_any(
+    const std::string& filename,
+    const ImageHdu& hdu,
+    const std::vector<std::string>& algos,
+    bool lossy,
+    Linx::Index cutout,
+    std::map<std::pair<std::string, Linx::Index>, std::map<std::string, Measure>>& measures,
+    Validation::CsvAppender& writer)
+{
+  ELEFITS_FOREACH_RASTER_TYPE(SWEEP_IF_TYPEID_MATCHES)
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options(
+      "Sweep tilings of compression algorithms over a corpus of FITS files, and output a tuned tiling table.");
+  options.positional<std::string>("inputs", "Comma-separated list of input files");
+  options.positional<std::string>("output", "Output tiling table (to be loaded with TilingTable::load())");
+  options.named<std::string>("algos", "Comma-separated list of algorithms", "Gzip,ShuffledGzip,Rice,HCompress,Plio");
+  options.flag("lossy", "Allow lossy compression");
+  options.named<Linx::Index>("cutout", "Cutout side length, in pixels", 64);
+  options.named<double>("time", "Cost of compression and decompression time, in ratio inverse per s/MB", 0.1);
+  options.named<double>("latency", "Cost of the cutout latency, in ratio inverse per ms", 0.01);
+  options.named<std::string>("metrics", "Per-HDU measurements output file", "/tmp/tilingMetrics.csv");
+  options.parse(argc, argv);
+
+  const auto inputs = split(options.as<std::string>("inputs"));
+  const auto output = options.as<std::string>("output");
+  const auto algos = split(options.as<std::string>("algos"));
+  const auto lossy = options.as<bool>("lossy");
+  const auto cutout = options.as<Linx::Index>("cutout");
+  const auto time_cost = options.as<double>("time");
+  const auto latency_cost = options.as<double>("latency");
+
+  Validation::CsvAppender writer(
+      options.as<std::string>("metrics"),
+      {"Filename",
+       "HDU",
+       "Bitpix",
+       "Algorithm",
+       "Tiling",
+       "Raw size (bytes)",
+       "Compressed size (bytes)",
+       "Compression ratio",
+       "Compression (MB/s)",
+       "Decompression (MB/s)",
+       "Cutout (ms)"});
+
+  /* Measure */
+  std::map<std::pair<std::string, Linx::Index>, std::map<std::string, Measure>> measures;
+  for (const auto& input : inputs) {
+    logger.info() << "Sweeping: " << input;
+    MefFile f(input, FileMode::Read);
+    for (const auto& hdu : f.filter<ImageHdu>(HduCategory::Image)) {
+      if (hdu.read_shape<-1>().size() != 2) {
+        logger.info() << "  Skipping HDU #" << hdu.index() << ": not a 2D image";
+        continue;
+      }
+      logger.info() << "  HDU #" << hdu.index() << ": " << hdu.read_name();
+      sweep_any(input, hdu, algos, lossy, cutout, measures, writer);
+    }
+  }
+
+  /* Select */
+  TilingTable table;
+  for (const auto& group : measures) {
+    const auto& algo = group.first.first;
+    const auto bitpix = group.first.second;
+    Linx::Index hdu_count = 0;
+    for (const auto& c : group.second) {
+      hdu_count = std::max(hdu_count, c.second.hdu_count);
+    }
+    std::string best;
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (const auto& c : group.second) {
+      const auto& m = c.second;
+      if (m.hdu_count < hdu_count) {
+        continue; // Not applicable to every HDU
+      }
+      const auto megabytes = m.raw_bytes / 1.e6;
+      const auto cost = m.compressed_bytes / m.raw_bytes +
+          time_cost * (m.compress_seconds + m.decompress_seconds) / megabytes +
+          latency_cost * m.cutout_seconds * 1.e3 / m.hdu_count;
+      if (cost < best_cost) {
+        best = c.first;
+        best_cost = cost;
+      }
+    }
+    std::vector<Linx::Index> lengths;
+    std::stringstream ss(best);
+    Linx::Index length;
+    while (ss >> length) {
+      lengths.push_back(length);
+    }
+    table.set(algo, bitpix, 2, Linx::Position<-1>(std::move(lengths))); // Only 2D images were measured
+    logger.info() << algo << " (BITPIX = " << bitpix << "): " << best << " (cost = " << best_cost << ")";
+  }
+
+  table.save(output);
+  logger.info() << "Tiling table: " << output;
+
+  return 0;
+}
@@ -0,0 +1,231 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/MefFile.h"
+#include "EleFitsValidation/Chronometer.h"
+#include "EleFitsValidation/CsvAppender.h"
+#include "ElementsKernel/ProgramHeaders.h"
+#include "Linx/Run/ProgramOptions.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Fits;
+
+static Elements::Logging logger = Elements::Logging::getLogger("EleFitsReplayTrace");
+
+/**
+ * @brief The measurements of an event type.
+ */
+struct Measure {
+  Linx::Index count = 0; ///< The number of replayed events
+  Linx::Index failures = 0; ///< The number of events which could not be replayed
+  Linx::Index bytes = 0; ///< The number of bytes read or written
+  Validation::Chronometer<std::chrono::microseconds> chrono; ///< The timer
+};
+
+template <typename T>
+void read_image(const ImageHdu& hdu, const DataAccess& access)
+{
+  hdu.raster().read_region<T, -1>(access.region());
+}
+
+template <typename T>
+void write_image(const ImageHdu& hdu, const DataAccess& access)
+{
+  const Linx::Raster<T, -1> raster(access.shape);
+  hdu.raster().write_region(access.front, raster);
+}
+
+template <typename T>
+void read_column(const BintableHdu& hdu, const DataAccess& access)
+{
+  hdu.columns().read_segment<T>(access.rows, access.column);
+}
+
+template <typename T>
+void write_column(const BintableHdu& hdu, const DataAccess& access)
+{
+  const auto& columns = hdu.columns();
+  VecColumn<T> column(columns.read_info<T>(access.column), access.rows.size());
+  columns.write_segment(access.rows.front, column);
+}
+
+#define REPLAY_IMAGE_IF_TYPEID_MATCHES(T, name) \
+  if (*access.type == typeid(T)) { \
+    return write ? write_image<T>(hdu, access) : read_image<T>(hdu, access); \
+  }
+
+void replay_image(const ImageHdu& hdu, const DataAccess& access, bool write)
+{
+  ELEFITS_FOREACH_RASTER_TYPE(REPLAY_IMAGE_IF_TYPEID_MATCHES)
+  throw FitsError("Unsupported image value type: " + access.type_name());
+}
+
+#define REPLAY_COLUMN_IF_TYPEID_MATCHES(T, name) \
+  if (*access.type == typeid(T)) { \
+    return write ? write_column<T>(hdu, access) : read_column<T>(hdu, access); \
+  }
+
+void replay_column(const BintableHdu& hdu, const DataAccess& access, bool write)
+{
+  ELEFITS_FOREACH_COLUMN_TYPE(REPLAY_COLUMN_IF_TYPEID_MATCHES)
+  throw FitsError("Unsupported column value type: " + access.type_name());
+}
+
+/**
+ * @brief Set the strategy under which the trace is replayed.
+ */
+void set_strategy(MefFile& f, const std::string& strategy)
+{
+  f.strategy().clear();
+  if (strategy == "DEFAULT") {
+    f.strategy(CiteEleFits());
+  } else if (strategy == "CHECKSUMS") {
+    f.strategy(VerifyChecksums());
+  } else if (strategy != "NONE") {
+    throw FitsError(std::string("Unknown strategy: ") + strategy);
+  }
+}
+
+/**
+ * @brief Replay an event.
+ */
+void replay(MefFile& f, const TraceEvent& event)
+{
+  switch (event.type) {
+    case TraceEvent::Type::Access:
+      f.access<Hdu>(event.hdu);
+      return;
+    case TraceEvent::Type::Parse: {
+      const auto& header = f.access<Hdu>(event.hdu).header();
+      for (const auto& k : event.keywords) { // Keywords which fell back to a default value may be missing
+        header.parse_or<VariantValue>(Record<VariantValue>(k, VariantValue()));
+      }
+      return;
+    }
+    case TraceEvent::Type::Read:
+    case TraceEvent::Type::Write: {
+      const bool write = event.type == TraceEvent::Type::Write;
+      if (event.data.is_image()) {
+        replay_image(f.access<ImageHdu>(event.hdu), event.data, write);
+      } else {
+        replay_column(f.access<BintableHdu>(event.hdu), event.data, write);
+      }
+      return;
+    }
+  }
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options(
+      "Replay an access trace recorded with action TraceAccesses against a file, and measure the replay time.");
+  options.positional<std::string>("trace", "Input trace file");
+  options.positional<std::string>("input", "Input FITS file");
+  options.flag("write", "Replay writes, too (the input file is modified)");
+  options.named<Linx::Index>("cache", "Tile cache budget for compressed images, in MB (0 to disable)", 0);
+  options.named<Linx::Index>("repeat", "Number of replays", 1);
+  options.named<std::string>(
+      "strategy",
+      "Strategy of the replayed file: none (NONE), default (DEFAULT), checksum verification (CHECKSUMS)",
+      "NONE");
+  options.named<std::string>("output", "Output results file", "/tmp/replay.csv");
+  options.parse(argc, argv);
+
+  const auto trace = options.as<std::string>("trace");
+  const auto input = options.as<std::string>("input");
+  const auto write = options.as<bool>("write");
+  const auto cache = options.as<Linx::Index>("cache");
+  const auto repeat = options.as<Linx::Index>("repeat");
+  const auto strategy = options.as<std::string>("strategy");
+
+  const auto events = TraceAccesses::load(trace);
+  logger.info() << "Loaded " << events.size() << " events from: " << trace;
+
+  Validation::CsvAppender writer(
+      options.as<std::string>("output"),
+      {"Trace",
+       "File",
+       "Strategy",
+       "Replay",
+       "Events",
+       "Failures",
+       "Access (ms)",
+       "Parse (ms)",
+       "Read (ms)",
+       "Write (ms)",
+       "Read (bytes)",
+       "Written (bytes)",
+       "Total (ms)"});
+
+  const std::vector<TraceEvent::Type> types {
+      TraceEvent::Type::Access,
+      TraceEvent::Type::Parse,
+      TraceEvent::Type::Read,
+      TraceEvent::Type::Write};
+
+  for (Linx::Index r = 0; r < repeat; ++r) {
+    std::map<TraceEvent::Type, Measure> measures;
+    Validation::Chronometer<std::chrono::microseconds> total;
+    total.start();
+    {
+      MefFile f(input, write ? FileMode::Edit : FileMode::Read);
+      set_strategy(f, strategy);
+      for (const auto& event : events) {
+        auto& m = measures[event.type];
+        if (event.type == TraceEvent::Type::Write && not write) {
+          continue;
+        }
+        if (cache > 0 && event.type == TraceEvent::Type::Read && event.data.is_image()) {
+          const auto& raster = f.access<ImageHdu>(event.hdu).raster();
+          if (not raster.tile_cache()) {
+            raster.cache_tiles(cache * 1024 * 1024);
+          }
+        }
+        m.chrono.start();
+        try {
+          replay(f, event);
+          ++m.count;
+          m.bytes += event.data.bytes;
+        } catch (FitsError& e) {
+          ++m.failures;
+          logger.warn() << "Cannot replay: " << event.to_string() << " (" << e.what() << ")";
+        }
+        m.chrono.stop();
+      }
+    }
+    total.stop();
+
+    Linx::Index count = 0;
+    Linx::Index failures = 0;
+    std::vector<double> milliseconds;
+    for (auto t : types) {
+      const auto& m = measures[t];
+      count += m.count;
+      failures += m.failures;
+      milliseconds.push_back(m.chrono.elapsed().count() / 1000.);
+    }
+    const auto total_ms = total.elapsed().count() / 1000.;
+    writer.write_row(
+        trace,
+        input,
+        strategy,
+        r,
+        count,
+        failures,
+        milliseconds[0],
+        milliseconds[1],
+        milliseconds[2],
+        milliseconds[3],
+        measures[TraceEvent::Type::Read].bytes,
+        measures[TraceEvent::Type::Write].bytes,
+        total_ms);
+    logger.info() << "Replay #" << r << ": " << count << " events in " << total_ms << " ms (" << failures
+                  << " failures)";
+  }
+
+  return 0;
+}
@@ -2,22 +2,29 @@
 // This file is part of EleFits <github.com/CNES/EleFits>
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
+#include "EleCfitsioWrapper/FileWrapper.h"
 #include "EleFitsData/TestColumn.h"
 #include "EleFitsData/TestRaster.h"
 #include "EleFitsValidation/Benchmark.h"
 #include "EleFitsValidation/CfitsioBenchmark.h"
 #include "EleFitsValidation/CsvAppender.h"
 #include "EleFitsValidation/EleFitsBenchmark.h"
+#include "EleFitsValidation/MemoryMonitor.h"
 #include "ElementsKernel/ProgramHeaders.h"
 #include "Linx/Run/ProgramOptions.h"
 
 #include <boost/filesystem.hpp> // FIXME use std instead
 #include <chrono>
+#include <exception>
 #include <map>
 #include <string>
+#include <thread>
+#include <tuple> // apply
 
 using namespace Fits;
 
+ELEFITS_VALIDATION_COUNT_ALLOCATIONS()
+
 Validation::BenchmarkFactory init_factory()
 {
   Validation::BenchmarkFactory factory;
@@ -29,16 +36,162 @@ Validation::BenchmarkFactory init_factory()
   return factory;
 }
 
-template <typename T>
-std::string join(const std::vector<T>& values, const std::string& sep = ",")
-{
-  const auto begin = values.begin() + 1; // values[0] is used as initial value of accumulator
-  const auto end = values.end();
-  const auto init = std::to_string(values[0]);
-  return std::accumulate(begin, end, init, [&](const std::string& a, T b) {
-    return a + sep + std::to_string(b);
-  });
-}
+/**
+ * @brief A set of benchmarks of the same setup which are run concurrently, each in its own thread and file.
+ * @details
+ * With a single thread, the benchmark is run in the calling thread, on the given file.
+ * Otherwise, thread `i` works on a file suffixed with `_i`.
+ * If CFITSIO is not reentrant, a single thread is used, whatever the requested number of threads.
+ */
+class ConcurrentBenchmark {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  ConcurrentBenchmark(
+      const Validation::BenchmarkFactory& factory,
+      const std::string& setup,
+      const std::string& filename,
+      Linx::Index thread_count) :
+      m_filenames(),
+      m_benchmarks(),
+      m_merged(),
+      m_memory(),
+      m_walltime(),
+      m_logger(Elements::Logging::getLogger("EleFitsRunBenchmark"))
+  {
+    if (thread_count > 1 && not Cfitsio::FileAccess::is_reentrant()) {
+      m_logger.warn() << "CFITSIO is not reentrant: falling back to a single thread.";
+      thread_count = 1;
+    }
+    if (thread_count <= 1) {
+      m_filenames.push_back(filename);
+    } else {
+      const boost::filesystem::path path(filename);
+      for (Linx::Index i = 0; i < thread_count; ++i) {
+        auto name = path.parent_path() / (path.stem().string() + "_" + std::to_string(i) + path.extension().string());
+        m_filenames.push_back(name.string());
+      }
+    }
+    for (const auto& f : m_filenames) {
+      auto benchmark = factory.create_benchmark(setup, f);
+      if (not benchmark) {
+        throw Validation::TestCaseNotImplemented(std::string("No setup named: ") + setup);
+      }
+      if (thread_count > 1) { // The peak RSS is that of the process, see run()
+        benchmark->reset_peak_at_start(false);
+      }
+      m_benchmarks.push_back(std::move(benchmark));
+    }
+  }
+
+  /**
+   * @brief Run some function of the benchmarks, e.g. `write_images()`, and merge the chronometers and memory usages.
+   * @details
+   * The first exception thrown by a thread, if any, is rethrown once all threads are joined.
+   * With several threads, the peak RSS is reset before starting them and read after joining them,
+   * instead of by each benchmark, which would reset the peak of the others.
+   */
+  template <typename TFunc>
+  const Validation::BChronometer& run(TFunc&& func)
+  {
+    const auto count = m_benchmarks.size();
+    std::vector<Validation::BChronometer> chronos(count);
+    std::vector<std::exception_ptr> errors(count);
+    m_walltime.reset();
+    m_walltime.start();
+    if (count == 1) {
+      chronos[0] = func(*m_benchmarks[0]);
+    } else {
+      Validation::MemoryMonitor::reset_peak_rss();
+      std::vector<std::thread> threads;
+      for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([&, i]() {
+          try {
+            chronos[i] = func(*m_benchmarks[i]);
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    }
+    m_walltime.stop();
+    const auto peak_rss = Validation::MemoryMonitor::peak_rss();
+    for (const auto& e : errors) {
+      if (e) {
+        std::rethrow_exception(e);
+      }
+    }
+    m_merged.reset();
+    m_memory = m_benchmarks[0]->memory();
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto& c = chronos[i];
+      m_logger.info() << "Thread " << i << ": median = " << c.milliseconds(c.median())
+                      << " ms, P99 = " << c.milliseconds(c.percentile(99)) << " ms";
+      m_merged.merge(c);
+      if (i > 0) {
+        m_memory.merge(m_benchmarks[i]->memory());
+      }
+    }
+    if (count > 1) {
+      m_memory.peak_rss = peak_rss;
+    }
+    return m_merged;
+  }
+
+  /**
+   * @brief Get the memory usage of the last run.
+   * @details
+   * The peak RSS is that of the process, and allocations are summed over the threads.
+   */
+  const Validation::MemoryUsage& memory() const
+  {
+    return m_memory;
+  }
+
+  /**
+   * @brief Get the number of threads.
+   */
+  Linx::Index thread_count() const
+  {
+    return m_benchmarks.size();
+  }
+
+  /**
+   * @brief Get the total size of the files.
+   */
+  Linx::Index file_size() const
+  {
+    Linx::Index size = 0;
+    for (const auto& f : m_filenames) {
+      size += boost::filesystem::file_size(f);
+    }
+    return size;
+  }
+
+  /**
+   * @brief Compute the aggregate throughput of the last run, in MB/s.
+   * @param bytes The number of bytes processed by each thread
+   */
+  double throughput(Linx::Index bytes) const
+  {
+    const auto ms = m_walltime.milliseconds(m_walltime.last().count());
+    return ms > 0 ? static_cast<double>(bytes) * thread_count() / ms / 1000 : 0; // B/ms to MB/s
+  }
+
+private:
+
+  std::vector<std::string> m_filenames;
+  std::vector<std::unique_ptr<Validation::Benchmark>> m_benchmarks;
+  Validation::BChronometer m_merged;
+  Validation::MemoryUsage m_memory;
+  Validation::BChronometer m_walltime;
+  Elements::Logging m_logger;
+};
 
 int main(int argc, char const* argv[])
 {
@@ -48,6 +201,10 @@ int main(int argc, char const* argv[])
   options.named<Linx::Index>("pixels", "Number of pixels", 1);
   options.named<Linx::Index>("tables", "Number of binary table extensions", 0);
   options.named<Linx::Index>("rows", "Number of rows", 1);
+  options.named<Linx::Index>(
+      "threads",
+      "Number of concurrent benchmarks, each on its own file (1 if CFITSIO is not reentrant)",
+      1);
   options.named<std::string>("output", "Output FITS file", "/tmp/test.fits");
   options.named<std::string>("res", "Output result file", "/tmp/benchmark.csv");
   options.parse(argc, argv);
@@ -59,6 +216,7 @@ int main(int argc, char const* argv[])
   const auto pixel_count = options.as<Linx::Index>("pixels");
   const auto table_count = options.as<Linx::Index>("tables");
   const auto row_count = options.as<Linx::Index>("rows");
+  const auto thread_count = options.as<Linx::Index>("threads");
   const auto filename = options.as<std::string>("output");
   const auto results = options.as<std::string>("res");
 
@@ -68,51 +226,49 @@ int main(int argc, char const* argv[])
   for (const auto& k : factory.keys()) {
     logger.info(k);
   }
-  auto benchmark = factory.create_benchmark(test_setup, filename);
-  if (not benchmark) {
-    throw Validation::TestCaseNotImplemented(std::string("No setup named: ") + test_setup);
-  }
-  Validation::CsvAppender writer(
-      results,
-      {"Date",
-       "Test setup",
-       "Mode",
-       "HDU type",
-       "HDU count",
-       "Value count / HDU",
-       "Total value count",
-       "File size (bytes)",
-       "Elapsed (ms)",
-       "Min (ms)",
-       "Max (ms)",
-       "Mean (ms)",
-       "Standard deviation (ms)",
-       "Samples (ms)"});
+  ConcurrentBenchmark benchmark(factory, test_setup, filename, thread_count);
+  std::vector<std::string> header {
+      "Date",
+      "Test setup",
+      "Mode",
+      "HDU type",
+      "HDU count",
+      "Value count / HDU",
+      "Total value count",
+      "File size (bytes)",
+      "Threads",
+      "Throughput (MB/s)"};
+  const auto statistics = Validation::statistics_columns();
+  header.insert(header.end(), statistics.begin(), statistics.end());
+  Validation::CsvAppender writer(results, header);
+  const auto date = Validation::timestamp();
 
   if (image_count) {
     logger.info("Generating raster...");
 
     const Validation::BRaster raster = Test::RandomRaster<std::int64_t, 1>({pixel_count});
+    const Linx::Index bytes = image_count * pixel_count * sizeof(std::int64_t);
 
     logger.info("Writing image HDUs...");
 
     try {
-      const auto chrono = benchmark->write_images(image_count, raster);
-      writer.write_row(
-          "TODO",
+      const auto& chrono = benchmark.run([&](Validation::Benchmark& b) {
+        return b.write_images(image_count, raster);
+      });
+      Validation::write_statistics_row(
+          writer,
+          chrono,
+          benchmark.memory(),
+          date,
           test_setup,
           "Write",
           "Image",
           image_count,
           pixel_count,
           image_count * pixel_count,
-          boost::filesystem::file_size(filename),
-          chrono.elapsed().count(),
-          chrono.min(),
-          chrono.max(),
-          chrono.mean(),
-          chrono.stdev(),
-          join(chrono.increments()));
+          benchmark.file_size(),
+          benchmark.thread_count(),
+          benchmark.throughput(bytes));
     } catch (const std::exception& e) {
       logger.warn() << e.what();
     }
@@ -120,22 +276,23 @@ int main(int argc, char const* argv[])
     logger.info("Reading image HDUs...");
 
     try {
-      const auto chrono = benchmark->read_images(1, image_count);
-      writer.write_row(
-          "TODO",
+      const auto& chrono = benchmark.run([&](Validation::Benchmark& b) {
+        return b.read_images(1, image_count);
+      });
+      Validation::write_statistics_row(
+          writer,
+          chrono,
+          benchmark.memory(),
+          date,
           test_setup,
           "Read",
           "Image",
           image_count,
           pixel_count,
           image_count * pixel_count,
-          boost::filesystem::file_size(filename),
-          chrono.elapsed().count(),
-          chrono.min(),
-          chrono.max(),
-          chrono.mean(),
-          chrono.stdev(),
-          join(chrono.increments()));
+          benchmark.file_size(),
+          benchmark.thread_count(),
+          benchmark.throughput(bytes));
     } catch (const std::exception& e) {
       logger.warn() << e.what();
     }
@@ -155,26 +312,34 @@ int main(int argc, char const* argv[])
         std::move(table.get_column<char>()),
         std::move(table.get_column<std::uint32_t>()),
         std::move(table.get_column<std::uint64_t>()));
+    Linx::Index bytes = 0;
+    std::apply(
+        [&](const auto&... c) {
+          ((bytes += c.size() * sizeof(*c.data())), ...);
+        },
+        columns);
+    bytes *= table_count;
 
     logger.info("Writing binary table HDUs...");
 
     try {
-      const auto chrono = benchmark->write_bintables(table_count, columns);
-      writer.write_row(
-          "TODO",
+      const auto& chrono = benchmark.run([&](Validation::Benchmark& b) {
+        return b.write_bintables(table_count, columns);
+      });
+      Validation::write_statistics_row(
+          writer,
+          chrono,
+          benchmark.memory(),
+          date,
           test_setup,
           "Write",
           "Binary table",
           table_count,
           row_count * Validation::ColumnCount,
           table_count * row_count * Validation::ColumnCount,
-          boost::filesystem::file_size(filename),
-          chrono.elapsed().count(),
-          chrono.min(),
-          chrono.max(),
-          chrono.mean(),
-          chrono.stdev(),
-          join(chrono.increments()));
+          benchmark.file_size(),
+          benchmark.thread_count(),
+          benchmark.throughput(bytes));
     } catch (const std::exception& e) {
       logger.warn() << e.what();
     }
@@ -182,22 +347,23 @@ int main(int argc, char const* argv[])
     logger.info("Reading binary table HDUs...");
 
     try {
-      const auto chrono = benchmark->read_bintables(1 + image_count, table_count);
-      writer.write_row(
-          "TODO",
+      const auto& chrono = benchmark.run([&](Validation::Benchmark& b) {
+        return b.read_bintables(1 + image_count, table_count);
+      });
+      Validation::write_statistics_row(
+          writer,
+          chrono,
+          benchmark.memory(),
+          date,
           test_setup,
           "Read",
           "Binary table",
           table_count,
           row_count * Validation::ColumnCount,
           table_count * row_count * Validation::ColumnCount,
-          boost::filesystem::file_size(filename),
-          chrono.elapsed().count(),
-          chrono.min(),
-          chrono.max(),
-          chrono.mean(),
-          chrono.stdev(),
-          join(chrono.increments()));
+          benchmark.file_size(),
+          benchmark.thread_count(),
+          benchmark.throughput(bytes));
     } catch (const std::exception& e) {
       logger.warn() << e.what();
     }
@@ -0,0 +1,206 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsData/TestColumn.h"
+#include "EleFitsValidation/Benchmark.h"
+#include "EleFitsValidation/CfitsioBenchmark.h"
+#include "EleFitsValidation/CsvAppender.h"
+#include "EleFitsValidation/EleFitsBenchmark.h"
+#include "EleFitsValidation/MemoryMonitor.h"
+#include "ElementsKernel/ProgramHeaders.h"
+#include "Linx/Run/ProgramOptions.h"
+
+#include <boost/filesystem.hpp> // FIXME use std instead
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace Fits;
+
+ELEFITS_VALIDATION_COUNT_ALLOCATIONS()
+
+static Elements::Logging logger = Elements::Logging::getLogger("EleFitsRunColumnBenchmark");
+
+Validation::BenchmarkFactory init_factory()
+{
+  Validation::BenchmarkFactory factory;
+  factory.register_benchmark<Validation::CfitsioBenchmark>("CFITSIO optimal", 0);
+  factory.register_benchmark<Validation::EleFitsBenchmark>("EleFits optimal");
+  return factory;
+}
+
+/**
+ * @brief Generate the columns of a wide table, named "COL0", "COL1"...
+ */
+std::vector<VecColumn<double>> make_double_columns(Linx::Index count, Linx::Index repeat, Linx::Index rows)
+{
+  std::vector<VecColumn<double>> out;
+  out.reserve(count);
+  for (Linx::Index i = 0; i < count; ++i) {
+    Test::RandomVectorColumn<double> column(repeat, rows);
+    column.rename("COL" + std::to_string(i));
+    out.push_back(std::move(column));
+  }
+  return out;
+}
+
+/**
+ * @copydoc make_double_columns
+ */
+std::vector<VecColumn<std::string>> make_string_columns(Linx::Index count, Linx::Index rows)
+{
+  std::vector<VecColumn<std::string>> out;
+  out.reserve(count);
+  for (Linx::Index i = 0; i < count; ++i) {
+    Test::RandomScalarColumn<std::string> column(rows);
+    column.rename("COL" + std::to_string(i));
+    out.push_back(std::move(column));
+  }
+  return out;
+}
+
+/**
+ * @brief The benchmark parameters which do not depend on the value type.
+ */
+struct ColumnCase {
+  std::string date; ///< The run timestamp
+  std::string setup; ///< The test setup
+  std::string filename; ///< The FITS file
+  Linx::Index row_count; ///< The number of rows
+  std::vector<Linx::Index> subset; ///< The selected column indices
+  std::vector<Segment> segments; ///< The row segments
+  std::string mode; ///< The read mode name
+};
+
+/**
+ * @brief Write a wide table of given columns and read subsets of it.
+ */
+template <typename T>
+void run_case(
+    const Validation::BenchmarkFactory& factory,
+    const ColumnCase& test_case,
+    const std::vector<VecColumn<T>>& columns,
+    const std::string& type,
+    Validation::CsvAppender& writer)
+{
+  logger.info() << "Benchmarking " << columns.size() << " " << type << " columns...";
+  auto benchmark = factory.create_benchmark(test_case.setup, test_case.filename);
+  const Linx::Index column_count = columns.size();
+  const auto repeat = columns[0].info().repeat_count();
+  const auto row_bytes = std::is_same<T, std::string>::value ? repeat : repeat * sizeof(T); // Per column
+
+  try {
+    const auto& chrono = benchmark->write_wide_bintables(1, columns);
+    const auto ms = chrono.milliseconds(chrono.elapsed().count());
+    Validation::write_statistics_row(
+        writer,
+        chrono,
+        benchmark->memory(),
+        test_case.date,
+        test_case.setup,
+        "Write",
+        type,
+        column_count,
+        column_count,
+        repeat,
+        test_case.row_count,
+        test_case.row_count,
+        boost::filesystem::file_size(test_case.filename),
+        ms > 0 ? column_count * test_case.row_count * row_bytes / ms / 1000 : 0);
+  } catch (const std::exception& e) {
+    logger.warn() << e.what();
+    return;
+  }
+
+  try {
+    const auto& chrono = benchmark->read_column_subsets<T>(
+        1,
+        test_case.subset,
+        test_case.segments,
+        Validation::parse_column_read_mode(test_case.mode));
+    const auto ms = chrono.milliseconds(chrono.elapsed().count());
+    const auto segment_size = test_case.segments[0].size();
+    Linx::Index read_rows = 0; // The last segment may be clipped
+    for (const auto& s : test_case.segments) {
+      read_rows += test_case.mode == "read_n" ? test_case.row_count : s.size();
+    }
+    const auto read_bytes = test_case.subset.size() * read_rows * row_bytes;
+    Validation::write_statistics_row(
+        writer,
+        chrono,
+        benchmark->memory(),
+        test_case.date,
+        test_case.setup,
+        "Read " + test_case.mode,
+        type,
+        column_count,
+        test_case.subset.size(),
+        repeat,
+        test_case.row_count,
+        segment_size,
+        boost::filesystem::file_size(test_case.filename),
+        ms > 0 ? read_bytes / ms / 1000 : 0);
+  } catch (const std::exception& e) {
+    logger.warn() << e.what();
+  }
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options("Benchmark reading subsets of columns and row segments of wide binary tables.");
+  options.named<std::string>("setup", "Test setup to be benchmarked", "EleFits optimal");
+  options.named<Linx::Index>("columns", "Number of columns of the table", 200);
+  options.named<Linx::Index>("select", "Number of (evenly spaced) columns to be read", 10);
+  options.named<Linx::Index>("repeat", "Repeat count of the numeric columns", 1);
+  options.flag("strings", "Benchmark string columns instead of double columns");
+  options.named<Linx::Index>("rows", "Number of rows", 10000);
+  options.named<Linx::Index>("segment", "Number of rows per segment", 1000);
+  options.named<Linx::Index>("segments", "Number of segments to be read", 10);
+  options.named<std::string>("mode", "Read mode: read_n, read_n_segments or per_column", "read_n_segments");
+  options.named<std::string>("output", "Output FITS file", "/tmp/test.fits");
+  options.named<std::string>("res", "Output result file", "/tmp/column_benchmark.csv");
+  options.parse(argc, argv);
+
+  const auto column_count = options.as<Linx::Index>("columns");
+  ColumnCase test_case;
+  test_case.date = Validation::timestamp();
+  test_case.setup = options.as<std::string>("setup");
+  test_case.filename = options.as<std::string>("output");
+  test_case.row_count = options.as<Linx::Index>("rows");
+  test_case.subset = Validation::make_column_subset(column_count, options.as<Linx::Index>("select"));
+  test_case.segments = Validation::make_segments(
+      test_case.row_count,
+      options.as<Linx::Index>("segment"),
+      options.as<Linx::Index>("segments"));
+  test_case.mode = options.as<std::string>("mode");
+  Validation::parse_column_read_mode(test_case.mode); // Fail early
+
+  const auto factory = init_factory();
+  std::vector<std::string> header {
+      "Date",
+      "Test setup",
+      "Mode",
+      "Type",
+      "Column count",
+      "Selected column count",
+      "Repeat count",
+      "Row count",
+      "Segment size",
+      "File size (bytes)",
+      "Throughput (MB/s)"};
+  const auto statistics = Validation::statistics_columns();
+  header.insert(header.end(), statistics.begin(), statistics.end());
+  Validation::CsvAppender writer(options.as<std::string>("res"), header);
+
+  if (options.as<bool>("strings")) {
+    run_case(factory, test_case, make_string_columns(column_count, test_case.row_count), "string", writer);
+  } else {
+    const auto repeat = options.as<Linx::Index>("repeat");
+    run_case(factory, test_case, make_double_columns(column_count, repeat, test_case.row_count), "double", writer);
+  }
+
+  logger.info("Done.");
+
+  return 0;
+}
@@ -169,8 +169,9 @@ int main(int argc, char const* argv[])
        "Elapsed (ms)",
        "Throughput (MB/s)"});
 
-  Fits::Validation::Chronometer<std::chrono::milliseconds> chrono;
-  Fits::Validation::Chronometer<std::chrono::milliseconds> walltime;
+  using Chrono = Fits::Validation::Chronometer<std::chrono::nanoseconds>;
+  Chrono chrono;
+  Chrono walltime;
   Linx::Index hdu_counter = 0;
   std::vector<std::string> algos;
   std::vector<Linx::Index> bitpixs;
@@ -221,8 +222,8 @@ int main(int argc, char const* argv[])
       hdu_size = hdu.size_in_file();
       z_hdu_size = z_hdu.size_in_file();
       ratio = static_cast<double>(hdu_size) / z_hdu_size;
-      double throughput = static_cast<double>(hdu_size) / chrono.last().count() / 1000; // converted from B/ms to MB/s
-      // warning: if elapsed less than 1ms, divides by zero -> throughput infinite
+      const auto elapsed = Chrono::milliseconds(chrono.last().count());
+      double throughput = static_cast<double>(hdu_size) / elapsed / 1000; // converted from B/ms to MB/s
       algo = read_algo_name(z_hdu.as<Fits::ImageHdu>());
       writer_hdu.write_row(
           input,
@@ -233,7 +234,7 @@ int main(int argc, char const* argv[])
           hdu_size,
           z_hdu_size,
           ratio,
-          chrono.last().count(),
+          elapsed,
           throughput);
       logger.info() << "HDU " << hdu.index() + 1 << "/" << hdu_count << ": " << algo;
     }
@@ -263,14 +264,14 @@ int main(int argc, char const* argv[])
       input_size,
       output_size,
       comp_ratio,
-      walltime.last().count(),
+      Chrono::milliseconds(walltime.last().count()),
       hdu_counter,
       join(bitpixs),
       join_string(algos),
       join(hdu_sizes),
       join(z_hdu_sizes),
       join(hdu_ratios),
-      join(chrono.increments()));
+      join(chrono.increments_as_milliseconds()));
 
   logger.info("Done.");
 
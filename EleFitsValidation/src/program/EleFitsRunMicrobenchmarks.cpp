@@ -0,0 +1,182 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFits/MefFile.h"
+#include "EleFitsData/TestColumn.h"
+#include "EleFitsData/TestRaster.h"
+#include "EleFitsValidation/Microbenchmark.h"
+#include "ElementsKernel/ProgramHeaders.h"
+#include "Linx/Run/ProgramOptions.h"
+
+#include <string>
+#include <vector>
+
+using namespace Fits;
+using Validation::do_not_optimize;
+
+static Elements::Logging logger = Elements::Logging::getLogger("EleFitsRunMicrobenchmarks");
+
+/**
+ * @brief Register the header benchmarks.
+ */
+void add_header_benchmarks(Validation::Microbenchmark& suite, const Header& header)
+{
+  std::vector<Record<int>> records;
+  for (int i = 0; i < 100; ++i) {
+    records.emplace_back("KEY" + std::to_string(i), i, "", "Benchmark record");
+  }
+  header.write_n(records);
+
+  suite.add("Header::parse", [&header]() {
+    do_not_optimize(header.parse<int>("KEY50"));
+  });
+  suite.add("Header::parse_all", [&header]() {
+    do_not_optimize(header.parse_all(KeywordCategory::User));
+  });
+  suite.add("Header::write_n", [&header, records]() {
+    header.write_n(records);
+  });
+  suite.add("KeywordCategory::belongsCategories", []() {
+    do_not_optimize(KeywordCategory::belongsCategories("NAXIS1", KeywordCategory::Reserved));
+    do_not_optimize(KeywordCategory::belongsCategories("KEY50", KeywordCategory::Reserved));
+  });
+  suite.add("HduCategory::operators", []() {
+    const auto category = HduCategory::Image & ~HduCategory::Primary;
+    do_not_optimize(HduCategory::RawImage.isInstance(category));
+    do_not_optimize(HduCategory::Primary.isInstance(category | HduCategory::Edited));
+  });
+}
+
+/**
+ * @brief Register the binary table benchmarks.
+ */
+void add_bintable_benchmarks(Validation::Microbenchmark& suite, const BintableHdu& hdu, Linx::Index row_count)
+{
+  const auto& columns = hdu.columns();
+  const auto bytes = row_count * (sizeof(std::int32_t) + sizeof(float) + sizeof(double));
+  suite.add(
+      "BintableColumns::read_n",
+      [&columns]() {
+        do_not_optimize(columns.read_n(as<std::int32_t>("INT"), as<float>("FLOAT"), as<double>("DOUBLE")));
+      },
+      bytes);
+  suite.add(
+      "BintableColumns::read_segment",
+      [&columns, row_count]() {
+        do_not_optimize(columns.read_segment<double>({row_count / 2, row_count / 2 + 99}, "DOUBLE"));
+      },
+      100 * sizeof(double));
+  const auto string_bytes = row_count * columns.read_info<std::string>("STRING").repeat_count();
+  suite.add(
+      "BintableColumns::read(string)",
+      [&columns]() {
+        do_not_optimize(columns.read<std::string>("STRING"));
+      },
+      string_bytes);
+}
+
+/**
+ * @brief Register the image benchmarks.
+ */
+void add_image_benchmarks(Validation::Microbenchmark& suite, const ImageHdu& hdu, Linx::Raster<float, 2>& cutout)
+{
+  const auto& raster = hdu.raster();
+  const auto shape = hdu.read_shape<2>();
+  const Linx::Position<2> front {(shape[0] - cutout.shape()[0]) / 2, (shape[1] - cutout.shape()[1]) / 2};
+  suite.add(
+      "ImageRaster::read_region_to",
+      [&raster, front, &cutout]() {
+        raster.read_region_to(front, cutout);
+        do_not_optimize(cutout.data());
+      },
+      cutout.size() * sizeof(float));
+}
+
+/**
+ * @brief Register the compression round-trip benchmarks.
+ */
+template <typename TAlgo>
+void add_compression_benchmark(
+    Validation::Microbenchmark& suite,
+    const std::string& name,
+    const Linx::Raster<std::int16_t, 2>& raster)
+{
+  suite.add(
+      "Compress<" + name + ">::round_trip",
+      [&raster]() {
+        MefFile f("mem://", FileMode::Create);
+        f.strategy().clear();
+        f.strategy(Compress<TAlgo>());
+        const auto& hdu = f.append_image("", {}, raster);
+        do_not_optimize(hdu.raster().read<std::int16_t, 2>());
+      },
+      raster.size() * sizeof(std::int16_t));
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options("Run microbenchmarks of the hot paths of EleFits.");
+  options.named<std::string>("filter", "Run only the benchmarks whose name contains this string", "");
+  options.named<double>("min-time", "Minimum duration of a repetition, in ms", 10);
+  options.named<Linx::Index>("repetitions", "Number of repetitions", 10);
+  options.named<Linx::Index>("rows", "Number of rows of the binary tables", 10000);
+  options.named<Linx::Index>("side", "Side length of the images (at least 64)", 1024);
+  options.named<std::string>("csv", "Output CSV file (appended)", "/tmp/microbenchmarks.csv");
+  options.named<std::string>("json", "Output JSON file (overwritten, empty for none)", "");
+  options.flag("list", "List the benchmarks and exit");
+  options.parse(argc, argv);
+
+  const auto min_time = std::chrono::nanoseconds(static_cast<Linx::Index>(options.as<double>("min-time") * 1.e6));
+  const auto row_count = options.as<Linx::Index>("rows");
+  const auto side = options.as<Linx::Index>("side");
+
+  /* Fixtures */
+
+  MefFile f("mem://", FileMode::Create);
+  f.strategy().clear();
+  Test::RandomScalarColumn<std::int32_t> int_column(row_count);
+  int_column.rename("INT");
+  Test::RandomScalarColumn<float> float_column(row_count);
+  float_column.rename("FLOAT");
+  Test::RandomScalarColumn<double> double_column(row_count);
+  double_column.rename("DOUBLE");
+  Test::RandomScalarColumn<std::string> string_column(row_count);
+  string_column.rename("STRING");
+  const auto& table = f.append_bintable("TABLE", {}, int_column, float_column, double_column, string_column);
+  const auto& image = f.append_image("IMAGE", {}, Test::RandomRaster<float, 2>({side, side}));
+  Linx::Raster<float, 2> cutout({64, 64});
+  const Test::RandomRaster<std::int16_t, 2> small({256, 256}, 0, 1000);
+
+  /* Registration */
+
+  Validation::Microbenchmark suite(min_time, options.as<Linx::Index>("repetitions"));
+  add_header_benchmarks(suite, f.primary().header());
+  add_bintable_benchmarks(suite, table, row_count);
+  add_image_benchmarks(suite, image, cutout);
+  add_compression_benchmark<Gzip>(suite, "Gzip", small);
+  add_compression_benchmark<Rice>(suite, "Rice", small);
+  add_compression_benchmark<HCompress>(suite, "HCompress", small);
+
+  if (options.as<bool>("list")) {
+    for (const auto& name : suite.names()) {
+      logger.info() << name;
+    }
+    return 0;
+  }
+
+  /* Run */
+
+  const auto results = suite.run(options.as<std::string>("filter"));
+  for (const auto& r : results) {
+    logger.info() << r.name << ": " << r.median << " ns (median), " << r.mean << " +/- " << r.stdev << " ns ("
+                  << r.iterations << " iterations x " << r.repetitions << ")";
+  }
+  Validation::Microbenchmark::write_csv(results, options.as<std::string>("csv"));
+  const auto json = options.as<std::string>("json");
+  if (not json.empty()) {
+    Validation::Microbenchmark::write_json(results, json);
+  }
+
+  return 0;
+}
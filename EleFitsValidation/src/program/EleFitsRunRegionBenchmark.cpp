@@ -0,0 +1,197 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsData/TestRaster.h"
+#include "EleFitsValidation/Benchmark.h"
+#include "EleFitsValidation/CfitsioBenchmark.h"
+#include "EleFitsValidation/CsvAppender.h"
+#include "EleFitsValidation/EleFitsBenchmark.h"
+#include "EleFitsValidation/MemoryMonitor.h"
+#include "ElementsKernel/ProgramHeaders.h"
+#include "Linx/Run/ProgramOptions.h"
+
+#include <boost/filesystem.hpp> // FIXME use std instead
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Fits;
+
+ELEFITS_VALIDATION_COUNT_ALLOCATIONS()
+
+static Elements::Logging logger = Elements::Logging::getLogger("EleFitsRunRegionBenchmark");
+
+Validation::BenchmarkFactory init_factory()
+{
+  Validation::BenchmarkFactory factory;
+  factory.register_benchmark<Validation::CfitsioBenchmark>("CFITSIO optimal", 0);
+  factory.register_benchmark<Validation::EleFitsBenchmark>("EleFits optimal");
+  return factory;
+}
+
+/**
+ * @brief Parse a shape, e.g. "1024,1024".
+ */
+Linx::Position<-1> parse_shape(const std::string& value)
+{
+  std::vector<Linx::Index> shape;
+  std::stringstream ss(value);
+  std::string length;
+  while (std::getline(ss, length, ',')) {
+    shape.push_back(std::stol(length));
+  }
+  return Linx::Position<-1>(shape);
+}
+
+/**
+ * @brief Format a shape, e.g. "1024x1024".
+ */
+std::string format_shape(const Linx::Position<-1>& shape)
+{
+  std::string out;
+  for (auto length : shape) {
+    out += (out.empty() ? "" : "x") + std::to_string(length);
+  }
+  return out;
+}
+
+/**
+ * @brief The benchmark parameters which do not depend on the value type.
+ */
+struct RegionCase {
+  std::string date; ///< The run timestamp
+  std::string setup; ///< The test setup
+  std::string filename; ///< The FITS file
+  Linx::Position<-1> shape; ///< The image shape
+  bool compressed; ///< The compression flag
+  std::string pattern; ///< The region pattern name
+  std::vector<Linx::Box<-1>> regions; ///< The regions
+};
+
+/**
+ * @brief Write an image of given type and read regions of it.
+ */
+template <typename T>
+void run_case(
+    const Validation::BenchmarkFactory& factory,
+    const RegionCase& test_case,
+    const std::string& type,
+    Validation::CsvAppender& writer)
+{
+  logger.info() << "Benchmarking type " << type << "...";
+  auto benchmark = factory.create_benchmark(test_case.setup, test_case.filename);
+  const Linx::Raster<T, -1> raster = Test::RandomRaster<T, -1>(test_case.shape);
+  const auto region_shape = format_shape(test_case.regions[0].shape());
+  const auto region_count = test_case.regions.size();
+
+  try {
+    const auto& chrono = benchmark->write_nd_images(1, raster, test_case.compressed);
+    const auto ms = chrono.milliseconds(chrono.elapsed().count());
+    Validation::write_statistics_row(
+        writer,
+        chrono,
+        benchmark->memory(),
+        test_case.date,
+        test_case.setup,
+        "Write",
+        type,
+        format_shape(test_case.shape),
+        test_case.compressed,
+        "",
+        "",
+        boost::filesystem::file_size(test_case.filename),
+        ms > 0 ? raster.size() * sizeof(T) / ms / 1000 : 0);
+  } catch (const std::exception& e) {
+    logger.warn() << e.what();
+    return;
+  }
+
+  try {
+    const auto& chrono = benchmark->read_regions<T>(1, test_case.regions);
+    const auto ms = chrono.milliseconds(chrono.elapsed().count());
+    Linx::Index bytes = 0;
+    for (const auto& r : test_case.regions) {
+      bytes += shape_size(r.shape()) * sizeof(T);
+    }
+    Validation::write_statistics_row(
+        writer,
+        chrono,
+        benchmark->memory(),
+        test_case.date,
+        test_case.setup,
+        "Read " + test_case.pattern,
+        type,
+        format_shape(test_case.shape),
+        test_case.compressed,
+        region_shape,
+        region_count,
+        boost::filesystem::file_size(test_case.filename),
+        ms > 0 ? bytes / ms / 1000 : 0);
+  } catch (const std::exception& e) {
+    logger.warn() << e.what();
+  }
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options("Benchmark image region reads, e.g. cutouts or strips.");
+  options.named<std::string>("setup", "Test setup to be benchmarked", "EleFits optimal");
+  options.named<std::string>("type", "Value type (e.g. int16, float), or all", "all");
+  options.named<std::string>("shape", "Comma-separated image shape, e.g. 1024,1024 or 256,256,64", "1024,1024");
+  options.flag("compressed", "Compress the images (lossless GZIP with row-wise tiles)");
+  options.named<std::string>("pattern", "Region pattern: random, sequential or strips", "random");
+  options.named<Linx::Index>("side", "Side length of the regions, or thickness of the strips", 64);
+  options.named<Linx::Index>("regions", "Number of regions", 100);
+  options.named<Linx::Index>("seed", "Random seed", 0);
+  options.named<std::string>("output", "Output FITS file", "/tmp/test.fits");
+  options.named<std::string>("res", "Output result file", "/tmp/region_benchmark.csv");
+  options.parse(argc, argv);
+
+  const auto type = options.as<std::string>("type");
+  RegionCase test_case;
+  test_case.date = Validation::timestamp();
+  test_case.setup = options.as<std::string>("setup");
+  test_case.filename = options.as<std::string>("output");
+  test_case.shape = parse_shape(options.as<std::string>("shape"));
+  test_case.compressed = options.as<bool>("compressed");
+  test_case.pattern = options.as<std::string>("pattern");
+  test_case.regions = Validation::make_regions(
+      test_case.shape,
+      Validation::parse_region_pattern(test_case.pattern),
+      options.as<Linx::Index>("side"),
+      options.as<Linx::Index>("regions"),
+      options.as<Linx::Index>("seed"));
+
+  const auto factory = init_factory();
+  std::vector<std::string> header {
+      "Date",
+      "Test setup",
+      "Mode",
+      "Type",
+      "Shape",
+      "Compressed",
+      "Region shape",
+      "Region count",
+      "File size (bytes)",
+      "Throughput (MB/s)"};
+  const auto statistics = Validation::statistics_columns();
+  header.insert(header.end(), statistics.begin(), statistics.end());
+  Validation::CsvAppender writer(options.as<std::string>("res"), header);
+
+  bool found = false;
+#define RUN_CASE_IF_SELECTED(T, name) \
+  if (type == "all" || type == #name) { \
+    run_case<T>(factory, test_case, #name, writer); \
+    found = true; \
+  }
+  ELEFITS_FOREACH_RASTER_TYPE(RUN_CASE_IF_SELECTED)
+#undef RUN_CASE_IF_SELECTED
+  if (not found) {
+    throw Validation::TestCaseNotImplemented("Value type: " + type);
+  }
+
+  logger.info("Done.");
+
+  return 0;
+}
@@ -39,6 +39,111 @@ BOOST_AUTO_TEST_CASE(factory_test)
   BOOST_TEST(pb1->m_d == 0.);
 }
 
+BOOST_AUTO_TEST_CASE(random_regions_test)
+{
+  const Linx::Position<-1> shape({100, 50});
+  const auto regions = Validation::make_regions(shape, Validation::RegionPattern::Random, 20, 10, 42);
+  BOOST_TEST(regions.size() == 10);
+  for (const auto& r : regions) {
+    BOOST_TEST(r.shape()[0] == 20);
+    BOOST_TEST(r.shape()[1] == 20);
+    BOOST_TEST(r.front()[0] >= 0);
+    BOOST_TEST(r.front()[1] >= 0);
+    BOOST_TEST(r.front()[0] + 20 <= 100);
+    BOOST_TEST(r.front()[1] + 20 <= 50);
+  }
+  const auto again = Validation::make_regions(shape, Validation::RegionPattern::Random, 20, 10, 42);
+  BOOST_TEST(again[9].front()[0] == regions[9].front()[0]); // Same seed
+}
+
+BOOST_AUTO_TEST_CASE(sequential_regions_test)
+{
+  const Linx::Position<-1> shape({4, 4});
+  const auto regions = Validation::make_regions(shape, Validation::RegionPattern::Sequential, 2, 5);
+  BOOST_TEST(regions[0].front()[0] == 0);
+  BOOST_TEST(regions[0].front()[1] == 0);
+  BOOST_TEST(regions[1].front()[0] == 2);
+  BOOST_TEST(regions[1].front()[1] == 0);
+  BOOST_TEST(regions[2].front()[0] == 0);
+  BOOST_TEST(regions[2].front()[1] == 2);
+  BOOST_TEST(regions[3].front()[0] == 2);
+  BOOST_TEST(regions[3].front()[1] == 2);
+  BOOST_TEST(regions[4].front()[0] == 0); // Wrap around
+  BOOST_TEST(regions[4].front()[1] == 0);
+}
+
+BOOST_AUTO_TEST_CASE(trailing_regions_are_clipped_test)
+{
+  const Linx::Position<-1> shape({5, 4});
+  const auto regions = Validation::make_regions(shape, Validation::RegionPattern::Sequential, 2, 4);
+  BOOST_TEST(regions[2].front()[0] == 4);
+  BOOST_TEST(regions[2].shape()[0] == 1); // Clipped
+  BOOST_TEST(regions[2].shape()[1] == 2);
+  BOOST_TEST(regions[3].front()[0] == 0);
+  BOOST_TEST(regions[3].front()[1] == 2);
+  BOOST_TEST(regions[3].shape()[0] == 2);
+
+  const Linx::Position<-1> cube({8, 6, 5});
+  const auto strips = Validation::make_regions(cube, Validation::RegionPattern::Strips, 2, 4);
+  BOOST_TEST(strips[2].front()[2] == 4);
+  BOOST_TEST(strips[2].shape()[2] == 1); // Clipped
+  BOOST_TEST(strips[3].front()[2] == 0);
+  BOOST_TEST(strips[3].shape()[2] == 2);
+}
+
+BOOST_AUTO_TEST_CASE(strip_regions_test)
+{
+  const Linx::Position<-1> shape({8, 6, 4});
+  const auto regions = Validation::make_regions(shape, Validation::RegionPattern::Strips, 2, 3);
+  for (const auto& r : regions) {
+    BOOST_TEST(r.shape()[0] == 8);
+    BOOST_TEST(r.shape()[1] == 6);
+    BOOST_TEST(r.shape()[2] == 2);
+  }
+  BOOST_TEST(regions[1].front()[2] == 2);
+  BOOST_TEST(regions[2].front()[2] == 0);
+  BOOST_CHECK_THROW(Validation::parse_region_pattern("diagonal"), Validation::TestCaseNotImplemented);
+}
+
+BOOST_AUTO_TEST_CASE(column_subset_test)
+{
+  const auto subset = Validation::make_column_subset(200, 4);
+  BOOST_TEST(subset.size() == 4);
+  BOOST_TEST(subset[0] == 0);
+  BOOST_TEST(subset[1] == 50);
+  BOOST_TEST(subset[2] == 100);
+  BOOST_TEST(subset[3] == 150);
+  const auto all = Validation::make_column_subset(3, 10);
+  BOOST_TEST(all.size() == 3);
+  BOOST_TEST(all[2] == 2);
+}
+
+BOOST_AUTO_TEST_CASE(segments_test)
+{
+  const auto segments = Validation::make_segments(25, 10, 4);
+  BOOST_TEST(segments.size() == 4);
+  BOOST_TEST(segments[0].front == 0);
+  BOOST_TEST(segments[0].back == 9);
+  BOOST_TEST(segments[1].front == 10);
+  BOOST_TEST(segments[1].back == 19);
+  BOOST_TEST(segments[2].front == 20);
+  BOOST_TEST(segments[2].back == 24); // Clipped
+  BOOST_TEST(segments[3].front == 0); // Wrap around
+  BOOST_TEST(segments[3].back == 9);
+  BOOST_TEST(Validation::make_segments(5, 10, 1)[0].size() == 5);
+  BOOST_TEST((Validation::parse_column_read_mode("per_column") == Validation::ColumnReadMode::PerColumn));
+  BOOST_CHECK_THROW(Validation::parse_column_read_mode("read_all"), Validation::TestCaseNotImplemented);
+}
+
+BOOST_AUTO_TEST_CASE(timestamp_test)
+{
+  const auto date = Validation::timestamp(); // YYYY-MM-DDThh:mm:ss
+  BOOST_TEST(date.size() == 19);
+  BOOST_TEST(date[4] == '-');
+  BOOST_TEST(date[10] == 'T');
+  BOOST_TEST(date[13] == ':');
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
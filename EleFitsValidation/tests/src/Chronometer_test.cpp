@@ -78,6 +78,68 @@ BOOST_AUTO_TEST_CASE(two_incs_test)
   BOOST_TEST(max() == slow);
 }
 
+BOOST_AUTO_TEST_CASE(percentiles_test)
+{
+  for (int i = 0; i < 5; ++i) {
+    start();
+    wait(default_wait * (i + 1));
+    stop();
+  }
+  BOOST_TEST(count() == 5);
+  BOOST_TEST(percentile(0) == min());
+  BOOST_TEST(percentile(100) == max());
+  const auto p50 = median();
+  const auto p90 = percentile(90);
+  const auto p99 = percentile(99);
+  const auto p999 = percentile(99.9);
+  BOOST_TEST(p50 >= min());
+  BOOST_TEST(p90 >= p50);
+  BOOST_TEST(p99 >= p90);
+  BOOST_TEST(p999 >= p99);
+  BOOST_TEST(p999 <= max());
+}
+
+BOOST_AUTO_TEST_CASE(merge_test)
+{
+  start();
+  wait();
+  stop();
+  Validation::Chronometer<std::chrono::milliseconds> other;
+  other.start();
+  wait();
+  other.stop();
+  const auto elapsed = this->elapsed() + other.elapsed();
+  merge(other);
+  BOOST_TEST(count() == 2);
+  BOOST_TEST(increments()[1] == other.increments()[0]);
+  BOOST_TEST(this->elapsed().count() == elapsed.count());
+}
+
+BOOST_AUTO_TEST_CASE(preallocation_test)
+{
+  BOOST_TEST(increments().capacity() >= default_capacity);
+  const auto* data = increments().data();
+  for (std::size_t i = 0; i < default_capacity; ++i) {
+    start();
+    stop();
+  }
+  BOOST_TEST(increments().data() == data); // No reallocation
+  reset();
+  BOOST_TEST(count() == 0);
+  BOOST_TEST(increments().capacity() >= default_capacity);
+}
+
+BOOST_AUTO_TEST_CASE(nanoseconds_test)
+{
+  Validation::Chronometer<std::chrono::nanoseconds> chrono;
+  chrono.start();
+  wait(1);
+  chrono.stop();
+  BOOST_TEST(chrono.last().count() >= 1000000);
+  BOOST_TEST(chrono.increments_as_milliseconds()[0] == chrono.milliseconds(chrono.last().count()));
+  BOOST_TEST(chrono.milliseconds(1500000) == 1.5);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
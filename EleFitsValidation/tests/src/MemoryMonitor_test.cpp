@@ -0,0 +1,76 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsValidation/MemoryMonitor.h"
+
+#include <boost/test/unit_test.hpp>
+#include <memory>
+
+using namespace Fits::Validation;
+
+ELEFITS_VALIDATION_COUNT_ALLOCATIONS()
+
+/**
+ * @brief Opaque sink which makes allocations escape, such that they cannot be elided.
+ */
+static void* volatile sink = nullptr;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MemoryMonitor_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(allocation_count_test)
+{
+  BOOST_TEST(MemoryMonitor::counts_allocations());
+  MemoryMonitor monitor;
+  monitor.start();
+  auto small = std::make_unique<int>(1);
+  auto large = std::make_unique<char[]>(1000);
+  *small = 2;
+  large[999] = 'x';
+  sink = small.get();
+  sink = large.get();
+  const auto& usage = monitor.stop();
+  BOOST_TEST(usage.allocation_count == 2);
+  BOOST_TEST(usage.allocated_bytes == sizeof(int) + 1000);
+  monitor.start();
+  const auto& empty = monitor.stop();
+  BOOST_TEST(empty.allocation_count == 0);
+  BOOST_TEST(empty.allocated_bytes == 0);
+}
+
+BOOST_AUTO_TEST_CASE(peak_rss_test)
+{
+  MemoryMonitor monitor;
+  monitor.start();
+  const auto before = MemoryMonitor::peak_rss();
+  const Linx::Index size = 64 * 1024 * 1024;
+  std::unique_ptr<char[]> buffer(new char[size]);
+  volatile char* data = buffer.get(); // Not optimized out
+  for (Linx::Index i = 0; i < size; i += 4096) {
+    data[i] = 1; // Touch pages to make them resident
+  }
+  const auto& usage = monitor.stop();
+  BOOST_TEST(before > 0);
+  BOOST_TEST(usage.peak_rss - before >= size * 9 / 10);
+}
+
+BOOST_AUTO_TEST_CASE(merge_test)
+{
+  MemoryUsage usage {100, 1, 10};
+  usage.merge({200, 2, 20});
+  BOOST_TEST(usage.peak_rss == 200);
+  BOOST_TEST(usage.allocation_count == 3);
+  BOOST_TEST(usage.allocated_bytes == 30);
+  usage.merge({});
+  BOOST_TEST(usage.peak_rss == 200);
+  BOOST_TEST(usage.allocation_count == -1);
+  BOOST_TEST(usage.allocated_bytes == -1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
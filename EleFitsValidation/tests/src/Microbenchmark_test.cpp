@@ -0,0 +1,82 @@
+// Copyright (C) 2019-2023, CNES and contributors (for the Euclid Science Ground Segment)
+// This file is part of EleFits <github.com/CNES/EleFits>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "EleFitsValidation/Microbenchmark.h"
+#include "ElementsKernel/Temporary.h"
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace Fits::Validation;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Microbenchmark_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(calibration_and_statistics_test)
+{
+  Microbenchmark suite(std::chrono::microseconds(100), 5);
+  Linx::Index calls = 0;
+  const auto result = suite.run(
+      "increment",
+      [&]() {
+        ++calls;
+        do_not_optimize(calls);
+      },
+      8);
+  BOOST_TEST(result.name == "increment");
+  BOOST_TEST(result.iterations > 1);
+  BOOST_TEST(result.repetitions == 5);
+  BOOST_TEST(result.samples.size() == 5);
+  BOOST_TEST(calls >= result.iterations * 5);
+  BOOST_TEST(result.min <= result.median);
+  BOOST_TEST(result.median <= result.max);
+  BOOST_TEST(result.min <= result.mean);
+  BOOST_TEST(result.mean <= result.max);
+  BOOST_TEST(result.stdev >= 0);
+}
+
+BOOST_AUTO_TEST_CASE(filter_test)
+{
+  Microbenchmark suite(std::chrono::microseconds(10), 2);
+  suite.add("Header::parse", []() {});
+  suite.add("Header::write_n", []() {});
+  suite.add("ImageRaster::read_region_to", []() {});
+  BOOST_TEST(suite.names().size() == 3);
+  BOOST_TEST(suite.run().size() == 3);
+  const auto header = suite.run("Header::");
+  BOOST_TEST(header.size() == 2);
+  BOOST_TEST(header[1].name == "Header::write_n");
+  BOOST_TEST(suite.run("Bintable").empty());
+}
+
+BOOST_AUTO_TEST_CASE(output_test)
+{
+  Microbenchmark suite(std::chrono::microseconds(10), 3);
+  suite.add("noop", []() {});
+  const auto results = suite.run();
+  Elements::TempPath csv("%%%%%%.csv");
+  Elements::TempPath json("%%%%%%.json");
+  Microbenchmark::write_csv(results, csv.path().string());
+  Microbenchmark::write_json(results, json.path().string());
+
+  std::ifstream csv_file(csv.path().string());
+  std::string line;
+  Linx::Index line_count = 0;
+  while (std::getline(csv_file, line)) {
+    ++line_count;
+  }
+  BOOST_TEST(line_count == 2); // Header + 1 row
+
+  std::ifstream json_file(json.path().string());
+  const std::string content((std::istreambuf_iterator<char>(json_file)), std::istreambuf_iterator<char>());
+  BOOST_TEST(content.find("\"name\": \"noop\"") != std::string::npos);
+  BOOST_TEST(content.find("\"samples\": [") != std::string::npos);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()